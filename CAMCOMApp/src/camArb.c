@@ -0,0 +1,262 @@
+/***************************************************************************\
+ *   $Id$
+ *   File:		camArb.c
+ *   Author:		Robert C. Sass
+ *   Email:		rcs@slac.stanford.edu
+ *   Phone:		408-464-5853
+ *   Company:		SLAC
+ *   Date:		10/2026
+ *   Version:		.01
+ *
+ *   Camac bus arbiter shared by the CAMCOM and crate verifier drivers.
+ *
+ *   threadCAMCOM and the CV_OP thread used to call camgo independently,
+ *   so a burst of CAMCOM packages could hold off the verifier watches and
+ *   a long verifier test could hold off operator CAMCOM requests. Both
+ *   drivers now call camArbGo, which:
+ *
+ *   - allows only one package in flight on the PSCD; a submitter finding
+ *     the card busy waits on its client event until it is granted,
+ *   - grants the bus by weighted fair queueing: each client has a
+ *     virtual finish time that advances by (time in camgo / weight),
+ *     and the waiting client with the smallest one goes next,
+ *   - overrides the fair order for a client whose oldest waiter has
+ *     been waiting longer than the client's latency budget,
+ *   - accounts bus occupancy, and wait and service time per client.
+ *
+ *   camgo addresses the one PSCD whatever the branch of the crate,
+ *   so the grants are serialized on a single lock for all branches.
+ *
+\***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <epicsThread.h>
+#include <epicsExport.h>
+#include <registryFunction.h>
+#include <cam_proto.h>
+#include <camArb.h>
+
+/*
+** Arbiter state of the PSCD, shared client configuration.
+*/
+static CAMARB_PSCD_TS    arb_s;
+static unsigned long     weight_a[CAMARB_NUM_CLIENTS] = {CAMARB_CAMCOM_WEIGHT,CAMARB_CV_WEIGHT};
+static double            budget_a[CAMARB_NUM_CLIENTS] = {CAMARB_CAMCOM_BUDGET,CAMARB_CV_BUDGET};
+static char const       *name_ac[CAMARB_NUM_CLIENTS]  = CAMARB_CLIENT_NAMES;
+static epicsThreadOnceId initOnce = EPICS_THREAD_ONCE_INIT;
+
+/*
+** One time init of the lock and events
+*/
+static void camArbInit (void *arg)
+{
+   int j;
+   /*-------------------------------*/
+   arb_s.lock  = epicsMutexMustCreate();
+   arb_s.owner = -1;
+   arb_s.grant = -1;
+   for (j=0; j<CAMARB_NUM_CLIENTS; j++)
+      arb_s.evt_a[j] = epicsEventMustCreate(epicsEventEmpty);
+   return;
+}
+
+/*
+** Pick the next client among the waiters. Called with the arbiter
+** locked and at least one waiter. A client past its latency budget
+** goes first (earliest deadline); otherwise the smallest virtual
+** finish time.
+*/
+static int camArbPick (CAMARB_PSCD_TS *a_p, epicsTimeStamp *now_p)
+{
+   int    i;
+   int    next = -1;
+   int    late = -1;
+   double over;
+   double lateOver = 0.0;
+   /*-------------------------------*/
+   for (i=0; i<CAMARB_NUM_CLIENTS; i++)
+   {
+      if (!a_p->nwait_a[i])
+         continue;
+      if (budget_a[i] > 0.0)
+      {
+         over = epicsTimeDiffInSeconds(now_p, &a_p->since_a[i]) - budget_a[i];
+         if ((over > 0.0) && ((late < 0) || (over > lateOver)))
+         {
+            late = i;
+            lateOver = over;
+         }
+      }
+      if ((next < 0) || (a_p->vtime_a[i] < a_p->vtime_a[next]))
+         next = i;
+   }
+   return ((late >= 0) ? late : next);
+}
+
+/*******************************************************************
+** Issue a camac package on the PSCD through the arbiter.
+** Blocks until the bus is granted to the caller, runs camgo and
+** hands the bus to the next waiter. If time_p is not NULL it gets
+** the start of camgo, the time waited for the grant and the time
+** in camgo. Returns the camgo status.
+********************************************************************/
+vmsstat_t camArbGo (E_CAMARB_CLIENT client, void **pkg_pp, CAMARB_TIME_TS *time_p)
+{
+   vmsstat_t iss;
+   CAMARB_PSCD_TS *a_p = &arb_s;
+   CAMARB_CLIENT_TS *c_p;
+   epicsTimeStamp queued, start, end;
+   double wait, svc;
+   int next;
+   /*-------------------------------*/
+   if ((unsigned)client >= CAMARB_NUM_CLIENTS)
+      return (camgo(pkg_pp));
+   epicsThreadOnce(&initOnce, camArbInit, NULL);
+   c_p = &a_p->client_as[client];
+
+   epicsTimeGetCurrent(&queued);
+   epicsMutexMustLock(a_p->lock);
+   if (!a_p->busy)
+   {  /* Bus idle, nobody waiting */
+      a_p->busy  = epicsTrue;
+      a_p->owner = client;
+      if (a_p->vtime_a[client] < a_p->vclock)
+         a_p->vtime_a[client] = a_p->vclock;
+   }
+   else
+   {  /* Wait for a grant. An idle client starts at the current virtual time */
+      if (!a_p->nwait_a[client]++)
+      {
+         a_p->since_a[client] = queued;
+         if (a_p->vtime_a[client] < a_p->vclock)
+            a_p->vtime_a[client] = a_p->vclock;
+      }
+      while (a_p->grant != client)
+      {
+         epicsMutexUnlock(a_p->lock);
+         epicsEventMustWait(a_p->evt_a[client]);
+         epicsMutexMustLock(a_p->lock);
+      }
+      a_p->grant = -1;
+      a_p->owner = client;
+      if (--a_p->nwait_a[client])
+         epicsTimeGetCurrent(&a_p->since_a[client]);
+   }
+   epicsMutexUnlock(a_p->lock);
+
+   /*
+   ** Only the owner gets here; the bus stays busy until handed over.
+   */
+   epicsTimeGetCurrent(&start);
+   iss = camgo(pkg_pp);
+   epicsTimeGetCurrent(&end);
+
+   wait = epicsTimeDiffInSeconds(&start, &queued);
+   svc  = epicsTimeDiffInSeconds(&end, &start);
+   if (time_p)
+   {
+      time_p->start = start;
+      time_p->wait  = wait;
+      time_p->svc   = svc;
+   }
+   epicsMutexMustLock(a_p->lock);
+   if (!a_p->start.secPastEpoch)
+      a_p->start = queued;
+   a_p->busy_tot += svc;
+   c_p->npkg++;
+   c_p->busy += svc;
+   c_p->wait += wait;
+   if (wait > c_p->maxWait)
+      c_p->maxWait = wait;
+   if ((budget_a[client] > 0.0) && (wait > budget_a[client]))
+      c_p->nover++;
+   if (!SUCCESS(iss))
+      c_p->nerr++;
+   a_p->vtime_a[client] += svc / weight_a[client];
+   a_p->vclock = a_p->vtime_a[client];
+
+   /*
+   ** Hand the bus to the next waiter, if any.
+   */
+   a_p->owner = -1;
+   for (next=0; next<CAMARB_NUM_CLIENTS; next++)
+      if (a_p->nwait_a[next]) break;
+   if (next < CAMARB_NUM_CLIENTS)
+   {
+      next = camArbPick(a_p, &end);
+      a_p->grant = next;
+      epicsEventSignal(a_p->evt_a[next]);
+   }
+   else
+      a_p->busy = epicsFalse;
+   epicsMutexUnlock(a_p->lock);
+   return (iss);
+}
+
+/*
+** iocsh: set the weight and latency budget (msec, 0 = none) of a client.
+** A weight below 1 or a negative budget leaves that setting unchanged.
+*/
+void camArbSet (char const *client_c, int weight, int budget_ms)
+{
+   int i;
+   /*-------------------------------*/
+   for (i=0; i<CAMARB_NUM_CLIENTS; i++)
+   {
+      if (client_c && !strcmp(client_c, name_ac[i]))
+         break;
+   }
+   if (i >= CAMARB_NUM_CLIENTS)
+   {
+      printf ("camArbSet: client must be CAMCOM or CV\n");
+      return;
+   }
+   if (weight > 0)
+      weight_a[i] = weight;
+   if (budget_ms >= 0)
+      budget_a[i] = budget_ms / 1000.0;
+   printf ("camArb %s: weight %lu, budget %.3f sec\n", name_ac[i], weight_a[i], budget_a[i]);
+   return;
+}
+
+/*
+** iocsh: display the arbiter configuration, bus occupancy
+** and per client packages, errors and wait times.
+*/
+void camArbShow (int level)
+{
+   CAMARB_PSCD_TS *a_p = &arb_s;
+   CAMARB_CLIENT_TS *c_p;
+   epicsTimeStamp now;
+   double elapsed;
+   int j;
+   /*-------------------------------*/
+   printf ("Camac bus arbiter\n");
+   for (j=0; j<CAMARB_NUM_CLIENTS; j++)
+      printf ("\t%-6s weight %lu, budget %.3f sec\n", name_ac[j], weight_a[j], budget_a[j]);
+   if (!a_p->lock || !a_p->start.secPastEpoch)
+      return;
+   epicsTimeGetCurrent(&now);
+   epicsMutexMustLock(a_p->lock);
+   elapsed = epicsTimeDiffInSeconds(&now, &a_p->start);
+   printf ("  PSCD: %s, occupancy %.1f%% (%.1f of %.0f sec)\n",
+           (a_p->busy) ? "busy" : "idle",
+           (elapsed > 0.0) ? 100.0 * a_p->busy_tot / elapsed : 0.0,
+           a_p->busy_tot, elapsed);
+   for (j=0; j<CAMARB_NUM_CLIENTS; j++)
+   {
+      c_p = &a_p->client_as[j];
+      if (!c_p->npkg && !level)
+         continue;
+      printf ("\t%-6s pkgs %lu, errs %lu, busy %.3f sec, wait avg %.1f max %.1f msec, over budget %lu, waiting %lu\n",
+              name_ac[j], c_p->npkg, c_p->nerr, c_p->busy,
+              (c_p->npkg) ? 1000.0 * c_p->wait / c_p->npkg : 0.0,
+              1000.0 * c_p->maxWait, c_p->nover, a_p->nwait_a[j]);
+   }
+   epicsMutexUnlock(a_p->lock);
+   return;
+}
+
+epicsRegisterFunction(camArbSet);
+epicsRegisterFunction(camArbShow);
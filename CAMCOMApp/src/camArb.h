@@ -0,0 +1,90 @@
+/*
+** camArb.h
+**
+** Camac bus arbiter shared by the CAMCOM and crate verifier drivers.
+** Every camgo() from either driver goes through camArbGo(), which
+** allows only one package in flight on the PSCD and picks the next
+** client by weighted fair queueing, with a latency budget per client.
+*/
+#ifndef _CAM_ARB_H_
+#define _CAM_ARB_H_
+
+#include <epicsTime.h>
+#include <epicsMutex.h>
+#include <epicsEvent.h>
+#include <slc_macros.h>
+
+/*
+** Clients of the arbiter.
+*/
+typedef enum CAMARB_CLIENT
+{
+    CAMARB_CLIENT_CAMCOM,
+    CAMARB_CLIENT_CV,
+    CAMARB_NUM_CLIENTS
+}   E_CAMARB_CLIENT;
+
+#define CAMARB_CLIENT_NAMES     {"CAMCOM","CV"}
+
+/*
+** Default weights and latency budgets. The operator CAMCOM
+** requests get twice the bus share of the crate verifier and
+** a tighter budget.
+*/
+#define CAMARB_CAMCOM_WEIGHT    (2)
+#define CAMARB_CAMCOM_BUDGET    (0.2)     /* sec */
+#define CAMARB_CV_WEIGHT        (1)
+#define CAMARB_CV_BUDGET        (2.0)     /* sec */
+
+/*
+** Per client accounting
+*/
+typedef struct
+{
+  unsigned long   npkg;       /* Packages issued                         */
+  unsigned long   nerr;       /* Packages with bad camgo status          */
+  unsigned long   nover;      /* Packages that waited past the budget    */
+  double          busy;       /* Total time in camgo, sec                */
+  double          wait;       /* Total time waiting for the bus, sec     */
+  double          maxWait;    /* Longest wait for the bus, sec           */
+} CAMARB_CLIENT_TS;
+
+/*
+** Arbitration state of the PSCD. All camac branches go through
+** the one card, so there is a single state. All fields are under lock.
+*/
+typedef struct
+{
+  epicsMutexId    lock;
+  epicsBoolean    busy;                           /* A package is in flight or granted  */
+  int             owner;                          /* Client holding the bus, -1 = none  */
+  int             grant;                          /* Client granted, not yet running    */
+  unsigned long   nwait_a [CAMARB_NUM_CLIENTS];   /* Waiting submitters per client      */
+  epicsTimeStamp  since_a [CAMARB_NUM_CLIENTS];   /* Oldest waiter per client           */
+  epicsEventId    evt_a   [CAMARB_NUM_CLIENTS];   /* Wakes a waiter of the client       */
+  double          vtime_a [CAMARB_NUM_CLIENTS];   /* WFQ virtual finish time per client */
+  double          vclock;                         /* Virtual time of the last service   */
+  double          busy_tot;                       /* Total time in camgo, sec           */
+  epicsTimeStamp  start;                          /* First package through the arbiter  */
+  CAMARB_CLIENT_TS client_as[CAMARB_NUM_CLIENTS];
+} CAMARB_PSCD_TS;
+
+/*
+** Timing of one package, optionally returned by camArbGo.
+*/
+typedef struct
+{
+  epicsTimeStamp  start;      /* camgo called, after the grant           */
+  double          wait;       /* Time waiting for the bus, sec           */
+  double          svc;        /* Time in camgo, sec                      */
+} CAMARB_TIME_TS;
+
+/*****************************************************************
+** Prototypes
+*****************************************************************/
+
+vmsstat_t camArbGo (E_CAMARB_CLIENT client, void **pkg_pp, CAMARB_TIME_TS *time_p);
+void      camArbSet  (char const *client_c, int weight, int budget_ms);
+void      camArbShow (int level);
+
+#endif
@@ -15,15 +15,6 @@
 #include <slc_macros.h>
 #include <devCAMCOM.h>    /* All other includes & CAMCOM definitions */
 
-/******************************************************************************************/
-/*********************      Externs defined in drvCAMCOM        ***************************/
-/******************************************************************************************/
-
-/*
-** MessageQueue for camcom thread.
-*/
-extern epicsMessageQueueId camcom_msgQId;
-
 /******************************************************************************************/
 /***********************  local routine prototypes         ********************************/
 /******************************************************************************************/
@@ -36,6 +27,20 @@ static long Wf_init (int);
 static long Wf_init_record (struct waveformRecord *wfr_p);
 static long Wf_read_write (struct waveformRecord *wfr_p);
 
+/*
+** Ai record support for CAMCOM statistics
+*/
+
+static long Ai_init_record (struct aiRecord *air_p);
+static long Ai_read (struct aiRecord *air_p);
+
+/*
+** Waveform record support for the CAMCOM error counts
+*/
+
+static long Wf_err_init_record (struct waveformRecord *wfr_p);
+static long Wf_err_read (struct waveformRecord *wfr_p);
+
 
 /******************************************************************************************/
 /*********************              implementation              ***************************/
@@ -61,6 +66,29 @@ DEV_SUP devWfCAMCOM = {6, NULL, Wf_init, Wf_init_record, NULL, Wf_read_write, NU
 
 epicsExportAddress(dset, devWfCAMCOM);
 
+/*
+** Ai CAMCOM statistics device support functions
+*/
+DEV_SUP devAiCAMCOM = {6, NULL, NULL, Ai_init_record, NULL, Ai_read, NULL};
+
+epicsExportAddress(dset, devAiCAMCOM);
+
+/*
+** Waveform CAMCOM error count device support functions
+*/
+DEV_SUP devWfCAMCOMErrs = {6, NULL, NULL, Wf_err_init_record, NULL, Wf_err_read, NULL};
+
+epicsExportAddress(dset, devWfCAMCOMErrs);
+
+/*
+** Ai private: which statistic, and of which CAMCOM record (none = all)
+*/
+typedef struct
+{
+  E_CAMCOM_STAT  stat;
+  dbCommon      *src_p;     /* CAMCOM waveform record or NULL */
+} CAMCOM_STAT_PVT;
+
 /*********************************************************
  *********** Waveform Record Support *********************
  ********************************************************/
@@ -83,7 +111,8 @@ static long Wf_init_record (struct waveformRecord *wfr_p)
    printf ("Entered CAMCOM waveform record init for %s\n",wfr_p->name);
    CAMCOMDriverInit((dbCommon *)wfr_p, EPICS_RECTYPE_WF);
    pvt_p = (CAMCOM_PVT *)(wfr_p->dpvt);
-   pvt_p->val_p = wfr_p->bptr; /* Buffer pointer for waveform */
+   /* Buffer pointer and size for waveform */
+   CAMCOMDescInit (pvt_p, wfr_p->bptr, wfr_p->nelm * dbValueSize(wfr_p->ftvl));
    return (0);
 }
 
@@ -92,19 +121,17 @@ static long Wf_init_record (struct waveformRecord *wfr_p)
 */
 static long Wf_read_write (struct waveformRecord *wfr_p)
 {
-   THREADMSG_TS msg_s;
    CAMCOM_PVT *pvt_p = (CAMCOM_PVT *)(wfr_p->dpvt);
    int rtn = -1;        /* Assume bad */
    /*---------------------*/
    if (!pvt_p) return (rtn);   /* Bad. Should have a driver private area */
    /*
-   ** If pre-process send msg to CAMCOM thread to execute the Camac operation.
+   ** If pre-process queue the package to CAMCOM thread to execute the Camac operation.
    */
    if(!wfr_p->pact)
    {  /* Pre-process */
-      msg_s.rec_p = (dbCommon *)wfr_p;
-      if (epicsMessageQueueTrySend (camcom_msgQId, &msg_s, sizeof(msg_s)) == -1)
-      {
+      if (CAMCOMQueue (pvt_p))
+      {  /* Bad package or queue full, never queued */
          recGblSetSevr(wfr_p, WRITE_ALARM, INVALID_ALARM);
          errlogPrintf("CAMCOM Wf_read_write Thread Error [%s]", wfr_p->name);
       }
@@ -126,3 +153,112 @@ static long Wf_read_write (struct waveformRecord *wfr_p)
    }   /* post-process */
    return (rtn);
 }
+
+/*********************************************************
+ *********** Ai Statistics Record Support ****************
+ ********************************************************/
+
+/*
+** Record init for Ai. INP is "@<stat> [<CAMCOM record>]" where stat
+** is NPKG, NPKT, NBYTE, NERR, LASTERR, P50, P90, P99, MAX, WAIT or
+** WMAX (msec).
+** Without a record name the statistic is for all of CAMCOM.
+*/
+static long Ai_init_record (struct aiRecord *air_p)
+{
+   static char const *name_ac[CAMCOM_NUM_STAT] = CAMCOM_STAT_NAMES;
+   CAMCOM_STAT_PVT *spvt_p;
+   DBADDR addr;
+   char stat_c[MAX_FUNC_STRING_LEN];
+   char rec_c[PVNAME_STRINGSZ];
+   int i, n;
+   /*------------------------------------------------*/
+   rec_c[0] = '\0';
+   if ((air_p->inp.type != INST_IO) ||
+       ((n = sscanf(air_p->inp.value.instio.string, "%39s %60s", stat_c, rec_c)) < 1))
+   {
+      recGblRecordError(S_db_badField, (void *)air_p, "devAiCAMCOM (init_record) Illegal INP field");
+      return (S_db_badField);
+   }
+   for (i=0; (i<CAMCOM_NUM_STAT) && strcmp(stat_c, name_ac[i]); i++);
+   if (i >= CAMCOM_NUM_STAT)
+   {
+      recGblRecordError(S_db_badField, (void *)air_p, "devAiCAMCOM (init_record) Unknown statistic");
+      return (S_db_badField);
+   }
+   spvt_p = callocMustSucceed (1, sizeof(CAMCOM_STAT_PVT), "calloc CAMCOM stat pvt");
+   spvt_p->stat = (E_CAMCOM_STAT) i;
+   if (n > 1)
+   {
+      if (dbNameToAddr(rec_c, &addr) ||
+          (((dbCommon *)addr.precord)->dset != (struct dset *)&devWfCAMCOM))
+      {
+         free (spvt_p);
+         recGblRecordError(S_db_badField, (void *)air_p, "devAiCAMCOM (init_record) Not a CAMCOM record");
+         return (S_db_badField);
+      }
+      spvt_p->src_p = (dbCommon *)addr.precord;
+   }
+   air_p->dpvt = spvt_p;
+   return (0);
+}
+
+/*
+** Read routine for Ai. The CAMCOM record's private area may be set up
+** after this record's init, so it is looked up on each read.
+*/
+static long Ai_read (struct aiRecord *air_p)
+{
+   CAMCOM_STAT_PVT *spvt_p = (CAMCOM_STAT_PVT *)(air_p->dpvt);
+   CAMCOM_PVT *pvt_p = NULL;
+   /*---------------------*/
+   if (!spvt_p) return (-1);
+   if (spvt_p->src_p)
+   {
+      if (!(pvt_p = (CAMCOM_PVT *)spvt_p->src_p->dpvt))
+      {
+         recGblSetSevr(air_p, READ_ALARM, INVALID_ALARM);
+         return (-1);
+      }
+   }
+   air_p->val = CAMCOMStatGet (pvt_p, spvt_p->stat);
+   air_p->udf = FALSE;
+   return (NO_CONVERT);
+}
+
+/*********************************************************
+ *********** Waveform Error Count Record Support *********
+ ********************************************************/
+
+/*
+** Record init for the error waveforms. INP is "@CODE" for the
+** distinct vmsstat codes returned or "@COUNT" for how many times
+** each was returned; element j of one goes with element j of the
+** other. FTVL must be ULONG.
+*/
+static long Wf_err_init_record (struct waveformRecord *wfr_p)
+{
+   char stat_c[MAX_FUNC_STRING_LEN];
+   /*------------------------------------------------*/
+   if ((wfr_p->inp.type != INST_IO) || (wfr_p->ftvl != DBF_ULONG) ||
+       (sscanf(wfr_p->inp.value.instio.string, "%39s", stat_c) != 1) ||
+       (strcmp(stat_c, "CODE") && strcmp(stat_c, "COUNT")))
+   {
+      recGblRecordError(S_db_badField, (void *)wfr_p, "devWfCAMCOMErrs (init_record) Illegal INP or FTVL field");
+      return (S_db_badField);
+   }
+   /* Only need to know which one; non-NULL dpvt means the counts */
+   wfr_p->dpvt = (strcmp(stat_c, "COUNT")) ? NULL : (void *)wfr_p;
+   return (0);
+}
+
+/*
+** Read routine for the error waveforms
+*/
+static long Wf_err_read (struct waveformRecord *wfr_p)
+{
+   /*---------------------*/
+   wfr_p->nord = CAMCOMErrGet ((wfr_p->dpvt != NULL), (epicsUInt32 *)wfr_p->bptr, wfr_p->nelm);
+   wfr_p->udf = FALSE;
+   return (0);
+}
@@ -13,6 +13,7 @@
 #include "stdlib.h"
 #include "string.h"
 #include "errno.h"
+#include "stddef.h"
 
 /*
 ** Get all of the EPICS includes we might need.
@@ -31,12 +32,14 @@
 #include <devLib.h>
 #include <errlog.h>
 #include <special.h>
+#include <epicsTypes.h>
 #include <epicsTime.h>
 #include <epicsThread.h>
 #include <epicsMutex.h>
 #include <epicsMessageQueue.h>
-#include <epicsThread.h>
+#include <epicsEvent.h>
 #include <cantProceed.h>
+#include <ellLib.h>
 
 /*
 ** We'll preserve/use VMS status words to pass back so we need the SUCCESS macro
@@ -52,10 +55,21 @@
 #include <camblkstruc.h>
 #include <camdef.h>
 
+/*
+** Camac bus arbiter shared with the crate verifier
+*/
+#include <camArb.h>
+
+/*
+** C interface to the CAMCOM thread
+*/
+#include <drvCAMCOM.h>
+
 /*
 ** Recordtypes we support
 */
 #include <waveformRecord.h>
+#include <aiRecord.h>
 
 /******************************************************************************************/
 /*********************       EPICS device support return        ***************************/
@@ -76,24 +90,131 @@ typedef enum EPICS_RECTYPE
 
 
 
+/*
+** Byte count of the camac status longword ahead of each packet's data
+*/
+#define CAMCOM_STAT_BYTES	(4)
+
 /********************************************
- ** Driver private structure for each record.
+ ** Pre-parsed package. Built from the waveform by CAMCOMParse
+ ** each time the record is processed; the thread only executes it.
  *******************************************/
 typedef struct
 {
-  vmsstat_t     status;   /* Status returned from driver */
-  void         *val_p;     /* Local record's val field */
+  unsigned long   cctlw;    /* Camac control word */
+  unsigned long   offset;   /* Byte offset of stat/data in the waveform */
+  unsigned short  nbytes;   /* #data bytes (wc_max << 1) */
+} CAMCOM_OP_TS;
+
+typedef struct
+{
+  unsigned short  iops;     /* #ops in package, 0 if not valid */
+  unsigned short  maxops;   /* #ops that fit in the waveform (NELM) */
+  unsigned long   size;     /* #bytes spanned by packets and stat/data */
+  unsigned long   ndata;    /* #data bytes of all packets */
+  CAMCOM_OP_TS   *op_as;    /* maxops entries */
+} CAMCOM_DESC_TS;
+
+/********************************************
+ ** Execution statistics, kept per record or C request
+ ** and for all of CAMCOM. Execution time is the time in
+ ** camgo once the camac bus arbiter has granted the bus.
+ ** It is binned in a log2 histogram of microseconds (bin 0
+ ** < 1 us, bin i < 2^i us) from which the percentiles are
+ ** estimated. The wait, from the start of the build to the
+ ** grant, is kept apart as a mean and maximum.
+ *******************************************/
+#define CAMCOM_NUM_HIST		(24)    /* Last bin holds >= 2^22 us (~4 sec) */
+#define CAMCOM_NUM_ERRS		(16)    /* Distinct error codes counted */
+
+typedef struct
+{
+  unsigned long   npkg;     /* Packages executed */
+  unsigned long   npkt;     /* Packets executed */
+  unsigned long   nbytes;   /* Data bytes transferred */
+  unsigned long   nerr;     /* Packages with bad status */
+  vmsstat_t       lasterr;  /* Last bad status */
+  double          tmax;     /* Longest execution, sec */
+  double          wait;     /* Total wait for the bus, sec */
+  double          wmax;     /* Longest wait for the bus, sec */
+  unsigned long   hist_a[CAMCOM_NUM_HIST];
+} CAMCOM_STATS_TS;
+
+typedef struct
+{
+  vmsstat_t       iss;      /* Error code */
+  unsigned long   count;    /* Times returned */
+} CAMCOM_ERRCNT_TS;
+
+/*
+** Statistics that can be read by the CAMCOM Stats ai records.
+*/
+typedef enum CAMCOM_STAT
+{
+    CAMCOM_STAT_NPKG,
+    CAMCOM_STAT_NPKT,
+    CAMCOM_STAT_NBYTE,
+    CAMCOM_STAT_NERR,
+    CAMCOM_STAT_LASTERR,
+    CAMCOM_STAT_P50,
+    CAMCOM_STAT_P90,
+    CAMCOM_STAT_P99,
+    CAMCOM_STAT_MAX,
+    CAMCOM_STAT_WAIT,
+    CAMCOM_STAT_WMAX,
+    CAMCOM_NUM_STAT
+}   E_CAMCOM_STAT;
+
+#define CAMCOM_STAT_NAMES {"NPKG","NPKT","NBYTE","NERR","LASTERR","P50","P90","P99","MAX","WAIT","WMAX"}
+
+/********************************************
+ ** Driver private structure for each record,
+ ** and for each request of the C interface.
+ *******************************************/
+typedef struct camcom_pvt_s
+{
+  ELLNODE           node;      /* In the list of all requests, for reports */
+  vmsstat_t         status;    /* Status returned from driver */
+  void             *val_p;     /* Local record's val field */
+  unsigned long     nbytes;    /* Size of val field in bytes (NELM) */
+  CAMCOM_DESC_TS    desc;      /* Package parsed from val field */
+  char const       *name_c;    /* Record or request name, for messages */
+  dbCommon         *rec_p;     /* Record to process on completion, NULL if none */
+  CAMCOM_DONE_FUNC  done_f;    /* C interface completion callback */
+  void             *done_arg;  /* Argument of done_f */
+  epicsEventId      done_evt;  /* Signalled on completion if not NULL */
+  volatile int      busy;      /* Queued or executing */
+  CAMCOM_STATS_TS   stats;     /* Execution statistics */
 } CAMCOM_PVT;
 
 /*
 ** This is the message send to the thread. All that's needed is 
-** the record ptr. Other info is in driver private struct.
+** the driver private struct, which holds the package and how to
+** report completion.
 */
 typedef struct
 {
-  dbCommon     *rec_p;
+  CAMCOM_PVT   *pvt_p;
 } THREADMSG_TS;
 
+/*
+** Message passed between the CAMCOM pipeline stages: the
+** package built by threadCAMCOM, executed by the exec thread
+** and completed by the done thread.
+*/
+#define CAMCOM_PIPE_DEPTH	(2)	/* Packages built ahead of the one executing */
+#define CAMCOM_DONE_DEPTH	(10)	/* Packages waiting for completion */
+
+typedef struct
+{
+  CAMCOM_PVT     *pvt_p;
+  void           *pkg_p;    /* Camac package, NULL if camalo failed */
+  vmsstat_t       iss;      /* Build, then camgo status */
+  epicsTimeStamp  start;    /* Start of build */
+  double          wait;     /* Start of build to camgo, sec */
+  double          exec;     /* Time in camgo, sec */
+} PIPEMSG_TS;
+
 /*****************************************************************
 ** Prototypes for driver modules referenced by devCAMCOM device support
 *****************************************************************/
@@ -106,4 +227,24 @@ void threadCAMCOM  (void * msgQId);
 
 void CAMCOMDriverInit (dbCommon *rec_p, enum EPICS_RECTYPE rtyp);
 
+/* Size the package descriptor for the record's buffer */
+
+void CAMCOMDescInit (CAMCOM_PVT *pvt_p, void *val_p, unsigned long nbytes);
+
+/* Validate the package in the record's buffer and build its descriptor */
+
+int CAMCOMParse (CAMCOM_PVT *pvt_p);
+
+/* Parse the package and queue it to the thread */
+
+int CAMCOMQueue (CAMCOM_PVT *pvt_p);
+
+/* Read a statistic of a record, or of all of CAMCOM if pvt_p is NULL */
+
+double CAMCOMStatGet (CAMCOM_PVT *pvt_p, E_CAMCOM_STAT stat);
+
+/* Copy the error codes or their counts for the CAMCOM Errors waveforms */
+
+unsigned long CAMCOMErrGet (int count_f, epicsUInt32 *val_a, unsigned long nelm);
+
 #endif
@@ -8,7 +8,10 @@
  *   Date:		04/2010
  *   Version:		.01
  *
- *   EPICS driver CAMCOM; thread that does all of the Camac work 
+ *   EPICS driver CAMCOM; threads that do all of the Camac work 
+ *   for the CAMCOM records and the C interface (drvCAMCOM.h):
+ *   CAMCOM builds packages, CAMCOM_EXEC runs them and 
+ *   CAMCOM_DONE posts the completions.
  *
 \***************************************************************************/
 
@@ -19,6 +22,34 @@
 ***************************************/
 epicsMessageQueueId camcom_msgQId;
 
+/**************************************
+** Queues between the pipeline stages:
+** threadCAMCOM (build) -> exec -> done
+***************************************/
+static epicsMessageQueueId camcom_execQId;
+static epicsMessageQueueId camcom_doneQId;
+static void threadCAMCOMExec (void *msgQId);
+static void threadCAMCOMDone (void *msgQId);
+
+/**************************************
+** Statistics for all of CAMCOM, and the list of
+** records and C requests for reports. The statistics
+** are only written by the CAMCOM_DONE thread.
+***************************************/
+static CAMCOM_STATS_TS   camcom_stats_s;
+static CAMCOM_ERRCNT_TS  camcom_errs_as[CAMCOM_NUM_ERRS];
+static unsigned long     camcom_errs_other;     /* Errors not in camcom_errs_as */
+static ELLLIST           camcom_list_s;
+static epicsMutexId      camcom_list_lock;
+static epicsThreadOnceId camcom_list_once = EPICS_THREAD_ONCE_INIT;
+
+/**************************************
+** Lock for the busy flag of the records and C
+** requests, so that only one caller can claim a
+** request. Created with the list lock.
+***************************************/
+static epicsMutexId      camcom_busy_lock;
+
 /********************************************************************************************/
 /* Here we supply the driver initialization & report functions for epics                    */
 /********************************************************************************************/
@@ -41,12 +72,22 @@ static long CAMCOM_EPICS_Init()
    /*
    ** Create the CAMCOM msgQ
    */
-   if ((camcom_msgQId = epicsMessageQueueCreate (10,sizeof(THREADMSG_TS))) == NULL)
+   if (((camcom_msgQId  = epicsMessageQueueCreate (10,sizeof(THREADMSG_TS))) == NULL) ||
+       ((camcom_execQId = epicsMessageQueueCreate (CAMCOM_PIPE_DEPTH,sizeof(PIPEMSG_TS))) == NULL) ||
+       ((camcom_doneQId = epicsMessageQueueCreate (CAMCOM_DONE_DEPTH,sizeof(PIPEMSG_TS))) == NULL))
    {
       errlogSevPrintf(errlogFatal,
          "Failed to create CAMCOM message queue. Bummer.\n");
       goto egress;
    }
+   /*
+   ** Pipeline: build the next package while the current one
+   ** executes, and post completions off the execute path.
+   */
+   epicsThreadMustCreate("CAMCOM_DONE", epicsThreadPriorityMedium, 20480,
+                          threadCAMCOMDone, (void *)camcom_doneQId);
+   epicsThreadMustCreate("CAMCOM_EXEC", epicsThreadPriorityMedium+1, 20480,
+                          threadCAMCOMExec, (void *)camcom_execQId);
    epicsThreadMustCreate("CAMCOM", epicsThreadPriorityMedium, 20480,
                           threadCAMCOM, (void *)camcom_msgQId);
 egress:
@@ -54,12 +95,168 @@ egress:
 }
 
 
+/*****************************************************
+ ** Report, from dbior("drvCAMCOM",level):
+ **   0 - version and totals
+ **   1 - add execution time percentiles, wait and errors by code
+ **   2 - add the totals of each record and C request
+ ****************************************************/
+static void CAMCOMStatsShow (char const *name_c, CAMCOM_STATS_TS *st_p, CAMCOM_PVT *pvt_p, int level)
+{
+   /*---------------------------------------------------*/ 
+   printf ("  %-32s pkgs %lu, pkts %lu, bytes %lu, errs %lu",
+           name_c, st_p->npkg, st_p->npkt, st_p->nbytes, st_p->nerr);
+   if (st_p->nerr)
+      printf (" (last 0x%08x)", (unsigned int)st_p->lasterr);
+   printf ("\n");
+   if (level > 0)
+   {
+      printf ("  %-32s exec msec p50 %.3f, p90 %.3f, p99 %.3f, max %.3f\n", "",
+              CAMCOMStatGet(pvt_p, CAMCOM_STAT_P50), CAMCOMStatGet(pvt_p, CAMCOM_STAT_P90),
+              CAMCOMStatGet(pvt_p, CAMCOM_STAT_P99), CAMCOMStatGet(pvt_p, CAMCOM_STAT_MAX));
+      printf ("  %-32s wait msec avg %.3f, max %.3f\n", "",
+              CAMCOMStatGet(pvt_p, CAMCOM_STAT_WAIT), CAMCOMStatGet(pvt_p, CAMCOM_STAT_WMAX));
+   }
+   return;
+}
+
 static long CAMCOM_EPICS_Report(int level)
 {
+   CAMCOM_PVT *pvt_p;
+   int j;
+   /*---------------------------------------------------*/ 
    printf ("\nCAMAC CAMCOM Driver V1.0\n");
+   CAMCOMStatsShow ("All CAMCOM", &camcom_stats_s, NULL, level);
+   if (level > 0)
+   {
+      for (j=0; (j<CAMCOM_NUM_ERRS) && camcom_errs_as[j].count; j++)
+         printf ("\terror 0x%08x: %lu\n", (unsigned int)camcom_errs_as[j].iss, camcom_errs_as[j].count);
+      if (camcom_errs_other)
+         printf ("\tother errors: %lu\n", camcom_errs_other);
+   }
+   if ((level > 1) && camcom_list_lock)
+   {
+      epicsMutexMustLock (camcom_list_lock);
+      for (pvt_p = (CAMCOM_PVT *)ellFirst(&camcom_list_s); pvt_p;
+           pvt_p = (CAMCOM_PVT *)ellNext(&pvt_p->node))
+         CAMCOMStatsShow (pvt_p->name_c, &pvt_p->stats, pvt_p, level);
+      epicsMutexUnlock (camcom_list_lock);
+   }
    return 0;
 }
 
+/*****************************************************
+ ** Keep a list of the records and C requests
+ ****************************************************/
+static void CAMCOMListInit (void *arg_p)
+{
+   ellInit (&camcom_list_s);
+   camcom_list_lock = epicsMutexMustCreate();
+   camcom_busy_lock = epicsMutexMustCreate();
+   return;
+}
+
+static void CAMCOMListAdd (CAMCOM_PVT *pvt_p)
+{
+   epicsThreadOnce (&camcom_list_once, CAMCOMListInit, NULL);
+   epicsMutexMustLock (camcom_list_lock);
+   ellAdd (&camcom_list_s, &pvt_p->node);
+   epicsMutexUnlock (camcom_list_lock);
+   return;
+}
+
+/*****************************************************
+ ** Account one executed package in a set of statistics
+ ****************************************************/
+static void CAMCOMStatsAdd (CAMCOM_STATS_TS *st_p, CAMCOM_DESC_TS *desc_p, vmsstat_t iss,
+                            double sec, double wait)
+{
+   double usec = sec * 1.0e6;
+   int i = 0;
+   /*---------------------------------------------------*/ 
+   st_p->npkg++;
+   st_p->npkt   += desc_p->iops;
+   st_p->nbytes += desc_p->ndata;
+   if (!SUCCESS(iss))
+   {
+      st_p->nerr++;
+      st_p->lasterr = iss;
+   }
+   if (sec > st_p->tmax)
+      st_p->tmax = sec;
+   st_p->wait += wait;
+   if (wait > st_p->wmax)
+      st_p->wmax = wait;
+   while ((usec >= 1.0) && (i < CAMCOM_NUM_HIST-1))
+   {
+      usec /= 2.0;
+      i++;
+   }
+   st_p->hist_a[i]++;
+   return;
+}
+
+/*****************************************************
+ ** Read a statistic of a record or C request, or of
+ ** all of CAMCOM if pvt_p is NULL. Times are in msec;
+ ** a percentile is the upper edge of its histogram bin.
+ ****************************************************/
+double CAMCOMStatGet (CAMCOM_PVT *pvt_p, E_CAMCOM_STAT stat)
+{
+   CAMCOM_STATS_TS *st_p = (pvt_p) ? &pvt_p->stats : &camcom_stats_s;
+   unsigned long hist_a[CAMCOM_NUM_HIST];
+   unsigned long n = 0;
+   unsigned long sum = 0;
+   double pct = 0.0;
+   int i;
+   /*---------------------------------------------------*/ 
+   switch (stat)
+   {
+      case CAMCOM_STAT_NPKG:    return ((double) st_p->npkg);
+      case CAMCOM_STAT_NPKT:    return ((double) st_p->npkt);
+      case CAMCOM_STAT_NBYTE:   return ((double) st_p->nbytes);
+      case CAMCOM_STAT_NERR:    return ((double) st_p->nerr);
+      case CAMCOM_STAT_LASTERR: return ((double) st_p->lasterr);
+      case CAMCOM_STAT_MAX:     return (st_p->tmax * 1000.0);
+      case CAMCOM_STAT_WAIT:    return ((st_p->npkg) ? st_p->wait * 1000.0 / st_p->npkg : 0.0);
+      case CAMCOM_STAT_WMAX:    return (st_p->wmax * 1000.0);
+      case CAMCOM_STAT_P50:     pct = 0.50; break;
+      case CAMCOM_STAT_P90:     pct = 0.90; break;
+      case CAMCOM_STAT_P99:     pct = 0.99; break;
+      default:                  return (0.0);
+   }
+   /* Work on a copy; the thread may be updating the histogram */
+   memcpy (hist_a, st_p->hist_a, sizeof(hist_a));
+   for (i=0; i<CAMCOM_NUM_HIST; i++)
+      n += hist_a[i];
+   if (!n)
+      return (0.0);
+   for (i=0; i<CAMCOM_NUM_HIST-1; i++)
+   {
+      sum += hist_a[i];
+      if (sum >= pct * n)
+         break;
+   }
+   return ((double)(1UL << i) / 1000.0);
+}
+
+/*****************************************************
+ ** Copy the distinct error codes (count_f false) or
+ ** their counts (count_f true) into val_a, in the order
+ ** they were first seen. Errors past CAMCOM_NUM_ERRS
+ ** codes are only in NERR. Returns the number copied.
+ ****************************************************/
+unsigned long CAMCOMErrGet (int count_f, epicsUInt32 *val_a, unsigned long nelm)
+{
+   unsigned long j;
+   /*---------------------------------------------------*/ 
+   /* The code is set before its first count, so a counted entry is complete */
+   for (j=0; (j<nelm) && (j<CAMCOM_NUM_ERRS) && camcom_errs_as[j].count; j++)
+      val_a[j] = (count_f) ? (epicsUInt32) camcom_errs_as[j].count :
+                             (epicsUInt32) camcom_errs_as[j].iss;
+   return (j);
+}
+
 /*****************************************************
  ** Driver init for each record type called by devCAMCOM
  ****************************************************/
@@ -70,29 +267,336 @@ void CAMCOMDriverInit (dbCommon *pRec, enum EPICS_RECTYPE rtyp)
    /*---------------------------------------------------*/ 
    pvt_p = callocMustSucceed (1, sizeof(CAMCOM_PVT), "calloc driver pvt");
    pvt_p->status = CAM_OKOK;   /* Init status to good */
+   pvt_p->rec_p  = pRec;       /* Process record on completion */
+   pvt_p->name_c = pRec->name;
    pRec->dpvt = (void *)pvt_p;
+   CAMCOMListAdd (pvt_p);
+   return;
+}
+
+/*****************************************************
+ ** Size the package descriptor for a record's buffer.
+ ** The most ops a package can have is what fits in the
+ ** buffer after the package header.
+ ****************************************************/
+
+void CAMCOMDescInit (CAMCOM_PVT *pvt_p, void *val_p, unsigned long nbytes)
+{
+   unsigned long maxops = 0;
+   /*---------------------------------------------------*/ 
+   pvt_p->val_p  = val_p;
+   pvt_p->nbytes = nbytes;
+   if (nbytes > offsetof(mbcd_pkg_ts, mbcd_pkt))
+      maxops = (nbytes - offsetof(mbcd_pkg_ts, mbcd_pkt)) / sizeof(mbcd_pkt_ts);
+   if (maxops > 0xFFFF)
+      maxops = 0xFFFF;
+   pvt_p->desc.maxops = (unsigned short) maxops;
+   pvt_p->desc.iops   = 0;
+   if (maxops)
+      pvt_p->desc.op_as = callocMustSucceed (maxops, sizeof(CAMCOM_OP_TS), "calloc CAMCOM descriptor");
+   return;
+}
+
+/*****************************************************
+ ** Validate the package written to a record's buffer and
+ ** build its descriptor, called by CAMCOMQueue before
+ ** the request is queued to the thread. Each packet's
+ ** stat/data must lie after the packet table and inside
+ ** the buffer (NELM). Returns 0 if good, -1 if rejected.
+ ****************************************************/
+
+int CAMCOMParse (CAMCOM_PVT *pvt_p)
+{
+   CAMCOM_DESC_TS *desc_p = &pvt_p->desc;
+   mbcd_pkg_ts *wfpkg_p = (mbcd_pkg_ts *) pvt_p->val_p;
+   mbcd_pkt_ts *wfpkt_p;   /* Packet in waveform */
+   CAMCOM_OP_TS *op_p;     /* Parsed packet */
+   unsigned long tblend;   /* End of packet table */
+   unsigned long end;      /* End of this packet's stat/data */
+   unsigned long nbytes;   /* #data bytes this packet */
+   unsigned short iops = 0;
+   unsigned short j = 0;
+   char const *why_c = NULL;
+   /*---------------------------------------------------*/ 
+   desc_p->iops = 0;
+   if (!desc_p->maxops)
+   {
+      why_c = "buffer smaller than a package";
+      goto egress;
+   }
+   iops = wfpkg_p->hdr.iop;
+   if (!iops || (iops > desc_p->maxops))
+   {
+      why_c = "op count out of range";
+      goto egress;
+   }
+   tblend = offsetof(mbcd_pkg_ts, mbcd_pkt) + iops * sizeof(mbcd_pkt_ts);
+   desc_p->size  = tblend;
+   desc_p->ndata = 0;
+   for (j=0; j<iops; j++)
+   {
+      wfpkt_p = &(wfpkg_p->mbcd_pkt[j]);
+      op_p    = &(desc_p->op_as[j]);
+      op_p->offset = (unsigned long) wfpkt_p->stad_p;
+      nbytes = (unsigned long) wfpkt_p->wc_max << 1;
+      if ((op_p->offset < tblend) || (op_p->offset & 1))
+      {
+         why_c = "stat/data offset overlaps packets or is odd";
+         goto egress;
+      }
+      /* Offset first, so the room left can not wrap */
+      if ((op_p->offset > pvt_p->nbytes) ||
+          (nbytes + CAMCOM_STAT_BYTES > pvt_p->nbytes - op_p->offset))
+      {
+         why_c = "stat/data past end of buffer";
+         goto egress;
+      }
+      end = op_p->offset + CAMCOM_STAT_BYTES + nbytes;
+      op_p->cctlw  = wfpkt_p->cctlw;
+      op_p->nbytes = (unsigned short) nbytes;
+      desc_p->ndata += nbytes;
+      if (end > desc_p->size)
+         desc_p->size = end;
+   }
+   desc_p->iops = iops;
+egress:
+   if (why_c)
+   {
+      errlogPrintf("CAMCOM [%s] package rejected, op %d of %d: %s\n",
+                   pvt_p->name_c, j, iops, why_c);
+      return (-1);
+   }
+   return (0);
+}
+
+/*****************************************************
+ ** Claim a record or C request for a submission, or
+ ** release it. The busy flag is tested and set under
+ ** the lock, so two callers can not both claim it.
+ ** Returns 0 if claimed, -1 if already outstanding.
+ ****************************************************/
+
+static int CAMCOMClaim (CAMCOM_PVT *pvt_p)
+{
+   int busy;
+   /*---------------------------------------------------*/ 
+   epicsMutexMustLock (camcom_busy_lock);
+   busy = pvt_p->busy;
+   pvt_p->busy = TRUE;
+   epicsMutexUnlock (camcom_busy_lock);
+   return ((busy) ? -1 : 0);
+}
+
+static void CAMCOMRelease (CAMCOM_PVT *pvt_p)
+{
+   /*---------------------------------------------------*/ 
+   epicsMutexMustLock (camcom_busy_lock);
+   pvt_p->busy = FALSE;
+   epicsMutexUnlock (camcom_busy_lock);
+   return;
+}
+
+/*****************************************************
+ ** Parse a claimed record's or C request's package and
+ ** queue it to the thread. The request is released if
+ ** it can not be queued. Returns 0 if queued, -1 if the
+ ** package is bad or the queue is full.
+ ****************************************************/
+
+static int CAMCOMSend (CAMCOM_PVT *pvt_p)
+{
+   THREADMSG_TS msg_s;
+   /*---------------------------------------------------*/ 
+   if (CAMCOMParse (pvt_p))
+   {
+      CAMCOMRelease (pvt_p);
+      return (-1);
+   }
+   msg_s.pvt_p = pvt_p;
+   if (epicsMessageQueueTrySend (camcom_msgQId, &msg_s, sizeof(msg_s)) == -1)
+   {
+      CAMCOMRelease (pvt_p);
+      errlogPrintf("CAMCOM [%s] queue full\n", pvt_p->name_c);
+      return (-1);
+   }
+   return (0);
+}
+
+/*****************************************************
+ ** Claim a record's or C request's package and queue it
+ ** to the thread. Returns 0 if queued, -1 if the package
+ ** is bad, the request is already outstanding or the
+ ** queue is full.
+ ****************************************************/
+
+int CAMCOMQueue (CAMCOM_PVT *pvt_p)
+{
+   /*---------------------------------------------------*/ 
+   if (!camcom_msgQId)
+   {
+      errlogPrintf("CAMCOM [%s] driver not initialized\n", pvt_p->name_c);
+      return (-1);
+   }
+   if (CAMCOMClaim (pvt_p))
+   {
+      errlogPrintf("CAMCOM [%s] request already outstanding\n", pvt_p->name_c);
+      return (-1);
+   }
+   return (CAMCOMSend (pvt_p));
+}
+
+/*****************************************************
+ ** C interface: create a request for a package buffer
+ ** of nbytes. The name is used in messages.
+ ****************************************************/
+
+CAMCOM_REQ_ID CAMCOMReqCreate (char const *name_c, void *pkg_p, unsigned long nbytes)
+{
+   CAMCOM_PVT *pvt_p;
+   /*---------------------------------------------------*/ 
+   if (!pkg_p)
+      return (NULL);
+   pvt_p = callocMustSucceed (1, sizeof(CAMCOM_PVT), "calloc CAMCOM request");
+   pvt_p->status = CAM_OKOK;
+   pvt_p->name_c = (name_c) ? name_c : "C request";
+   CAMCOMDescInit (pvt_p, pkg_p, nbytes);
+   CAMCOMListAdd (pvt_p);
+   return (pvt_p);
+}
+
+/*****************************************************
+ ** C interface: free a request. Refused while a
+ ** submission is outstanding.
+ ****************************************************/
+
+void CAMCOMReqDestroy (CAMCOM_REQ_ID req_p)
+{
+   /*---------------------------------------------------*/ 
+   if (!req_p)
+      return;
+   if (CAMCOMClaim (req_p))
+   {
+      errlogPrintf("CAMCOM [%s] not destroyed, request outstanding\n", req_p->name_c);
+      return;
+   }
+   epicsMutexMustLock (camcom_list_lock);
+   ellDelete (&camcom_list_s, &req_p->node);
+   epicsMutexUnlock (camcom_list_lock);
+   if (req_p->done_evt)
+      epicsEventDestroy (req_p->done_evt);
+   free (req_p->desc.op_as);
+   free (req_p);
+   return;
+}
+
+/*****************************************************
+ ** C interface: submit a request. done_f, if not NULL,
+ ** is called from the CAMCOM_DONE thread with the status.
+ ****************************************************/
+
+int CAMCOMSubmit (CAMCOM_REQ_ID req_p, CAMCOM_DONE_FUNC done_f, void *arg_p)
+{
+   /*---------------------------------------------------*/ 
+   if (!req_p || !camcom_msgQId || CAMCOMClaim (req_p))
+      return (CAMCOM_REJECT);
+   req_p->done_f   = done_f;
+   req_p->done_arg = arg_p;
+   return ((CAMCOMSend (req_p)) ? CAMCOM_REJECT : CAMCOM_OK);
+}
+
+/*****************************************************
+ ** C interface: submit a request and wait up to timeout
+ ** seconds for it to complete. On CAMCOM_OK the status is
+ ** returned in *iss_p. On CAMCOM_TIMEOUT the request is
+ ** still outstanding and its buffer still in use.
+ ****************************************************/
+
+int CAMCOMSubmitWait (CAMCOM_REQ_ID req_p, double timeout, vmsstat_t *iss_p)
+{
+   /*---------------------------------------------------*/ 
+   if (!req_p || !camcom_msgQId || CAMCOMClaim (req_p))
+      return (CAMCOM_REJECT);
+   if (!req_p->done_evt)
+      req_p->done_evt = epicsEventMustCreate (epicsEventEmpty);
+   epicsEventTryWait (req_p->done_evt);   /* Clear completion of a timed out submit */
+   req_p->done_f = NULL;
+   if (CAMCOMSend (req_p))
+      return (CAMCOM_REJECT);
+   if (epicsEventWaitWithTimeout (req_p->done_evt, timeout) != epicsEventWaitOK)
+      return (CAMCOM_TIMEOUT);
+   if (iss_p)
+      *iss_p = req_p->status;
+   return (CAMCOM_OK);
+}
+
+/*****************************************************
+ ** Report completion of a request: process the record,
+ ** or call back and signal the C interface waiter.
+ ** Called from the CAMCOM_DONE thread.
+ ****************************************************/
+
+static void CAMCOMComplete (CAMCOM_PVT *pvt_p, vmsstat_t iss)
+{
+   dbCommon *reccom_p = pvt_p->rec_p;
+   CAMCOM_DONE_FUNC done_f = pvt_p->done_f;
+   void *done_arg = pvt_p->done_arg;
+   epicsEventId done_evt = pvt_p->done_evt;
+   /*---------------------------------------------------*/ 
+   pvt_p->status = iss;
+   CAMCOMRelease (pvt_p);  /* May be resubmitted from here on */
+   if (reccom_p)
+   {
+      dbScanLock(reccom_p);
+      (*(reccom_p->rset->process))(reccom_p);
+      dbScanUnlock(reccom_p);
+      return;
+   }
+   if (done_f)
+      (*done_f)(pvt_p, iss, done_arg);
+   if (done_evt)
+      epicsEventSignal(done_evt);
+   return;
+}
+
+/*****************************************************
+ ** Count an error return by code
+ ****************************************************/
+static void CAMCOMErrCount (vmsstat_t iss)
+{
+   int j;
+   /*---------------------------------------------------*/ 
+   for (j=0; j<CAMCOM_NUM_ERRS; j++)
+   {
+      if (!camcom_errs_as[j].count)
+         camcom_errs_as[j].iss = iss;
+      if (camcom_errs_as[j].iss == iss)
+      {
+         camcom_errs_as[j].count++;
+         return;
+      }
+   }
+   camcom_errs_other++;
    return;
 }
 
 /*******************************************************************
-** This is the driver thread that does all of the CAMCOM Camac work.
+** This is the driver thread that builds the CAMCOM Camac packages.
+** It is the first pipeline stage: it takes requests from the CAMCOM
+** queue, builds the package from the descriptor and passes it to the
+** exec thread. The exec queue holds CAMCOM_PIPE_DEPTH packages, so
+** the next package is built while the current one runs.
 ********************************************************************/
 void threadCAMCOM (void * msgQId)
 {
-   vmsstat_t iss = CAM_OKOK;
    epicsMessageQueueId lmsgQ = msgQId;
    THREADMSG_TS msg_s;
+   PIPEMSG_TS pipe_s;
    int msgQstat;
-   mbcd_pkg_ts *wfpkg_p;  /* package in waveform */
-   void *newpkg_p;        /* Created camcom package */
-   unsigned short iops;   /* #ops in package */
    unsigned short emask = 0xFFFF; /* emask to return and report everything */
-   unsigned short nbytes; /* #bytes this packet */
-   mbcd_pkt_ts *wfpkt_p;  /* Packet pointer */
-   char *wfdat_p;         /* Pointer to stat/data */
    int j;
    CAMCOM_PVT *pvt_p;    /* Driver private struct */
-   dbCommon *reccom_p;   /* Record pointer */
+   CAMCOM_DESC_TS *desc_p;  /* Package parsed by device support */
+   CAMCOM_OP_TS *op_p;   /* Parsed packet */
    /*----------------------------*/
    while (TRUE)
    {
@@ -101,29 +605,82 @@ void threadCAMCOM (void * msgQId)
          errlogSevPrintf(errlogFatal,"CAMCOM msgQ timeout status %d. Suspending...\n", msgQstat);
          epicsThreadSuspendSelf();
       }
-      reccom_p = msg_s.rec_p;   /* Record pointer for return to device support */
-      pvt_p = (CAMCOM_PVT *)reccom_p->dpvt;   /* Local routines only know about driver private */
+      pvt_p = msg_s.pvt_p;   /* Local routines only know about driver private */
       /*****************************
-       ** Build and execute package.
+       ** Build package from the descriptor.
        ****************************/ 
-      printf ("Entered CAMCOM thread\n");
-      wfpkg_p = (mbcd_pkg_ts*) pvt_p->val_p;
-      iops = wfpkg_p->hdr.iop;
-      if (!SUCCESS(iss = camalo(&iops, &newpkg_p)))
-	 goto egress;
-      for (j=0; j<iops; j++)
+      desc_p = &pvt_p->desc;
+      pipe_s.pvt_p = pvt_p;
+      pipe_s.pkg_p = NULL;
+      pipe_s.wait  = 0.0;
+      pipe_s.exec  = 0.0;
+      epicsTimeGetCurrent (&pipe_s.start);
+      if (!SUCCESS(pipe_s.iss = camalo(&desc_p->iops, &pipe_s.pkg_p)))
+      {
+         pipe_s.pkg_p = NULL;
+         goto egress;
+      }
+      for (j=0; j<desc_p->iops; j++)
       {
-	 wfpkt_p = &(wfpkg_p->mbcd_pkt[j]);
-         wfdat_p = (char *) wfpkg_p + (int) wfpkt_p->stad_p;
-         nbytes =  wfpkt_p->wc_max << 1;
-         if (!SUCCESS(iss = camadd(&(wfpkt_p->cctlw), &wfdat_p, &nbytes, &emask, &newpkg_p)))
+         op_p = &(desc_p->op_as[j]);
+         if (!SUCCESS(pipe_s.iss = camadd(&(op_p->cctlw), (char *) pvt_p->val_p + op_p->offset,
+                                          &(op_p->nbytes), &emask, &pipe_s.pkg_p)))
 	    goto egress; 
       }
-      iss = camgo (&newpkg_p); 
    egress:
-      pvt_p->status = iss;
-      dbScanLock(reccom_p);
-      (*(reccom_p->rset->process))(reccom_p);
-      dbScanUnlock(reccom_p);
+      /* Failed builds go through too, so completions stay in order */
+      epicsMessageQueueSend (camcom_execQId, &pipe_s, sizeof(pipe_s));
    }   /* End while (TRUE) */
 }      /* End threadCAMCOM */
+
+/*******************************************************************
+** Second pipeline stage: execute each built package through the
+** camac bus arbiter and pass it on for completion. The execution
+** time is the time in camgo after the grant; the time from the
+** start of the build to the grant is the wait.
+********************************************************************/
+static void threadCAMCOMExec (void * msgQId)
+{
+   epicsMessageQueueId lmsgQ = msgQId;
+   PIPEMSG_TS pipe_s;
+   CAMARB_TIME_TS time_s;
+   /*----------------------------*/
+   while (TRUE)
+   {
+      if (epicsMessageQueueReceive (lmsgQ, &pipe_s, sizeof(pipe_s)) < 0)
+         continue;
+      if (SUCCESS(pipe_s.iss))
+      {
+         pipe_s.iss  = camArbGo (CAMARB_CLIENT_CAMCOM, &pipe_s.pkg_p, &time_s);
+         pipe_s.wait = epicsTimeDiffInSeconds (&time_s.start, &pipe_s.start);
+         pipe_s.exec = time_s.svc;
+      }
+      epicsMessageQueueSend (camcom_doneQId, &pipe_s, sizeof(pipe_s));
+   }
+}
+
+/*******************************************************************
+** Last pipeline stage: release the package, account it and
+** post the completion to the record or C request. This is the
+** only writer of the statistics.
+********************************************************************/
+static void threadCAMCOMDone (void * msgQId)
+{
+   epicsMessageQueueId lmsgQ = msgQId;
+   PIPEMSG_TS pipe_s;
+   CAMCOM_PVT *pvt_p;
+   /*----------------------------*/
+   while (TRUE)
+   {
+      if (epicsMessageQueueReceive (lmsgQ, &pipe_s, sizeof(pipe_s)) < 0)
+         continue;
+      pvt_p = pipe_s.pvt_p;
+      if (pipe_s.pkg_p)
+         camdel (&pipe_s.pkg_p);
+      CAMCOMStatsAdd (&pvt_p->stats, &pvt_p->desc, pipe_s.iss, pipe_s.exec, pipe_s.wait);
+      CAMCOMStatsAdd (&camcom_stats_s, &pvt_p->desc, pipe_s.iss, pipe_s.exec, pipe_s.wait);
+      if (!SUCCESS(pipe_s.iss))
+         CAMCOMErrCount (pipe_s.iss);
+      CAMCOMComplete (pvt_p, pipe_s.iss);
+   }
+}
@@ -0,0 +1,45 @@
+/*
+** drvCAMCOM.h
+**
+** Direct C interface to the CAMCOM thread, for IOC code (drivers,
+** sequencer programs) that wants to run a camac package without a
+** waveform record. The package is an mbcd package in a caller buffer,
+** laid out as in the CAMCOM waveform: header, packets, and each packet's
+** stat/data at the byte offset held in its stad_p. Requests are executed
+** by the same thread and descriptor code as the CAMCOM records.
+**
+** A request is created once for its buffer and may be submitted any
+** number of times, one submission outstanding at a time. The buffer
+** must not be changed while a submission is outstanding.
+**
+** The interface is called by linking against the CAMCOM library and
+** including this header; it is not in the function registry. A
+** function() line in CAMCOM.dbd is the registration for sub and aSub
+** record routines, which are called with a record pointer, and none of
+** these calls can be used that way or from the iocsh.
+*/
+#ifndef _DRV_CAMCOM_H_
+#define _DRV_CAMCOM_H_
+
+#include <slc_macros.h>
+
+/*
+** Return codes of CAMCOMSubmit and CAMCOMSubmitWait
+*/
+#define CAMCOM_OK               (0)
+#define CAMCOM_REJECT           (-1)   /* Bad package, busy request or queue full */
+#define CAMCOM_TIMEOUT          (-2)   /* Still outstanding after the timeout     */
+
+/*
+** Request handle and completion callback. The callback runs in the
+** CAMCOM_DONE thread with the camgo status; it must not block.
+*/
+typedef struct camcom_pvt_s *CAMCOM_REQ_ID;
+typedef void (*CAMCOM_DONE_FUNC) (CAMCOM_REQ_ID req_p, vmsstat_t iss, void *arg_p);
+
+CAMCOM_REQ_ID CAMCOMReqCreate  (char const *name_c, void *pkg_p, unsigned long nbytes);
+void          CAMCOMReqDestroy (CAMCOM_REQ_ID req_p);
+int           CAMCOMSubmit     (CAMCOM_REQ_ID req_p, CAMCOM_DONE_FUNC done_f, void *arg_p);
+int           CAMCOMSubmitWait (CAMCOM_REQ_ID req_p, double timeout, vmsstat_t *iss_p);
+
+#endif
@@ -0,0 +1,204 @@
+/*
+=============================================================
+
+  Abs: Crate Verifier Startup Phase Timers
+
+  Name: CVBoot.c
+
+         Timers:
+         -------
+             CV_BootTimeAdd  - Add the time elapsed since a start time to a phase
+             CV_BootShow     - Display the startup phase timers (iocsh)
+         *   CV_BootInit     - Create the timer lock
+
+  Rem:  The IOC startup time spent by the crate verifier is recorded
+        by phase: CV_Start (or CV_StartLoc) as a whole, CV_StartInit
+        for each crate, the build of the camac packages, the device
+        support init of the records, and the time the CV_ASYN thread
+        waits for drvCV_Init to release it. The crate phases are also
+        kept per crate, so a slow crate shows up next to the others.
+
+        The timers are listed by CV_BootShow() and by drvCV_Report
+        at level REPORT_BOOT. Package builds done after the startup,
+        the first time a test is requested, are counted as well.
+
+        The timers are updated by the iocsh thread (CV_Start, iocInit)
+        and by the CV_OP thread (package builds), under a mutex.
+
+  Note: * indicates static functions
+
+  Proto: CVBoot_proto.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+-------------------------------------------------------------
+  Mod:
+        dd-mmm-yyyy, First Lastname   (USERNAME):
+          comment
+
+=============================================================
+*/
+
+/* Header files */
+#include "devCV.h"
+#include "CVBoot_proto.h"
+
+/* Local Prototypes */
+static void  CV_BootInit( void *arg_p );
+
+/* Phase timers, in total and per crate */
+static cv_boot_time_ts          total_as[CV_BOOT_NUM_PHASES];
+static cv_boot_time_ts          crate_as[CV_LOG_MAX_CRATE][CV_BOOT_NUM_PHASES];
+static epicsMutexId             lock     = NULL;
+static epicsThreadOnceId        initOnce = EPICS_THREAD_ONCE_INIT;
+
+
+/*====================================================
+
+  Abs:  Create the timer lock
+
+  Name: CV_BootInit
+
+  Args: arg_p                        Not used
+          Type: pointer
+          Use:  void *
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to create the mutex
+        that serializes updates of the timers. It is called
+        once, by epicsThreadOnce().
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+static void CV_BootInit( void *arg_p )
+{
+    lock = epicsMutexMustCreate();
+    return;
+}
+
+/*====================================================
+
+  Abs:  Add the time elapsed since a start time to a phase
+
+  Name: CV_BootTimeAdd
+
+  Args: phase_e                      Startup phase
+          Type: enum
+          Use:  cv_boot_phase_te
+          Acc:  read-only
+          Mech: By value
+
+        crate                        Camac crate number
+          Type: integer              Note: 0 = not a crate phase
+          Use:  short
+          Acc:  read-only
+          Mech: By value
+
+        start_ps                     Start time of the phase
+          Type: pointer
+          Use:  epicsTimeStamp const * const
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to add the time from
+        the start time provided to now to the total of the
+        phase, and to the crate's own timer for that phase.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+void CV_BootTimeAdd( cv_boot_phase_te phase_e, short crate, epicsTimeStamp const * const start_ps )
+{
+    epicsTimeStamp    now;
+    double            sec     = 0.0;
+    cv_boot_time_ts  *time_ps = NULL;
+
+
+    if ((unsigned)phase_e >= CV_BOOT_NUM_PHASES) return;
+    epicsTimeGetCurrent(&now);
+    sec = epicsTimeDiffInSeconds(&now,start_ps);
+    epicsThreadOnce(&initOnce,CV_BootInit,NULL);
+
+    epicsMutexMustLock(lock);
+    time_ps = &total_as[phase_e];
+    time_ps->sec += sec;
+    time_ps->count++;
+    if (sec > time_ps->max) time_ps->max = sec;
+    if ((crate > 0) && (crate < CV_LOG_MAX_CRATE))
+    {
+       time_ps = &crate_as[crate][phase_e];
+       time_ps->sec += sec;
+       time_ps->count++;
+       if (sec > time_ps->max) time_ps->max = sec;
+    }
+    epicsMutexUnlock(lock);
+    return;
+}
+
+/*====================================================
+
+  Abs:  Display the startup phase timers
+
+  Name: CV_BootShow
+
+  Args: crate                        Camac Crate Number
+          Type: integer              Note: 0 = all crates
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to list the time spent
+        in each startup phase, followed by the time of each
+        crate in the crate phases.
+
+  Side: Output is sent to the standard output device
+
+  Ret:  None
+
+=======================================================*/
+void CV_BootShow( int crate )
+{
+    CV_BOOT_PHASE_LABELS;
+    unsigned short          i       = 0;
+    short                   c       = 0;
+    cv_boot_time_ts const  *time_ps = NULL;
+
+
+    printf("CV startup timers (msec)\n");
+    printf("  %-14s %10s %10s %8s\n","Phase","Total","Max","Count");
+    for (i=0; i<CV_BOOT_NUM_PHASES; i++)
+    {
+       time_ps = &total_as[i];
+       printf("  %-14s %10.1f %10.1f %8lu\n",
+              cv_boot_phase_ac[i],1000.0*time_ps->sec,1000.0*time_ps->max,time_ps->count);
+    }
+
+    printf("\n  %-6s %14s %14s %14s\n","Crate",
+           cv_boot_phase_ac[CV_BOOT_STARTINIT],
+           cv_boot_phase_ac[CV_BOOT_PKGBUILD],
+           cv_boot_phase_ac[CV_BOOT_RECINIT]);
+    for (c=1; c<CV_LOG_MAX_CRATE; c++)
+    {
+       if (crate && (c!=crate)) continue;
+       time_ps = crate_as[c];
+       if (!time_ps[CV_BOOT_STARTINIT].count && !time_ps[CV_BOOT_PKGBUILD].count &&
+           !time_ps[CV_BOOT_RECINIT].count)
+          continue;
+       printf("  %.2d     %14.1f %14.1f %14.1f\n",c,
+              1000.0*time_ps[CV_BOOT_STARTINIT].sec,
+              1000.0*time_ps[CV_BOOT_PKGBUILD].sec,
+              1000.0*time_ps[CV_BOOT_RECINIT].sec);
+    }
+    return;
+}
+
+
+epicsRegisterFunction(CV_BootShow);
+
+/* End of file */
@@ -0,0 +1,27 @@
+/*
+=============================================================
+
+  Abs:  Crate Verifier Startup Phase Timer prototypes
+
+  Name: CVBoot_proto.h
+
+  Side:  Must include the following header files
+              devCV.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+
+-------------------------------------------------------------
+  Mod:
+        dd-mmm-yyyy, First Lastname   (USERNAME):
+          comment
+
+=============================================================
+*/
+#ifndef _CVBOOT_PROTO_H_
+#define _CVBOOT_PROTO_H_
+
+void       CV_BootTimeAdd( cv_boot_phase_te phase_e, short crate, epicsTimeStamp const * const start_ps );
+void       CV_BootShow( int crate );
+
+#endif /*_CVBOOT_PROTO_H_ */
@@ -0,0 +1,488 @@
+/*
+=============================================================
+
+  Abs: Crate Verifier Asynchronous Message Log
+
+  Name: CVLog.c
+
+         Message Log:
+         ------------
+             CV_LogInit     - Start the low priority message formatting thread
+             CV_LogPost     - Post a message code to the ring (called by CV_OP threads)
+             CV_LogShow     - Display the message ring and suppression counters
+         *   CV_LogThread   - Format messages from the ring to errlog
+         *   CV_LogFormat   - Format one message record
+         *   CV_LogFlush    - Report repeats suppressed past the holdoff
+
+  Rem:  Messages are appended by the CV_OP threads to a ring of binary
+        records, with no formatting. The producers (CV_OP threads, and
+        the iocsh thread while CV_Start initializes the crates) and 
+        the consumer (CV_LOG thread) share a mutex. The producers hold
+        it for the few stores of the append, the consumer only to read
+        the head index and to release the records it has formatted.
+        The mutex orders the record stores before the head index is
+        read, so no other barrier is needed.
+
+        Repeats of an error message for the same crate within 
+        CV_LOG_HOLDOFF seconds are counted rather than posted. The
+        count is reported with the next message of that code, or by
+        the CV_LOG thread once the holdoff has expired. Messages that
+        report a change of crate state are always posted.
+
+  Note: * indicates static functions
+
+  Proto: CVLog_proto.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+-------------------------------------------------------------
+  Mod:
+        19-Oct-2026, agent            (AGENT):
+          Append under a mutex, for more than one producer
+        19-Oct-2026, agent            (AGENT):
+          Add the warm start message
+        19-Oct-2026, agent            (AGENT):
+          Flush repeats past the holdoff, never suppress state
+          changes, consumer takes the lock to read the head
+
+=============================================================
+*/
+
+/* Header files */
+#include "devCV.h"
+#include "CVLog_proto.h"
+
+/* Global variables */
+int      CV_LOG_HOLDOFF = 60;           /* seconds before a repeated message is posted again */
+
+/* Local Prototypes */
+static void  CV_LogThread(void);
+static void  CV_LogFormat( cv_log_rec_ts const * const rec_ps );
+static void  CV_LogFlush( void );
+
+/*
+ * Message ring. The head index is only written by the producers
+ * and the tail index only by the consumer, both under the lock.
+ */
+static cv_log_rec_ts            ring_as[CV_LOG_RING_SIZE];
+static volatile unsigned long   head    = 0;
+static volatile unsigned long   tail    = 0;
+static unsigned long            dropped = 0;                    /* ring full, message lost */
+static cv_log_dedup_ts          dedup_as[CV_LOG_MAX_CRATE][CV_LOG_NUM_CODES];
+static cv_thread_ts             thread_s = {NULL,0,0,NULL,NULL};
+static epicsMutexId             lock     = NULL;                /* ring and dedup_as, NULL until CV_LogInit */
+
+/*
+ * Message names, for the suppressed repeats, and whether repeats
+ * of the message are suppressed. Messages of crate state changes
+ * are never suppressed, so a transition is not lost in the holdoff.
+ */
+static char const * const       name_ac[CV_LOG_NUM_CODES] = 
+{
+   "Z-Line On", "Z issued", "Init succeeded", "Init failed (rd)", "Init failed (wt)",
+   "Offline, unable to init", "Offline verify", "Status changed", "Verify data", 
+   "Verify data (one readout)", "Power was off", "Warm start"
+};
+static epicsBoolean const       repeat_a[CV_LOG_NUM_CODES] =
+{
+   epicsFalse, epicsFalse, epicsFalse, epicsTrue,  epicsTrue,
+   epicsFalse, epicsFalse, epicsFalse, epicsTrue,
+   epicsTrue,  epicsFalse, epicsFalse
+};
+
+
+/*====================================================
+
+  Abs:  Start the message log thread
+
+  Name: CV_LogInit
+
+  Args: None
+
+  Rem:  The purpose of this function is to create the
+        event and the low priority thread that formats
+        messages from the ring. It is called from CV_Start();
+        messages posted before this call are held in the
+        ring until the thread is started.
+
+  Side: None
+
+  Ret:  long
+            OK    - Successfully completed
+            ERROR - Failed to create event or thread
+
+=======================================================*/
+long CV_LogInit( void )
+{
+    long           status    = OK;
+    unsigned int   stackSize = 8192;
+
+
+    if (thread_s.tid_ps) return(status);
+
+    lock = epicsMutexMustCreate();
+    thread_s.evtId_ps = epicsEventCreate(epicsEventEmpty);
+    if (!thread_s.evtId_ps)
+    {
+       errlogSevPrintf(errlogFatal,CV_THREADFAIL_MSG,"CV_LOG");
+       return(ERROR);
+    }
+
+    thread_s.tid_ps = epicsThreadCreate("CV_LOG",
+                                        epicsThreadPriorityLow-10,
+                                        stackSize,
+                                        (EPICSTHREADFUNC)CV_LogThread,
+                                        NULL );
+    if (!thread_s.tid_ps)
+    {
+       errlogSevPrintf(errlogFatal,CV_THREADFAIL_MSG,"CV_LOG");
+       status = ERROR;
+    }
+    return(status);
+}
+
+/*====================================================
+
+  Abs:  Post a message to the log ring
+
+  Name: CV_LogPost
+
+  Args: code_e                       Message code
+          Type: enum
+          Use:  cv_log_code_te
+          Acc:  read-only
+          Mech: By value
+
+        crate                        Camac Crate Number
+          Type: integer
+          Use:  short
+          Acc:  read-only
+          Mech: By value
+
+        slot                         Camac Crate Slot Number
+          Type: integer
+          Use:  short
+          Acc:  read-only
+          Mech: By value
+
+        arg1..arg4                   Message arguments
+          Type: integer              Note: see CV_LogFormat() for
+          Use:  unsigned long              the arguments of each code
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to queue a message for
+        the CV_LOG thread. If the same error message was posted for 
+        this crate within the last CV_LOG_HOLDOFF seconds, the message
+        is counted as suppressed and not queued. Crate state change 
+        messages are always queued. This function does no I/O, and 
+        only holds the lock for the append.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+void CV_LogPost( cv_log_code_te code_e,
+                 short          crate,
+                 short          slot,
+                 unsigned long  arg1,
+                 unsigned long  arg2,
+                 unsigned long  arg3,
+                 unsigned long  arg4 )
+{
+    epicsTimeStamp    now;
+    cv_log_dedup_ts  *dedup_ps = NULL;
+    cv_log_rec_ts    *rec_ps   = NULL;
+    unsigned long     h        = 0;
+
+
+    if ((code_e<CV_LOG_ZLINEON) || (code_e>=CV_LOG_NUM_CODES)) return;
+
+    epicsTimeGetCurrent(&now);
+    if (lock) epicsMutexMustLock(lock);
+
+    /* Drop repeats of this error message for this crate inside the holdoff window */
+    h = head;
+    dedup_ps = &dedup_as[crate & CAMAC_CRATE_MASK][code_e];
+    if ( repeat_a[code_e] && dedup_ps->posted &&
+        (epicsTimeDiffInSeconds(&now,&dedup_ps->lastTime) < CV_LOG_HOLDOFF) )
+    {
+       dedup_ps->suppressed++;
+       dedup_ps->totSuppressed++;
+       goto egress;
+    }
+
+    /* Is the ring full? */
+    if ((h - tail) >= CV_LOG_RING_SIZE)
+    {
+       dropped++;
+       goto egress;
+    }
+
+    rec_ps = &ring_as[h & (CV_LOG_RING_SIZE-1)];
+    rec_ps->time       = now;
+    rec_ps->code_e     = code_e;
+    rec_ps->c          = crate;
+    rec_ps->n          = slot;
+    rec_ps->arg_a[0]   = arg1;
+    rec_ps->arg_a[1]   = arg2;
+    rec_ps->arg_a[2]   = arg3;
+    rec_ps->arg_a[3]   = arg4;
+    rec_ps->suppressed = dedup_ps->suppressed;
+
+    dedup_ps->lastTime   = now;
+    dedup_ps->suppressed = 0;
+    dedup_ps->posted++;
+
+    /* Publish the record, then wake up the formatting thread */
+    head = h + 1;
+    if (thread_s.evtId_ps) epicsEventSignal(thread_s.evtId_ps);
+
+egress:
+    if (lock) epicsMutexUnlock(lock);
+    return;
+}
+
+/*====================================================
+
+  Abs:  Format messages from the log ring
+
+  Name: CV_LogThread
+
+  Args: None
+
+  Rem:  The purpose of this thread is to format each message
+        posted to the ring and send it to errlog. The thread runs
+        below the CV_OP thread so console output never delays
+        Camac operations. It wakes up at least once a second to
+        report the repeats whose holdoff has expired.
+
+        The lock is held to read the head index and to release the 
+        formatted records, never while formatting.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+static void CV_LogThread(void)
+{
+    unsigned long   h = 0;
+    unsigned long   t = 0;
+
+
+    thread_s.active = epicsTrue;
+    while ( !thread_s.stop )
+    {
+       epicsEventWaitWithTimeout(thread_s.evtId_ps,1.0);
+
+       epicsMutexMustLock(lock);
+       h = head;
+       t = tail;
+       epicsMutexUnlock(lock);
+       if (t != h)
+       {
+          for (; t != h; t++)
+             CV_LogFormat( &ring_as[t & (CV_LOG_RING_SIZE-1)] );
+          epicsMutexMustLock(lock);
+          tail = h;
+          epicsMutexUnlock(lock);
+       }
+       CV_LogFlush();
+    }
+    thread_s.active = epicsFalse;
+    return;
+}
+
+/*====================================================
+
+  Abs:  Report repeats suppressed past the holdoff
+
+  Name: CV_LogFlush
+
+  Args: None
+
+  Rem:  The purpose of this function is to report the repeats
+        of a message that are still pending once CV_LOG_HOLDOFF
+        seconds have passed since the message was last posted,
+        so that the count is not held until the message occurs
+        again. It is called by the CV_LOG thread.
+
+  Side: The pending count of each message reported is cleared.
+
+  Ret:  None
+
+=======================================================*/
+static void CV_LogFlush( void )
+{
+    epicsTimeStamp    now;
+    cv_log_dedup_ts  *dedup_ps = NULL;
+    unsigned long     n_a[CV_LOG_NUM_CODES];
+    unsigned short    c = 0;
+    unsigned short    i = 0;
+
+
+    epicsTimeGetCurrent(&now);
+    for (c=0; c<CV_LOG_MAX_CRATE; c++)
+    {
+       epicsMutexMustLock(lock);
+       for (i=0; i<CV_LOG_NUM_CODES; i++)
+       {
+          dedup_ps = &dedup_as[c][i];
+          n_a[i]   = 0;
+          if ( dedup_ps->suppressed &&
+              (epicsTimeDiffInSeconds(&now,&dedup_ps->lastTime) >= CV_LOG_HOLDOFF) )
+          {
+             n_a[i] = dedup_ps->suppressed;
+             dedup_ps->suppressed = 0;
+          }
+       }
+       epicsMutexUnlock(lock);
+
+       for (i=0; i<CV_LOG_NUM_CODES; i++)
+       {
+          if (n_a[i])
+             errlogSevPrintf(errlogInfo,CRAT_SUPPRESS_MSG,c,name_ac[i],n_a[i]);
+       }
+    }
+    return;
+}
+
+/*====================================================
+
+  Abs:  Format one message record
+
+  Name: CV_LogFormat
+
+  Args: rec_ps                       Message record
+          Type: pointer
+          Use:  cv_log_rec_ts const * const
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to convert the binary
+        message record back to the CRAT_*_MSG text, with
+        the severity used before messages were queued.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+static void CV_LogFormat( cv_log_rec_ts const * const rec_ps )
+{
+    unsigned long const *a = rec_ps->arg_a;
+
+    if (rec_ps->suppressed)
+       errlogSevPrintf(errlogInfo,CRAT_SUPPRESS_MSG,rec_ps->c,name_ac[rec_ps->code_e],rec_ps->suppressed);
+
+    switch(rec_ps->code_e)
+    {
+        case CV_LOG_ZLINEON:
+           errlogSevPrintf(errlogInfo,CRAT_ZLINEON_MSG,rec_ps->c);
+           break;
+
+        case CV_LOG_ZISSUED:
+           errlogSevPrintf(errlogInfo,CRAT_ZISSUED_MSG,rec_ps->c);
+           break;
+
+        case CV_LOG_INITSUCC:
+           errlogSevPrintf(errlogInfo,CRAT_INITSUCC_MSG,rec_ps->c);
+           break;
+
+        case CV_LOG_INITFAIL_RD:              /* a[0]=data, a[1]=status */
+        case CV_LOG_INITFAIL_WT:
+           errlogSevPrintf(errlogMajor,CRAT_INITFAIL_MSG,rec_ps->c,
+                           (rec_ps->code_e==CV_LOG_INITFAIL_RD)?"rd":"wt",
+                           a[0],(unsigned int)a[1]);
+           break;
+
+        case CV_LOG_CANTINIT:
+           errlogSevPrintf(errlogMajor,CRAT_CANTINIT_MSG,rec_ps->c);
+           break;
+
+        case CV_LOG_OFFVER:                   /* a[0]=wt data, a[1]=rbk data, a[2]=status */
+           errlogSevPrintf(errlogMajor,CRAT_OFFVER_MSG,rec_ps->c,a[0],a[1],(unsigned int)a[2]);
+           break;
+
+        case CV_LOG_CHNGSTAT:                 /* a[0]=status */
+           errlogSevPrintf(errlogInfo,CRAT_CHNGSTAT_MSG,rec_ps->c,"ON",(unsigned int)a[0]);
+           break;
+
+        case CV_LOG_VERDAT:                   /* a[0..3]=data1,status1,data2,status2 */
+           errlogSevPrintf(errlogMajor,CRAT_VERDAT_MSG,rec_ps->c,rec_ps->n,
+                           a[0],(unsigned int)a[1],a[2],(unsigned int)a[3]);
+           break;
+
+        case CV_LOG_VERDAT1:                  /* a[0]=readout, a[1]=data, a[2]=status */
+           errlogSevPrintf(errlogMajor,CRAT_VERDAT1_MSG,(int)a[0],rec_ps->c,rec_ps->n,
+                           a[1],(unsigned int)a[2]);
+           break;
+
+        case CV_LOG_OFFON:                    /* a[0]=data, a[1]=status */
+           errlogSevPrintf(errlogInfo,CRAT_OFFON_MSG,rec_ps->c,a[0],(unsigned int)a[1]);
+           break;
+
+        case CV_LOG_WARMSTART:
+           errlogSevPrintf(errlogInfo,CRAT_WARMSTART_MSG,rec_ps->c);
+           break;
+
+        default:
+           break;
+    }/* End of switch statement */
+    return;
+}
+
+/*====================================================
+
+  Abs:  Display the message log status
+
+  Name: CV_LogShow
+
+  Args: level                        Report level
+          Type: integer              Note: 0 = ring summary
+          Use:  int                        1 = add per crate counters
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to display the
+        ring usage and, for each crate and message code that
+        has been posted, the number of messages posted and
+        suppressed.
+
+  Side: Output is sent to the standard output device
+
+  Ret:  None
+
+=======================================================*/
+void CV_LogShow( int level )
+{
+    unsigned short    c = 0;
+    unsigned short    i = 0;
+    cv_log_dedup_ts  *dedup_ps = NULL;
+
+
+    printf("CV_LOG thread %s, ring %lu/%d used, %lu dropped, holdoff %d sec\n",
+           (thread_s.active)?"active":"not active",
+           head - tail, CV_LOG_RING_SIZE, dropped, CV_LOG_HOLDOFF );
+    if (level<1) return;
+
+    for (c=0; c<CV_LOG_MAX_CRATE; c++)
+    {
+       for (i=0; i<CV_LOG_NUM_CODES; i++)
+       {
+          dedup_ps = &dedup_as[c][i];
+          if (dedup_ps->posted)
+             printf("\tCrate %.2hu %-26s posted=%lu suppressed=%lu (pending %lu)\n",
+                    c, name_ac[i], dedup_ps->posted, dedup_ps->totSuppressed, dedup_ps->suppressed);
+       }
+    }
+    return;
+}
+
+
+epicsExportAddress(int,CV_LOG_HOLDOFF);
+epicsRegisterFunction(CV_LogShow);
+
+/* End of file */
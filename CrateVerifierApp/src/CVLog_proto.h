@@ -0,0 +1,34 @@
+/*
+=============================================================
+
+  Abs:  Crate Verifier Asynchronous Message Log prototypes
+
+  Name: CVLog_proto.h
+
+  Side:  Must include the following header files
+              devCV.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+
+-------------------------------------------------------------
+  Mod:
+        dd-mmm-yyyy, First Lastname   (USERNAME):
+          comment
+
+=============================================================
+*/
+#ifndef _CVLOG_PROTO_H_
+#define _CVLOG_PROTO_H_
+
+long  CV_LogInit( void );
+void  CV_LogPost( cv_log_code_te code_e,
+                  short          crate,
+                  short          slot,
+                  unsigned long  arg1,
+                  unsigned long  arg2,
+                  unsigned long  arg3,
+                  unsigned long  arg4 );
+void  CV_LogShow( int level );
+
+#endif /*_CVLOG_PROTO_H_ */
@@ -0,0 +1,368 @@
+/*
+=============================================================
+
+  Abs: Crate Verifier Warm Restart Snapshot
+
+  Name: CVSnap.c
+
+         Snapshot:
+         ---------
+             CV_SnapshotSet   - Set the snapshot file and save period (iocsh)
+             CV_SnapshotLoad  - Load the snapshot saved by the previous boot
+             CV_SnapshotFind  - Find the snapshot entry of a crate verifier
+             CV_SnapshotSave  - Save the state of all crates to the snapshot file
+             CV_SnapshotPoll  - Save the snapshot when the save period has elapsed
+         *   CV_SnapshotExit  - Save the snapshot at IOC exit
+
+  Rem:  On every reboot the driver used to treat each crate as newly
+        powered on, running the dataway test and pulsing Z on crates
+        that had been running fine. The state of each crate (online
+        and init status, dataway test status and the pattern left in
+        the verifier DATA register) is now saved to a local text file
+        every CV_SNAP_PERIOD seconds by the CV_ASYN thread, and at IOC
+        exit. At boot, CV_StartInit() looks up each crate in the
+        snapshot loaded before the threads are started; a crate that
+        was online and initialized, and whose DATA register still
+        holds the saved pattern, was not power cycled and is
+        initialized without the dataway test or the Z pulse.
+
+        The snapshot is disabled until a file is set with
+        CV_SnapshotSet(), which must be called before CV_Start().
+        The file is written to a temporary file first, then renamed,
+        so that a reboot during a save leaves the previous snapshot.
+
+        File format, one line per crate after the header line:
+             CVSNAP <version>
+             <branch> <crate> <slot> <stat> <bus_stat> <pattern>
+
+  Note: * indicates static functions
+
+  Proto: CVSnap_proto.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+-------------------------------------------------------------
+  Mod:
+        dd-mmm-yyyy, First Lastname   (USERNAME):
+          comment
+
+=============================================================
+*/
+
+/* Header files */
+#include <errno.h>
+#include "epicsExit.h"         /* for epicsAtExit */
+#include "devCV.h"
+#include "CVSnap_proto.h"
+
+/* Local Prototypes */
+static void  CV_SnapshotExit( void *arg_p );
+
+/* Snapshot file, save period and the snapshot loaded at boot */
+static char                     file_c[CV_SNAP_FILE_LEN] = "";
+static int                      period   = CV_SNAP_PERIOD;
+static cv_snap_rec_ts           snap_as[CV_SNAP_MAX_CRATE];
+static unsigned short           nsnap    = 0;
+static epicsTimeStamp           lastSave = {0,0};
+static epicsBoolean             loaded   = epicsFalse;
+
+
+/*====================================================
+
+  Abs:  Set the snapshot file and save period
+
+  Name: CV_SnapshotSet
+
+  Args: name_c                       Snapshot file name
+          Type: ascii-string         Note: NULL or "" disables the snapshot
+          Use:  char const * const
+          Acc:  read-only
+          Mech: By reference
+
+        sec                          Seconds between saves
+          Type: integer              Note: 0 = save at IOC exit only
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to enable the warm
+        restart snapshot. It must be called from the startup
+        script before CV_Start(). A negative sec selects
+        the default CV_SNAP_PERIOD.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+void CV_SnapshotSet( char const * const name_c, int sec )
+{
+    if (!name_c || !name_c[0])
+       file_c[0] = '\0';
+    else if (strlen(name_c) >= sizeof(file_c) - 4)
+    {
+       printf("CV snapshot file name too long (max %d)\n",(int)sizeof(file_c) - 5);
+       return;
+    }
+    else
+       strcpy(file_c,name_c);
+    period = (sec < 0) ? CV_SNAP_PERIOD : sec;
+    if (file_c[0])
+       printf("CV snapshot %s, saved every %d sec and at exit\n",file_c,period);
+    else
+       printf("CV snapshot disabled\n");
+    return;
+}
+
+/*====================================================
+
+  Abs:  Load the snapshot saved by the previous boot
+
+  Name: CV_SnapshotLoad
+
+  Args: moduleList_ps                Module linked list
+          Type: pointer
+          Use:  ELLLIST * const
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to read the snapshot
+        file into the snapshot table, and to register the save
+        of the snapshot at IOC exit. It is called once, from
+        CV_StartInit(), before the crates are initialized.
+        Lines that cannot be parsed are ignored.
+
+  Side: None
+
+  Ret:  long
+            Number of crates loaded from the snapshot
+
+=======================================================*/
+long CV_SnapshotLoad( ELLLIST * const moduleList_ps )
+{
+    FILE            *fp       = NULL;
+    cv_snap_rec_ts  *rec_ps   = NULL;
+    char             line_c[80];
+    int              version  = 0;
+    int              b, c, n;
+    unsigned int     stat, bus_stat;
+    unsigned long    pattern;
+
+
+    if (!file_c[0] || loaded)
+       return(nsnap);
+    loaded = epicsTrue;
+    epicsAtExit(CV_SnapshotExit,moduleList_ps);
+
+    fp = fopen(file_c,"r");
+    if (!fp)
+    {
+       if (errno != ENOENT)
+          errlogSevPrintf(errlogMinor,CV_SNAPFAIL_MSG,file_c,"open",strerror(errno));
+       return(nsnap);
+    }
+
+    /* Discard a snapshot written by another version */
+    if (!fgets(line_c,sizeof(line_c),fp) || (sscanf(line_c,"CVSNAP %d",&version)!=1) || (version!=CV_SNAP_VERSION))
+       errlogSevPrintf(errlogMinor,CV_SNAPFAIL_MSG,file_c,"load","bad header");
+    else
+    {
+       while (fgets(line_c,sizeof(line_c),fp) && (nsnap<CV_SNAP_MAX_CRATE))
+       {
+          if (sscanf(line_c,"%d %d %d %x %x %lx",&b,&c,&n,&stat,&bus_stat,&pattern) != 6)
+             continue;
+          rec_ps = &snap_as[nsnap++];
+          rec_ps->b        = (short)b;
+          rec_ps->c        = (short)c;
+          rec_ps->n        = (short)n;
+          rec_ps->stat     = (unsigned short)stat;
+          rec_ps->bus_stat = (unsigned short)bus_stat;
+          rec_ps->pattern  = pattern;
+       }
+       errlogSevPrintf(errlogInfo,CV_SNAPLOAD_MSG,file_c,nsnap);
+    }
+    fclose(fp);
+    return(nsnap);
+}
+
+/*====================================================
+
+  Abs:  Find the snapshot entry of a crate verifier
+
+  Name: CV_SnapshotFind
+
+  Args: b                            Camac branch
+          Type: integer
+          Use:  short
+          Acc:  read-only
+          Mech: By value
+
+        c                            Camac crate
+          Type: integer
+          Use:  short
+          Acc:  read-only
+          Mech: By value
+
+        n                            Camac slot
+          Type: integer
+          Use:  short
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to return the entry
+        of the crate verifier in the snapshot loaded at boot.
+
+  Side: None
+
+  Ret:  cv_snap_rec_ts const *
+            NULL - crate verifier not in the snapshot
+
+=======================================================*/
+cv_snap_rec_ts const * CV_SnapshotFind( short b, short c, short n )
+{
+    unsigned short i = 0;
+
+
+    for (i=0; i<nsnap; i++)
+    {
+       if ((snap_as[i].b==b) && (snap_as[i].c==c) && (snap_as[i].n==n))
+          return(&snap_as[i]);
+    }
+    return(NULL);
+}
+
+/*====================================================
+
+  Abs:  Save the state of all crates to the snapshot file
+
+  Name: CV_SnapshotSave
+
+  Args: moduleList_ps                Module linked list
+          Type: pointer
+          Use:  ELLLIST * const
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to write the crate
+        status, dataway test status and DATA register pattern
+        of every module to a temporary file, and to rename
+        it to the snapshot file once complete.
+
+  Side: The crate status is read under the module's lock.
+
+  Ret:  long
+            OK    - Successfully completed, or snapshot disabled
+            ERROR - File could not be written
+
+=======================================================*/
+long CV_SnapshotSave( ELLLIST * const moduleList_ps )
+{
+    long              status    = OK;
+    FILE             *fp        = NULL;
+    CV_MODULE        *module_ps = NULL;
+    unsigned short    stat      = 0;
+    unsigned short    bus_stat  = 0;
+    char              tmp_c[CV_SNAP_FILE_LEN];
+
+
+    if (!file_c[0] || !moduleList_ps)
+       return(status);
+    epicsTimeGetCurrent(&lastSave);
+    sprintf(tmp_c,"%s.tmp",file_c);
+    fp = fopen(tmp_c,"w");
+    if (!fp)
+    {
+       errlogSevPrintf(errlogMinor,CV_SNAPFAIL_MSG,tmp_c,"open",strerror(errno));
+       return(ERROR);
+    }
+
+    fprintf(fp,"CVSNAP %d\n",CV_SNAP_VERSION);
+    for ( module_ps = (CV_MODULE *)ellFirst(moduleList_ps);
+          module_ps;
+          module_ps = (CV_MODULE *)ellNext((ELLNODE *)module_ps) )
+    {
+       epicsMutexMustLock(module_ps->crate_s.mlock);
+       stat     = module_ps->crate_s.stat_u._i;
+       bus_stat = module_ps->crate_s.bus_stat_u._i;
+       epicsMutexUnlock(module_ps->crate_s.mlock);
+       fprintf(fp,"%hd %hd %hd %4.4hx %4.4hx %lx\n",
+               module_ps->b,module_ps->c,module_ps->n,stat,bus_stat,module_ps->pattern);
+    }
+
+    if (fclose(fp) || (rename(tmp_c,file_c)!=0))
+    {
+       errlogSevPrintf(errlogMinor,CV_SNAPFAIL_MSG,file_c,"save",strerror(errno));
+       remove(tmp_c);
+       status = ERROR;
+    }
+    return(status);
+}
+
+/*====================================================
+
+  Abs:  Save the snapshot when the save period has elapsed
+
+  Name: CV_SnapshotPoll
+
+  Args: moduleList_ps                Module linked list
+          Type: pointer
+          Use:  ELLLIST * const
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to save the snapshot
+        every period seconds. It is called by the CV_ASYN thread
+        on each tick.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+void CV_SnapshotPoll( ELLLIST * const moduleList_ps )
+{
+    epicsTimeStamp now;
+
+
+    if (!file_c[0] || (period<=0))
+       return;
+    epicsTimeGetCurrent(&now);
+    if (!lastSave.secPastEpoch)
+       lastSave = now;
+    else if (epicsTimeDiffInSeconds(&now,&lastSave) >= period)
+       CV_SnapshotSave(moduleList_ps);
+    return;
+}
+
+/*====================================================
+
+  Abs:  Save the snapshot at IOC exit
+
+  Name: CV_SnapshotExit
+
+  Args: arg_p                        Module linked list
+          Type: pointer
+          Use:  void *
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to save the state
+        of the crates on the way down, so that the next boot
+        sees the most recent state. Registered with epicsAtExit()
+        by CV_SnapshotLoad().
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+static void CV_SnapshotExit( void *arg_p )
+{
+    CV_SnapshotSave((ELLLIST *)arg_p);
+    return;
+}
+
+
+epicsRegisterFunction(CV_SnapshotSet);
+
+/* End of file */
@@ -0,0 +1,30 @@
+/*
+=============================================================
+
+  Abs:  Crate Verifier Warm Restart Snapshot prototypes
+
+  Name: CVSnap_proto.h
+
+  Side:  Must include the following header files
+              devCV.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+
+-------------------------------------------------------------
+  Mod:
+        dd-mmm-yyyy, First Lastname   (USERNAME):
+          comment
+
+=============================================================
+*/
+#ifndef _CVSNAP_PROTO_H_
+#define _CVSNAP_PROTO_H_
+
+void                   CV_SnapshotSet( char const * const name_c, int sec );
+long                   CV_SnapshotLoad( ELLLIST * const moduleList_ps );
+cv_snap_rec_ts const * CV_SnapshotFind( short b, short c, short n );
+long                   CV_SnapshotSave( ELLLIST * const moduleList_ps );
+void                   CV_SnapshotPoll( ELLLIST * const moduleList_ps );
+
+#endif /*_CVSNAP_PROTO_H_ */
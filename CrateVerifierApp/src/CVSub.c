@@ -11,7 +11,6 @@
          CV_Init               General Initialization
          CV_Bus_Data_Init      Bus line data initialization 
          CV_RWline_Init        Read-Write line data initialization 
-         CV_Stat               Crate Status Summary (worst case)
          CV_Limits             Alarm and warning limits for crate id
          CV_Bus_Data           Camac Bus Line data
          CV_RWline             Read/Write Line data (extracted from waveform)
@@ -57,7 +56,6 @@
 static long CV_Init(dbCommon *sub_ps);
 static long CV_Bus_Data_Init(genSubRecord *sub_ps);
 static long CV_RWline_Init(longSubRecord *sub_ps);
-static long CV_Stat(longSubRecord *sub_ps);
 static long CV_Limits(genSubRecord *sub_ps);
 static long CV_Bus_Data(genSubRecord *sub_ps);
 static long CV_RWline(longSubRecord *sub_ps);
@@ -226,127 +224,6 @@ static long CV_RWline_Init(longSubRecord *sub_ps)
 }
 
 
-/*=============================================================================
-
-  Name: CV_Stat
-
-  Abs: This function determines the summary message for the crate online
-       status based on the input arguments.
-
-       An bitmask will be generated based on the input information.
-       This bitmask will be used by  <device>:STATMSG (mbbo) record.
-       to provide a status summary (worst case) string.
-
-        CAMC:<area>:<crate>:STAT_SUB
-
-  Args: Type                Name        Access     Description
-        ------------------- ----------- ---------- ----------------------------
-        longSubRecord *     sub_ps      read/write pointer to subroutine record
-         
-        Input:
-        --------
-        INPA = crate online status             CAMC:<area>:<crate>:STAT       
-        INPB = crate bus line test status      CAMC:<area>:<crate>:BUSSTAT   
-        INPC = crate voltage error             CAMC:<area>:<crate>:VOLTERR.SEVR      
-        INPD = crate temperature severity      CAMC:<area>:<crate>:TEMP.SEVR           
-        INPE = id register severity            MODU:<area>:<crate><slot>:ID.SEVR    
-        INPF = data read register severity     MODU:<area>:<crate><slot>:DATA.SEVR  
-
-        Output:
-        ---------
-        VAL = status summary value (worst case) 
- 
-        such that,
-        VAL    Description 
-        ----   ------------------
-         0     Crate Power Off
-         1     Crate Power On but not initalized
-         2     Crate Online (power on and initlized)
-         3     Voltage Error
-         4     Temperature Error
-         5     Bad Id
-         6     Invalid data register pattern
-         7     No module
-         8     Voltage Warning
-         9     Temperatore Warning
-         10    Bus Error
-         11    Cmd-Line Error
-         12    RW-Line Error
-         13    X-Response Warning
-         14    Q-Response Warning
-         15    Verify init failed
-
-         VAL = crate summary message bitmask (worst case) used by <device>:STATMSG
-
-  Rem: 
- 
-  Side: None
-
-  Ret:  long 
-          OK  - Alwasys
-
-==============================================================================*/ 
-static long CV_Stat(longSubRecord *sub_ps)
-{
-  long               status  = OK;                   /* return status */
-  unsigned long      stat    = CRATE_STATSUMY_VPWROFF;
-  unsigned long      mask    = CRATE_STATSUMY_MASK;
-  unsigned long      crateOn = 0;
-  cv_bus_status_tu   bus_stat_u;
-  cv_crate_status_tu crate_stat_u;
-
-  
-  crateOn = sub_ps->a & CRATE_STATUS_GOOD;
-  if (crateOn)
-  {
-      crate_stat_u._i = sub_ps->a & CRATE_STATUS_MASK;
-      bus_stat_u._i   = sub_ps->b & BUS_STATUS_MASK;
-
-      /* Check for an id register error */
-      if ( sub_ps->e ) 
-	 stat = CRATE_STATSUMY_BADID;
-      
-      /* Data verification errors */
-      else if ( bus_stat_u._i & BUS_STATUS_INIT_ERR )
-  	  stat = CRATE_STATSUMY_INITERR;    
-      else if ( bus_stat_u._i & BUS_STATUS_CMD_ERR )
-          stat = CRATE_STATSUMY_CMDERR;
-      else if ( bus_stat_u._i & BUS_STATUS_RW_ERR )
-          stat = CRATE_STATSUMY_RWERR;
-      else if ( bus_stat_u._i & BUS_STATUS_BUS_ERR )
-          stat = CRATE_STATSUMY_BUSERR;
-
-      /* Voltage and Temperature errors */
-      else if ( sub_ps->c==MAJOR_ALARM )
-	  stat = CRATE_STATSUMY_VOLTERR;
-      else if ( sub_ps->d==MAJOR_ALARM )
-	  stat = CRATE_STATSUMY_TEMPERR;
-
-      /* Voltage and Temperature warnings */
-      else if ( sub_ps->c==MINOR_ALARM )
-	  stat = CRATE_STATSUMY_VOLTWARN;
-      else if ( sub_ps->d==MINOR_ALARM )
-	  stat = CRATE_STATSUMY_TEMPWARN;
-
-      /* Dataway verification test warnings */
-      else if ( (bus_stat_u._i & BUS_STATUS_X_ERR) || (bus_stat_u._i & BUS_STATUS_NOX_ERR) )
-          stat = CRATE_STATSUMY_XWARN;
-      else if ( (bus_stat_u._i & BUS_STATUS_Q_ERR) || (bus_stat_u._i & BUS_STATUS_NOQ_ERR) )
-          stat = CRATE_STATSUMY_QWARN;
-      else if ( bus_stat_u._i & BUS_STATUS_INIT_ERR )
-          stat = CRATE_STATSUMY_INITERR;
-      else 
-          stat = crateOn;
-  }
-  if (crateOn==CRATE_STATUS_ONINIT)
-      stat = CRATE_STATSUMY_VPWRON;
-      
-  sub_ps->val = stat & mask;
-
-  return(status);
-}
-
-
 /*=============================================================================
 
   Name: CV_Limits
@@ -572,7 +449,6 @@ static long CV_RWline(longSubRecord *sub_ps)
 
 
 epicsRegisterFunction(CV_Init);
-epicsRegisterFunction(CV_Stat);
 epicsRegisterFunction(CV_Limits);
 epicsRegisterFunction(CV_Bus_Data_Init);
 epicsRegisterFunction(CV_RWline_Init);
@@ -31,6 +31,12 @@
          blockWordSwap       - Swap word data read in a camac word block transfer
          CV_RWDataGet        - Save the read-write line word data and check for errors
 
+  Rem:   The Test Read/Write Functions are run by hand from the iocsh and 
+         call camio() directly, so they do not go through the camac bus
+         arbiter (camArbGo) or the trace ring, and may run on the PSCD
+         alongside CAMCOM and the CV_OP threads. All packages of the 
+         driver itself are arbitrated. Use the Msg functions to go
+         through the queue instead.
 
   Note: * indicates static functions
 
@@ -1140,31 +1146,41 @@ unsigned long CV_RWDataGet(cv_rwLine_type_te      type_e,
             OK - Successfully completed
             Otherwise, failure due to
                No module found
-               see return code from epicsMessageQueueTrySend()      
+               see return code from CV_SendRequest()      
             
 =======================================================*/
 long CV_SendMsg(short branch, short crate, short slot, cv_camac_func_te func_e)
 {
      long        status    = ERROR;
      CV_MODULE  *module_ps = NULL;
-     CV_REQUEST  msg_s;
+     CV_REQUEST *msg_ps    = NULL;
 
 
      module_ps = CV_FindModuleByBCN(branch,crate,slot);
      if( !module_ps )
         printf("No module found\n");
+     else if ((func_e<=CAMAC_INVALID_OP) || (func_e>=MAX_CAMAC_FUNC))
+        printf("Invalid camac function %d\n",func_e);
      else
      { 
-       /* Is this module already in the list?
-        * If yes, return with the address.
-        * If not, proceed with allocating the memory for
-        * the structure.
+       /* 
+        * Is there a test request for this function already?
+        * If not, take one from the request pool. The request
+        * is kept with the module and reused on later calls.
         */
-       status = CV_DeviceInit( func_e,"TEST",NULL, module_ps, &msg_s ); 
-       if (!status && module_ps->msgQId_ps)
+       msg_ps = module_ps->diag_ps->testReq_aps[func_e];
+       if (!msg_ps)
        {
-          CV_ClrMsgStatus( msg_s.mstat_ps );
-          status = epicsMessageQueueTrySend(module_ps->msgQId_ps,&msg_s,sizeof(CV_REQUEST));
+         msg_ps = CV_RequestAlloc();
+         module_ps->diag_ps->testReq_aps[func_e] = msg_ps;
+         if (!msg_ps) printf("No request available\n");
+       }
+       if (msg_ps)
+         status = CV_DeviceInit( func_e,CV_MSG_TEST,NULL, module_ps, msg_ps ); 
+       if (msg_ps && !status && module_ps->msgQId_ps)
+       {
+          CV_ClrMsgStatus( msg_ps->mstat_ps );
+          status = CV_SendRequest( msg_ps );
        }
     }
     return(status);
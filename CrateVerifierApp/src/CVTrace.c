@@ -0,0 +1,323 @@
+/*
+=============================================================
+
+  Abs: Crate Verifier CAMAC Transaction Trace
+
+  Name: CVTrace.c
+
+         Trace:
+         ------
+             CV_TraceInit     - Create the trace ring lock
+             CV_TraceCamgo    - Issue a package through the camac bus arbiter
+                                and record it in the trace ring
+             CV_TraceShow     - Display the trace ring, with optional filters
+             CV_TraceFreeze   - Freeze or resume the trace ring
+             CV_TraceFreezeOn - Add a status code that freezes the trace ring
+
+  Rem:  Every camgo() issued by the crate verifier driver is recorded
+        in a fixed size ring: crate, slot, camac function, package id,
+        start time, duration, return status and the camac status word
+        (X/Q) of the packet checked by the caller. Recording costs two
+        time stamps and a store, so the trace is always on.
+
+        The ring freezes itself when camgo() returns one of the status
+        codes in the freeze list, so that the history leading up to the
+        error is kept. By default the list holds CAM_SOFT_TO and
+        CAM_MBCD_NFG; CAM_CRATE_TO is left out since a powered off crate
+        returns it on every poll.
+
+        Packages are issued through camArbGo(), the camac bus arbiter 
+        shared with CAMCOM. The recorded start and duration are those 
+        of the granted camgo(), without the wait for the bus.
+
+        The ring is written by the CV_OP threads, and by the iocsh 
+        thread during CV_Start. Each entry is stored under a mutex 
+        taken after camgo() returns. CV_TraceShow may be 
+        called at any time, but entries being written while it runs 
+        may be inconsistent; freeze the trace first for an exact picture.
+
+  Note: * indicates static functions
+
+  Proto: CVTrace_proto.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+-------------------------------------------------------------
+  Mod:
+        19-Oct-2026, agent            (AGENT):
+          Add CV_TraceInit, write entries under a mutex
+        19-Oct-2026, agent            (AGENT):
+          Issue packages through the camac bus arbiter
+        19-Oct-2026, agent            (AGENT):
+          Record the start and duration of the granted camgo
+
+=============================================================
+*/
+
+/* Header files */
+#include "drvPSCDLib.h"
+#include "devCV.h"
+#include "camArb.h"            /* for camArbGo */
+#include "CVTrace_proto.h"
+
+/* Trace ring and freeze list */
+static cv_trace_rec_ts          trace_as[CV_TRACE_SIZE];
+static unsigned long            next      = 0;          /* total camgo() recorded   */
+static volatile epicsBoolean    frozen    = epicsFalse;
+static vmsstat_t                freezeOn_a[CV_TRACE_NUM_FREEZE] = {CAM_SOFT_TO,CAM_MBCD_NFG};
+static unsigned short           nfreezeOn = 2;
+static epicsMutexId             lock      = NULL;       /* writers, NULL until CV_TraceInit */
+
+
+/*====================================================
+
+  Abs:  Create the trace ring lock
+
+  Name: CV_TraceInit
+
+  Args: None
+
+  Rem:  The purpose of this function is to create the mutex
+        that serializes writes to the trace ring. It is called 
+        from CV_Start() before the CV_OP thread is started.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+void CV_TraceInit( void )
+{
+    if (!lock) lock = epicsMutexMustCreate();
+    return;
+}
+
+/*====================================================
+
+  Abs:  Issue a camac package and record it in the trace
+
+  Name: CV_TraceCamgo
+
+  Args: module_ps                    Module information
+          Type: pointer
+          Use:  CV_MODULE * const
+          Acc:  read-only
+          Mech: By reference
+
+        func_e                       Camac request function
+          Type: enum
+          Use:  cv_camac_func_te
+          Acc:  read-only
+          Mech: By value
+
+        pkg_e                        Camac package identifier
+          Type: enum
+          Use:  cv_pkg_id_te
+          Acc:  read-only
+          Mech: By value
+
+        pkg_pp                       Camac package
+          Type: pointer
+          Use:  void ** const
+          Acc:  read-write
+          Mech: By reference
+
+        stat_p                       Camac status word of the packet
+          Type: pointer              that holds the X/Q response of
+          Use:  unsigned int const * interest. Optional, NULL if none.
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to issue the package 
+        provided through the camac bus arbiter and record the transaction in the trace ring, 
+        unless the ring is frozen.
+
+  Side: Freezes the trace ring if camgo() returns a status code
+        in the freeze list.
+
+  Ret:  vmsstat_t
+            see return codes from camgo()
+
+=======================================================*/
+vmsstat_t CV_TraceCamgo( CV_MODULE          * const module_ps,
+                         cv_camac_func_te           func_e,
+                         cv_pkg_id_te               pkg_e,
+                         void              ** const pkg_pp,
+                         unsigned int const * const stat_p )
+{
+    vmsstat_t         iss    = CRAT_OKOK;
+    CAMARB_TIME_TS    time_s;
+    cv_trace_rec_ts  *rec_ps = NULL;
+    unsigned short    i      = 0;
+
+
+    iss = camArbGo(CAMARB_CLIENT_CV,pkg_pp,&time_s);
+    if (frozen) return(iss);
+
+    if (lock) epicsMutexMustLock(lock);
+    rec_ps = &trace_as[next & (CV_TRACE_SIZE-1)];
+    rec_ps->start  = time_s.start;
+    rec_ps->usec   = (unsigned long)(time_s.svc * 1.0e6);
+    rec_ps->iss    = iss;
+    rec_ps->stat   = (stat_p)?*stat_p:0;
+    rec_ps->c      = (unsigned char)module_ps->c;
+    rec_ps->n      = (unsigned char)module_ps->n;
+    rec_ps->func_e = (unsigned char)func_e;
+    rec_ps->pkg_e  = (unsigned char)pkg_e;
+    next++;
+
+    /* Freeze the trace on selected errors */
+    for (i=0; i<nfreezeOn; i++)
+    {
+       if (iss==freezeOn_a[i])
+       {
+          frozen = epicsTrue;
+          break;
+       }
+    }
+    if (lock) epicsMutexUnlock(lock);
+    return(iss);
+}
+
+/*====================================================
+
+  Abs:  Display the trace ring
+
+  Name: CV_TraceShow
+
+  Args: crate                        Camac Crate Number
+          Type: integer              Note: 0 = all crates
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+        count                        Number of entries to display
+          Type: integer              Note: 0 = whole ring
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+        errOnly                      Display only failed camgo()
+          Type: integer              Note: 0 = all entries
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to list the most recent
+        trace entries, oldest first, which match the filter.
+
+  Side: Output is sent to the standard output device
+
+  Ret:  None
+
+=======================================================*/
+void CV_TraceShow( int crate, int count, int errOnly )
+{
+    CV_CAMAC_FUNC;
+    CV_PKG_LABELS;
+    unsigned long           last   = next;
+    unsigned long           first  = 0;
+    unsigned long           i      = 0;
+    unsigned long           nshown = 0;
+    cv_trace_rec_ts const  *rec_ps = NULL;
+    char                    time_c[40];
+    char const             *func_c = NULL;
+
+
+    printf("CV camac trace: %lu camgo recorded, %s\n",next,(frozen)?"FROZEN":"running");
+    first = (last>CV_TRACE_SIZE)?(last-CV_TRACE_SIZE):0;
+    for (i=first; i<last; i++)
+    {
+       rec_ps = &trace_as[i & (CV_TRACE_SIZE-1)];
+       if (crate && (rec_ps->c!=crate)) continue;
+       if (errOnly && SUCCESS(rec_ps->iss)) continue;
+       nshown++;
+    }
+    for (i=first; (i<last) && nshown; i++)
+    {
+       rec_ps = &trace_as[i & (CV_TRACE_SIZE-1)];
+       if (crate && (rec_ps->c!=crate)) continue;
+       if (errOnly && SUCCESS(rec_ps->iss)) continue;
+       if (count && (nshown-- > (unsigned long)count)) continue;
+
+       func_c = ((rec_ps->func_e>CAMAC_INVALID_OP) && (rec_ps->func_e<=MAX_CAMAC_FUNC))?
+                cv_camac_func_as[rec_ps->func_e-1].func_c:"?";
+       epicsTimeToStrftime(time_c,sizeof(time_c),"%H:%M:%S.%06f",&rec_ps->start);
+       printf("%s c=%.2d n=%.2d %-10s %-8s %7luus iss=0x%8.8X X=%d Q=%d\n",
+              time_c,
+              rec_ps->c,
+              rec_ps->n,
+              func_c,
+              (rec_ps->pkg_e<CV_NUM_PKG_ID)?cv_pkg_label_ac[rec_ps->pkg_e]:"?",
+              rec_ps->usec,
+              (unsigned int)rec_ps->iss,
+              (rec_ps->stat & MBCD_STAT__X)?1:0,
+              (rec_ps->stat & MBCD_STAT__Q)?1:0 );
+    }
+    return;
+}
+
+/*====================================================
+
+  Abs:  Freeze or resume the trace ring
+
+  Name: CV_TraceFreeze
+
+  Args: freeze                       Freeze flag
+          Type: integer              Note: 0 = resume, otherwise freeze
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to stop or restart
+        recording in the trace ring, for example to resume
+        after the trace was frozen by an error.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+void CV_TraceFreeze( int freeze )
+{
+    frozen = (freeze)?epicsTrue:epicsFalse;
+    return;
+}
+
+/*====================================================
+
+  Abs:  Add a status code to the trace freeze list
+
+  Name: CV_TraceFreezeOn
+
+  Args: iss                          Camac status code
+          Type: integer              Note: 0 = clear the list
+          Use:  unsigned long
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to select the camgo()
+        return status codes that freeze the trace ring.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+void CV_TraceFreezeOn( unsigned long iss )
+{
+    if (!iss)
+       nfreezeOn = 0;
+    else if (nfreezeOn<CV_TRACE_NUM_FREEZE)
+       freezeOn_a[nfreezeOn++] = (vmsstat_t)iss;
+    else
+       printf("CV trace freeze list full (%d codes)\n",CV_TRACE_NUM_FREEZE);
+    return;
+}
+
+
+epicsRegisterFunction(CV_TraceShow);
+epicsRegisterFunction(CV_TraceFreeze);
+epicsRegisterFunction(CV_TraceFreezeOn);
+
+/* End of file */
@@ -0,0 +1,34 @@
+/*
+=============================================================
+
+  Abs:  Crate Verifier CAMAC Transaction Trace prototypes
+
+  Name: CVTrace_proto.h
+
+  Side:  Must include the following header files
+              devCV.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+
+-------------------------------------------------------------
+  Mod:
+        19-Oct-2026, agent            (AGENT):
+          Add CV_TraceInit
+
+=============================================================
+*/
+#ifndef _CVTRACE_PROTO_H_
+#define _CVTRACE_PROTO_H_
+
+void       CV_TraceInit( void );
+vmsstat_t  CV_TraceCamgo( CV_MODULE          * const module_ps,
+                          cv_camac_func_te           func_e,
+                          cv_pkg_id_te               pkg_e,
+                          void              ** const pkg_pp,
+                          unsigned int const * const stat_p );
+void       CV_TraceShow( int crate, int count, int errOnly );
+void       CV_TraceFreeze( int freeze );
+void       CV_TraceFreezeOn( unsigned long iss );
+
+#endif /*_CVTRACE_PROTO_H_ */
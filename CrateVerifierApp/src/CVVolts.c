@@ -0,0 +1,230 @@
+/*
+=============================================================
+
+  Abs: Crate Verifier Voltage Conversion
+
+  Name: CVVolts.c
+
+         Conversion:
+         -----------
+             CV_VoltsLutDefault - Return the nominal conversion table
+             CV_VoltsCalLoad    - Load the per-crate calibration file (iocsh)
+         *   CV_VoltsLutBuild   - Fill the conversion table of one channel
+
+  Rem:  The analog registers of the crate verifier are 8 bits wide,
+        so each channel has only 256 possible readings. The value of
+        every reading is computed once, here, into a table per channel,
+        and CV_VoltsConvert() publishes a sample with one table lookup
+        per channel, instead of the floating point conversion of every
+        sample. The temperature multiplier is folded into its channel.
+
+        All modules use the nominal table until a calibration file is
+        loaded with CV_VoltsCalLoad(), after CV_Start(). A module listed
+        in the file gets its own table, built from its gain and offset:
+
+             volts = gain * nominal + offset
+
+        File format, one line per channel, '#' starts a comment:
+             <branch> <crate> <slot> <channel 0-7> <gain> <offset>
+
+        The gain and offset in use are listed by drvCV_Report at the
+        voltage report level. The file may be loaded again at run time;
+        a table is rewritten in place, so a sample read during the load
+        may be converted with the old calibration on some channels.
+
+  Note: * indicates static functions
+
+  Proto: CVVolts_proto.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+-------------------------------------------------------------
+  Mod:
+        dd-mmm-yyyy, First Lastname   (USERNAME):
+          comment
+
+=============================================================
+*/
+
+/* Header files */
+#include "devCV.h"
+#include "drvCV_proto.h"
+#include "CVVolts_proto.h"
+
+/* Local Prototypes */
+static void  CV_VoltsLutBuild( cv_volt_lut_ts * const lut_ps, unsigned short ch, float gain, float offset );
+
+/* Nominal conversion table, shared by the modules without calibration */
+static cv_volt_lut_ts           nominal_s;
+static epicsBoolean             built = epicsFalse;
+
+
+/*====================================================
+
+  Abs:  Fill the conversion table of one channel
+
+  Name: CV_VoltsLutBuild
+
+  Args: lut_ps                       Conversion table
+          Type: pointer
+          Use:  cv_volt_lut_ts * const
+          Acc:  read-write access
+          Mech: By reference
+
+        ch                           Analog channel (subaddress)
+          Type: integer              Note: 0-7
+          Use:  unsigned short
+          Acc:  read-only
+          Mech: By value
+
+        gain                         Calibration gain
+          Type: float
+          Use:  float
+          Acc:  read-only
+          Mech: By value
+
+        offset                       Calibration offset
+          Type: float
+          Use:  float
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to compute the value
+        of every raw reading of a channel.
+
+  Side: None
+
+  Ret:  None
+
+=======================================================*/
+static void CV_VoltsLutBuild( cv_volt_lut_ts * const lut_ps, unsigned short ch, float gain, float offset )
+{
+    CV_VOLT_MULT;
+    unsigned short      rval    = 0;
+    float               slope   = CV_ANLG_SLOPE;
+    float               zero    = CV_ANLG_ZERO;
+
+
+    for (rval=0; rval<CV_ANLG_LUT_SIZE; rval++)
+       lut_ps->volts_a[ch][rval] = gain * ((slope * rval - zero) * vmult_as[ch].m1 * vmult_as[ch].m2) + offset;
+    lut_ps->gain_a[ch]   = gain;
+    lut_ps->offset_a[ch] = offset;
+    return;
+}
+
+/*====================================================
+
+  Abs:  Return the nominal conversion table
+
+  Name: CV_VoltsLutDefault
+
+  Args: None
+
+  Rem:  The purpose of this function is to return the table
+        used by modules without calibration. The table is
+        built on the first call, from CV_AddModule().
+
+  Side: None
+
+  Ret:  cv_volt_lut_ts const *
+            Nominal conversion table
+
+=======================================================*/
+cv_volt_lut_ts const * CV_VoltsLutDefault( void )
+{
+    unsigned short ch = 0;
+
+
+    if (!built)
+    {
+       for (ch=0; ch<CV_NUM_ANLG_CHANNELS; ch++)
+          CV_VoltsLutBuild(&nominal_s,ch,1.0,0.0);
+       built = epicsTrue;
+    }
+    return(&nominal_s);
+}
+
+/*====================================================
+
+  Abs:  Load the per-crate calibration file
+
+  Name: CV_VoltsCalLoad
+
+  Args: file_c                       Calibration file name
+          Type: ascii-string
+          Use:  char const * const
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to give each module
+        listed in the calibration file its own conversion
+        table, with the gain and offset of each channel listed.
+        Channels not listed keep their current calibration.
+        Lines that cannot be parsed, or for a module not in
+        the module list, are reported and skipped.
+
+  Side: Called from the startup script after CV_Start(), or
+        at run time.
+
+  Ret:  long
+            OK    - Successfully completed
+            ERROR - File could not be opened
+
+=======================================================*/
+long CV_VoltsCalLoad( char const * const file_c )
+{
+    FILE            *fp        = NULL;
+    CV_MODULE       *module_ps = NULL;
+    cv_volt_lut_ts  *lut_ps    = NULL;
+    char             line_c[120];
+    unsigned long    nline     = 0;
+    unsigned long    ncal      = 0;
+    int              b, c, n, ch;
+    float            gain, offset;
+
+
+    if (!file_c || !(fp = fopen(file_c,"r")))
+    {
+       printf("CV_VoltsCalLoad: can't open %s\n",(file_c)?file_c:"(null)");
+       return(ERROR);
+    }
+
+    while (fgets(line_c,sizeof(line_c),fp))
+    {
+       nline++;
+       if ((line_c[strspn(line_c," \t")]=='#') || (line_c[strspn(line_c," \t\r\n")]=='\0'))
+          continue;
+       if ( (sscanf(line_c,"%d %d %d %d %f %f",&b,&c,&n,&ch,&gain,&offset) != 6) ||
+            (ch<0) || (ch>=CV_NUM_ANLG_CHANNELS) )
+       {
+          printf("CV_VoltsCalLoad: %s line %lu not valid\n",file_c,nline);
+          continue;
+       }
+       module_ps = CV_FindModuleByBCN(b,c,n);
+       if (!module_ps)
+       {
+          printf("CV_VoltsCalLoad: %s line %lu, no module b%d c%d n%d\n",file_c,nline,b,c,n);
+          continue;
+       }
+
+       /* The first calibration of a module gives it its own copy of the nominal table */
+       if (module_ps->vlut_ps == CV_VoltsLutDefault())
+       {
+          lut_ps = callocMustSucceed(1,sizeof(cv_volt_lut_ts),"calloc buffer for cv_volt_lut_ts");
+          memcpy(lut_ps,&nominal_s,sizeof(cv_volt_lut_ts));
+          module_ps->vlut_ps = lut_ps;
+       }
+       else
+          lut_ps = (cv_volt_lut_ts *)module_ps->vlut_ps;
+       CV_VoltsLutBuild(lut_ps,(unsigned short)ch,gain,offset);
+       ncal++;
+    }
+    fclose(fp);
+    printf("CV_VoltsCalLoad: %s, %lu channels calibrated\n",file_c,ncal);
+    return(OK);
+}
+
+
+epicsRegisterFunction(CV_VoltsCalLoad);
+
+/* End of file */
@@ -0,0 +1,27 @@
+/*
+=============================================================
+
+  Abs:  Crate Verifier Voltage Conversion prototypes
+
+  Name: CVVolts_proto.h
+
+  Side:  Must include the following header files
+              devCV.h
+
+  Auth: 19-Oct-2026, agent            (AGENT)
+  Rev : dd-mmm-yyyy, Reviewer's Name  (USERNAME)
+
+-------------------------------------------------------------
+  Mod:
+        dd-mmm-yyyy, First Lastname   (USERNAME):
+          comment
+
+=============================================================
+*/
+#ifndef _CVVOLTS_PROTO_H_
+#define _CVVOLTS_PROTO_H_
+
+cv_volt_lut_ts const * CV_VoltsLutDefault( void );
+long                   CV_VoltsCalLoad( char const * const file_c );
+
+#endif /*_CVVOLTS_PROTO_H_ */
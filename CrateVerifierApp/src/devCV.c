@@ -28,8 +28,16 @@
          *   read_longin              - read analog input
          *   get_ioint_info_longin    - Get I/O event list info
 
+         Longoutput Output Device Support:
+         ---------------------------------
+         *   init_longout             - initialization
+         *   write_longout            - set the polling period
+
          Multibit-Binary Input Device Support:
          ------------------------------------
+         *   init_mbbi                - initialization, crate summary status
+         *   read_mbbi                - read the crate summary status
+         *   get_ioint_info_mbbi      - Get I/O event list info, crate summary status
          *   init_mbbiDirect          - initialization
          *   read_mbbiDirect          - read analog input
 
@@ -37,6 +45,9 @@
          -----------------------------
          *   init_wf                   - initialization
          *   read_wf                   - read analog input 
+         *   init_wf_crates            - initialization, crate status block
+         *   read_wf_crates            - read the status of all crates
+         *   get_ioint_info_crates     - Get I/O event list info, crate status block
  
 
   Proto: None
@@ -59,10 +70,13 @@
 #include "aiRecord.h"              /* for aiRecord                */
 #include "boRecord.h"              /* for boRecord                */
 #include "longinRecord.h"          /* for longinRecord            */
+#include "longoutRecord.h"         /* for longoutRecord           */
+#include "mbbiRecord.h"            /* for struct mbbiRecord       */
 #include "mbbiDirectRecord.h"      /* for struct mbbiDirectRecord */
 #include "waveformRecord.h"        /* for struct waveform         */
 #include "genSubRecord.h"          /* for struct genSubRecord     */
 #include "drvCV_proto.h" 
+#include "CVBoot_proto.h"          /* for CV_BootTimeAdd          */
 
 /* Local Prototypes */
 static long  CV_RequestInit(dbCommon * const rec_ps, struct camacio const * const inout_ps, cv_epics_rtyp_te rtyp_e );
@@ -74,14 +88,21 @@ static long init_bo(struct boRecord * rec_ps);
 static long write_bo(struct boRecord * rec_ps);
 static long init_longin(struct longinRecord * rec_ps);
 static long read_longin(struct longinRecord * rec_ps);
+static long init_longout(struct longoutRecord * rec_ps);
+static long write_longout(struct longoutRecord * rec_ps);
+static long init_mbbi(struct mbbiRecord * rec_ps);
+static long read_mbbi(struct mbbiRecord * rec_ps);
+static long get_ioint_info_mbbi( int cmd, dbCommon * rec_ps, IOSCANPVT * evt_pp );
 static long init_mbbiDirect(struct mbbiDirectRecord * rec_ps);
 static long read_mbbiDirect(struct mbbiDirectRecord * rec_ps);
 static long init_wf(struct waveformRecord * rec_ps);
 static long read_wf(struct waveformRecord * rec_ps);
+static long init_wf_crates(struct waveformRecord * rec_ps);
+static long read_wf_crates(struct waveformRecord * rec_ps);
+static long get_ioint_info_crates( int cmd, dbCommon * rec_ps, IOSCANPVT * evt_pp );
 static long get_ioint_info(     int cmd, dbCommon * rec_ps, IOSCANPVT * evt_pp );
 
 /* Local variable */
-static const double  slope = CV_ANLG_SLOPE;            /* 8-bits */
 static const char   *opDoneStatus_ac[]={"No","Yes"};   /* Requeset operation completion status (0,1) */
 
 /* Device Support structure */
@@ -99,15 +120,21 @@ typedef struct {
 /*Device support entry table */
 DSET      devAiCV                = {6, NULL, NULL, init_ai        , get_ioint_info , read_ai         , NULL };
 DSET      devLonginCV            = {5, NULL, NULL, init_longin    , get_ioint_info , read_longin     , NULL };
+DSET      devMbbiCV              = {5, NULL, NULL, init_mbbi      , get_ioint_info_mbbi , read_mbbi    , NULL };
 DSET      devMbbiDirectCV        = {5, NULL, NULL, init_mbbiDirect, get_ioint_info , read_mbbiDirect , NULL };
 DSET      devWfCV                = {5, NULL, NULL, init_wf        , get_ioint_info , read_wf         , NULL };
+DSET      devWfCVCrates          = {5, NULL, NULL, init_wf_crates , get_ioint_info_crates , read_wf_crates , NULL };
 DSET      devBoCV                = {5, NULL, NULL, init_bo        , NULL           , write_bo        , NULL };
+DSET      devLongoutCV           = {5, NULL, NULL, init_longout   , NULL           , write_longout   , NULL };
 
 epicsExportAddress(dset, devAiCV);
 epicsExportAddress(dset, devLonginCV);
+epicsExportAddress(dset, devMbbiCV);
 epicsExportAddress(dset, devMbbiDirectCV);
 epicsExportAddress(dset, devWfCV);
+epicsExportAddress(dset, devWfCVCrates);
 epicsExportAddress(dset, devBoCV);
+epicsExportAddress(dset, devLongoutCV);
 
 /* Global variables */ 
 int CV_DEV_DEBUG=0;
@@ -129,6 +156,11 @@ int CV_DEV_DEBUG=0;
        support function init_record(). Its purpose it to
        initializes analog input records.
 
+       The driver publishes the value already converted to volts
+       (see CVVolts.c), so no record-side conversion is set up.
+       The alarm limits of the record are passed to the driver,
+       for the crate summary status (see CV_VoltLimitUpdate).
+
        The Camac information is extracted from the INP field,
        which includes: branch, crate and slot location of the
        crate verifier module. The module linked list is searched
@@ -158,6 +190,7 @@ static long init_ai(struct aiRecord * rec_ps)
 {
     long             status     = NO_CONVERT;
     struct camacio  *camacio_ps = NULL;
+    CV_REQUEST      *dpvt_ps    = NULL;
 
 
     switch (rec_ps->inp.type) 
@@ -168,11 +201,15 @@ static long init_ai(struct aiRecord * rec_ps)
           if ((camacio_ps->a >= CV_MIN_ANLG_SUBADR) && (camacio_ps->a<=CV_MAX_ANLG_SUBADR)) 
 	  {
              status = CV_RequestInit((dbCommon *)rec_ps, camacio_ps, EPICS_RECTYPE_AI);
-	     if (status==OK)
-	     {
-               rec_ps->eslo = ((rec_ps->eguf - rec_ps->egul)/CV_ANLG_MASK) * 1000; /* mv to volts */
-	       rec_ps->roff = CV_ANLG_ZERO;
-	     }
+
+             /* The driver checks the crate summary against this record's limits */
+             dpvt_ps = (CV_REQUEST *)rec_ps->dpvt;
+             if (!status && dpvt_ps && dpvt_ps->module_ps)
+             {
+                dpvt_ps->module_ps->crate_s.vrec_aps[camacio_ps->a] = (dbCommon *)rec_ps;
+                CV_VoltLimitUpdate(dpvt_ps->module_ps,camacio_ps->a,
+                                   rec_ps->lolo,rec_ps->low,rec_ps->high,rec_ps->hihi);
+             }
 	  }
           else
              status = S_dev_badSignal;
@@ -271,6 +308,10 @@ static long get_ioint_info( int cmd, dbCommon *rec_ps, IOSCANPVT *evt_pp )
        If an error occurs the STAT and SEVR fiels of the record
        are set accordingly.
 
+       The alarm limits of the record are passed to the driver,
+       so one changed over CA is used for the crate summary 
+       status from now on.
+
   Side: Conversion from a raw value to engineering units
         will not be performed if the field "LINR" is zero.
 
@@ -286,6 +327,7 @@ static long read_ai(struct aiRecord * rec_ps)
     unsigned short         nsta      = READ_ALARM;
     unsigned short         nsev      = INVALID_ALARM;
     campkg_volts_ts       *cam_ps    = NULL;
+    cv_volt_sample_ts     *sample_ps = NULL;
     CV_REQUEST            *dpvt_ps   = (CV_REQUEST *)(rec_ps->dpvt);
     CV_MODULE             *module_ps = NULL;
     cv_message_status_ts  *mstat_ps  = NULL;
@@ -297,6 +339,10 @@ static long read_ai(struct aiRecord * rec_ps)
     module_ps = dpvt_ps->module_ps;  
     cam_ps    = &module_ps->cam_s.rd_volts_s;
     mstat_ps  = dpvt_ps->mstat_ps; 
+
+    /* Pass on alarm limits changed since the last processing */
+    CV_VoltLimitUpdate(module_ps,rec_ps->inp.value.camacio.a,
+                       rec_ps->lolo,rec_ps->low,rec_ps->high,rec_ps->hihi);
     if( (!mstat_ps->opDone) || !SUCCESS(mstat_ps->errCode) )
     { 
 	if (!module_ps->crate_s.stat_u._s.online) 
@@ -313,9 +359,11 @@ static long read_ai(struct aiRecord * rec_ps)
     }
     else
     {
+        /* All channels of the crate read the same, current sample */
+        sample_ps = &module_ps->crate_s.vsample_as[module_ps->crate_s.vcur];
         if (rec_ps->tse == epicsTimeEventDeviceTime)  
-           rec_ps->time = mstat_ps->reqTime;
-        rec_ps->val  = module_ps->crate_s.volts_a[dpvt_ps->a];
+           rec_ps->time = sample_ps->time;
+        rec_ps->val  = sample_ps->volts_a[rec_ps->inp.value.camacio.a];
         rec_ps->udf  = FALSE;       
     }
 
@@ -447,7 +495,7 @@ static long write_bo(struct boRecord * rec_ps)
     {
         /* pre-processs. Clean up the request */
         CV_ClrMsgStatus( mstat_ps );
-        if (epicsMessageQueueTrySend(module_ps->msgQId_ps,dpvt_ps,sizeof(CV_REQUEST)) == ERROR )
+        if (CV_SendRequest( dpvt_ps ) == ERROR )
         {
             recGblSetSevr(rec_ps, nsta, nsev );
             errlogPrintf("Send Message to CV Operation Thread Error [%s]\n", rec_ps->name);
@@ -641,6 +689,281 @@ static long read_longin(struct longinRecord * rec_ps)
 }
 
 
+/*=============================================================
+
+  Abs:  Long output device support initialization
+
+  Name: init_longout
+
+  Args: rec_ps                      Record information
+          Use:  struct
+          Type: longoutRecord *
+          Acc:  read-write access
+          Mech: By reference
+
+  Rem: This routine performs the long output record initialization
+       for the polling period of a periodic request. 
+
+       The Camac information is extracted from the OUT field, as
+       for the other records. The PARM portion of the field is 
+       POLL_ followed by the name of the polled function, which is
+       one of VOLTS, STAT, DATA or VERIFY (the dataway test). 
+       The long output record example for the OUT field is shown below.
+
+            field(OUT, "CAMAC_IO - #B0 C1 N1 A0 F0 @POLL_VERIFY")
+
+       The private device information is the periodic request 
+       itself. The record is the source of truth for the period:
+       the template initializes VAL to -1, so a value of 0 or more
+       was restored by autosave (pass 0) and is passed on to the 
+       driver. Otherwise the record value is set to the current 
+       period, the default or a setting made from the shell before
+       iocInit. The record is registered with the module so that 
+       CV_PollSet() writes to it after iocInit.
+
+  Side: None
+
+  Ret: long
+         OK   - Always
+       
+=============================================================*/
+static long init_longout(struct longoutRecord * rec_ps)
+{
+    static const char      prefix_c[] = "POLL_";
+    long                   status     = OK;
+    cv_camac_func_te       func_e     = CAMAC_INVALID_OP;
+    struct camacio const  *camacio_ps = NULL;
+    CV_MODULE             *module_ps  = NULL;
+    CV_REQUEST            *dpvt_ps    = NULL;
+
+    switch( rec_ps->out.type )
+    {
+        case CAMAC_IO:
+          camacio_ps = &rec_ps->out.value.camacio;
+          if (strncmp(camacio_ps->parm,prefix_c,strlen(prefix_c))==0)
+             func_e = CV_FindFuncIndex( camacio_ps->parm+strlen(prefix_c), EPICS_RECTYPE_NONE );
+          module_ps = CV_FindModuleByBCN(camacio_ps->b, camacio_ps->c, camacio_ps->n);
+          if (!module_ps)
+             status = S_dev_badCard;
+          else if ((func_e==CAMAC_INVALID_OP) || !(dpvt_ps=module_ps->poll_aps[func_e]))
+          {
+             errlogPrintf("Record %s param %s is illegal!\n", rec_ps->name, camacio_ps->parm);
+             status = S_dev_badOutType;
+          }
+          else
+          {
+             rec_ps->dpvt = dpvt_ps;
+             if ((rec_ps->val<0) || CV_PollPeriodSet(dpvt_ps,rec_ps->val))
+                rec_ps->val = dpvt_ps->period;
+             rec_ps->udf  = FALSE;
+             module_ps->prec_aps[func_e] = (dbCommon *)rec_ps;
+          }
+          break;
+
+        default:
+          status = S_dev_badBus;
+          break;
+    }
+
+    if(status)
+    {
+       recGblRecordError(status,(void *)rec_ps, "devLongoutCV Init_record failed");
+       rec_ps->pact=TRUE;
+    }
+
+    return(OK);
+}
+
+
+/*=============================================================
+
+  Abs:  Long output device support
+
+  Name: write_longout
+
+  Args: rec_ps                      Record information
+          Use:  struct
+          Type: longoutRecord *
+          Acc:  read-write access
+          Mech: By reference
+
+  Rem: This routine sets the polling period, in seconds, of the 
+       periodic request for this crate and function. A value of
+       0 disables polling. No Camac access is performed, so
+       the record completes synchronously.
+
+       If the period is invalid the STAT and SEVR fields of the 
+       record are set accordingly.
+
+  Side: None
+
+  Ret: long
+         OK     - Operation Successful
+         ERROR  - Operation failed
+       
+=============================================================*/
+static long write_longout(struct longoutRecord * rec_ps)
+{
+    long          status  = ERROR;
+    CV_REQUEST   *dpvt_ps = (CV_REQUEST *)(rec_ps->dpvt);
+
+
+    if (!dpvt_ps) return(status);
+
+    status = CV_PollPeriodSet( dpvt_ps, rec_ps->val );
+    if (status)
+       recGblSetSevr(rec_ps, WRITE_ALARM, INVALID_ALARM );
+    return(status);
+}
+
+
+/*=============================================================
+
+  Abs:  Multi-bit Binary device support initialization
+
+  Name: init_mbbi
+
+  Args: rec_ps                      Record information
+          Use:  struct
+          Type: mbbiRecord *
+          Acc:  read-write access
+          Mech: By reference
+
+  Rem: This routine performs the initialization of the multi-bit
+       binary input record that holds the crate summary status
+       (worst case), computed by the driver after each operation
+       on the crate (see CRATE_STATSUMY_xxx in devCV.h).
+
+       The Camac information is extracted from the INP field, and
+       the PARM portion of the field must be STATSUMY. The private
+       device information is the module itself.
+
+            field(INP, "CAMAC_IO - #B0 C1 N1 A0 F0 @STATSUMY")
+
+  Side: None
+
+  Ret: long
+         OK   - Always
+       
+=============================================================*/
+static long init_mbbi(struct mbbiRecord * rec_ps)
+{
+    long                   status     = OK;
+    struct camacio const  *camacio_ps = NULL;
+    CV_MODULE             *module_ps  = NULL;
+
+    switch( rec_ps->inp.type )
+    {
+        case CAMAC_IO:
+          camacio_ps = &rec_ps->inp.value.camacio;
+          module_ps  = CV_FindModuleByBCN(camacio_ps->b, camacio_ps->c, camacio_ps->n);
+          if (!module_ps)
+             status = S_dev_badCard;
+          else if (strcmp(camacio_ps->parm,"STATSUMY"))
+          {
+             errlogPrintf("Record %s param %s is illegal!\n", rec_ps->name, camacio_ps->parm);
+             status = S_dev_badInpType;
+          }
+          else
+             rec_ps->dpvt = module_ps;
+          break;
+
+        default:
+          status = S_dev_badBus;
+          break;
+    }
+
+    if(status)
+    {
+       recGblRecordError(status,(void *)rec_ps, "devMbbiCV Init_record failed");
+       rec_ps->pact=TRUE;
+    }
+    return(OK);
+}
+
+
+/*=============================================================
+
+  Abs:  Multi-bit Binary device support
+
+  Name: read_mbbi
+
+  Args: rec_ps                      Record information
+          Use:  struct
+          Type: mbbiRecord *
+          Acc:  read-write access
+          Mech: By reference
+
+  Rem: This routine sets the RVAL field to the crate summary 
+       status kept in the module. No Camac access is performed;
+       the state strings and severities are those of the record.
+
+  Side: None
+
+  Ret: long
+         OK - Successful operation, RVAL converted to VAL
+       
+=============================================================*/
+static long read_mbbi(struct mbbiRecord * rec_ps)
+{
+    CV_MODULE  *module_ps = (CV_MODULE *)(rec_ps->dpvt);
+
+    if (!module_ps) return(ERROR);
+    rec_ps->rval = module_ps->crate_s.statsumy;
+    if (rec_ps->mask) rec_ps->rval &= rec_ps->mask;
+    return(OK);
+}
+
+
+/*=============================================================
+
+  Abs:  Get I/O event list info of the crate summary status
+
+  Name: get_ioint_info_mbbi
+
+  Args: cmd                         Command (not used)
+          Use:  int
+          Type: int
+          Acc:  read-only
+          Mech: By value
+
+        rec_ps                      Record information
+          Use:  struct
+          Type: dbCommon *
+          Acc:  read-only
+          Mech: By reference
+
+        evt_pp                      I/O event list
+          Use:  pointer
+          Type: IOSCANPVT *
+          Acc:  write-only
+          Mech: By reference
+
+  Rem: This routine returns the io scan event posted by the
+       driver when the crate summary status changes.
+
+  Side: None
+
+  Ret: long
+         OK - Always
+
+=============================================================*/
+static long get_ioint_info_mbbi( int cmd, dbCommon *rec_ps, IOSCANPVT *evt_pp )
+{
+    CV_MODULE  *module_ps = (CV_MODULE *)(rec_ps->dpvt);
+
+    if (!module_ps)
+       *evt_pp = NULL;
+    else
+    {
+       if (!module_ps->crate_s.statsumy_evt_p)
+          scanIoInit( &module_ps->crate_s.statsumy_evt_p );
+       *evt_pp = module_ps->crate_s.statsumy_evt_p;
+    }
+    return(OK);
+}
+
+
 /*=============================================================
 
   Abs:  Multi-bit Binary Direct device support initialization
@@ -945,10 +1268,10 @@ static long read_wf(struct waveformRecord *rec_ps)
           case CAMAC_TST_CMD:       /* command line data         */
             rec_ps->nord = min(CMD_LINE_NUM,rec_ps->nelm);
 	    val_a = (unsigned long *)rec_ps->bptr;
-            epicsMutexMustLock( module_ps->cmdLine_s.mlock );
+            epicsMutexMustLock( module_ps->diag_ps->cmdLine_s.mlock );
             for (i=0; i<rec_ps->nord; i++)
-	      val_a[i] = module_ps->cmdLine_s.data_a[i];
-            epicsMutexUnlock( module_ps->cmdLine_s.mlock );
+	      val_a[i] = module_ps->diag_ps->cmdLine_s.data_a[i];
+            epicsMutexUnlock( module_ps->diag_ps->cmdLine_s.mlock );
 	    break;
 
           case CAMAC_TST_RW:            /* read-write lines W1-24 */ 
@@ -956,13 +1279,13 @@ static long read_wf(struct waveformRecord *rec_ps)
             rec_ps->nord = min(RW_LINE_NUM,rec_ps->nelm);
 	    val_a = (unsigned long *)rec_ps->bptr;
             if (dpvt_ps->func_e==CAMAC_TST_RW_PATTERN) 
-	      data_a = module_ps->rwLine_s.expected_data_a;
+	      data_a = module_ps->diag_ps->rwLine_s.expected_data_a;
             else
-              data_a = module_ps->rwLine_s.data_a;
-            epicsMutexMustLock( module_ps->rwLine_s.mlock );
+              data_a = module_ps->diag_ps->rwLine_s.data_a;
+            epicsMutexMustLock( module_ps->diag_ps->rwLine_s.mlock );
             for (i=0; i<rec_ps->nord; i++)
 	      val_a[i] = data_a[i];
-            epicsMutexUnlock( module_ps->rwLine_s.mlock );
+            epicsMutexUnlock( module_ps->diag_ps->rwLine_s.mlock );
 	    break;
 
           default:
@@ -973,6 +1296,138 @@ static long read_wf(struct waveformRecord *rec_ps)
 }
 
 
+/*=============================================================
+
+  Abs:  Crate status block waveform initialization
+
+  Name: init_wf_crates
+
+  Args: rec_ps                      Record information
+          Use:  struct
+          Type: waveformRecord *
+          Acc:  read-write access
+          Mech: By reference
+
+  Rem: This routine performs the initialization of the waveform
+       record that holds the packed status of all crates, one
+       cv_crate_block_ts of CV_CRATE_BLOCK_NUM elements per crate 
+       (see devCV.h). The record is not tied to a crate, so the
+       INP field is an instrument link with no parameter:
+
+           field(DTYP, "Crate Verifier Crates")
+           field(INP,  "@")
+
+       The FTVL field must be ULONG. A warning is issued if NELM
+       does not hold a block for each crate.
+
+  Side: None
+
+  Ret: long
+         OK            - Successful operation
+         S_dev_badBus  - Operation failed, INP not an instrument link
+         S_db_badField - Operation failed, FTVL not ULONG
+       
+=============================================================*/
+static long init_wf_crates(struct waveformRecord * rec_ps)
+{
+    long             status = OK;
+
+    if (rec_ps->inp.type!=INST_IO)
+       status = S_dev_badBus;
+    else if (rec_ps->ftvl!=DBF_ULONG)
+    {
+       errlogPrintf("Record %s.FTVL is invalid, ULONG required\n",rec_ps->name);
+       status = S_db_badField;
+    }
+    else
+    {
+       if (rec_ps->nelm < CV_CrateBlockGet(NULL,0))
+          errlogPrintf("Warning!! %s has %lu wf elements, expected %lu\n",
+                       rec_ps->name,(unsigned long)rec_ps->nelm,CV_CrateBlockGet(NULL,0));
+       rec_ps->nord = 0;
+    }
+
+    if(status)
+    {
+       recGblRecordError(status,(void *)rec_ps, "devWfCVCrates Init_record failed");
+       rec_ps->pact=TRUE;
+    }
+
+    return(status);
+}
+
+
+/*=============================================================
+
+  Abs:  Crate status block waveform device support
+
+  Name: read_wf_crates
+
+  Args: rec_ps                      Record information
+          Use:  struct
+          Type: waveformRecord *
+          Acc:  read-write access
+          Mech: By reference
+
+  Rem: This routine copies the packed status of all crates 
+       into the waveform record, in module list order. No Camac
+       access is performed, the status is the one kept in the
+       module by the last online watch and dataway test of
+       each crate.
+
+  Side: None
+
+  Ret: long
+         OK - Always
+
+=============================================================*/
+static long read_wf_crates(struct waveformRecord *rec_ps)
+{
+    rec_ps->nord = CV_CrateBlockGet((epicsUInt32 *)rec_ps->bptr,rec_ps->nelm);
+    return(OK);
+}
+
+
+/*=============================================================
+
+  Abs:  Get I/O event list info of the crate status block
+
+  Name: get_ioint_info_crates
+
+  Args: cmd                         Command (not used)
+          Use:  int
+          Type: int
+          Acc:  read-only
+          Mech: By value
+
+        rec_ps                      Record information
+          Use:  struct
+          Type: dbCommon *
+          Acc:  read-only
+          Mech: By reference
+
+        evt_pp                      I/O event list
+          Use:  pointer
+          Type: IOSCANPVT *
+          Acc:  write-only
+          Mech: By reference
+
+  Rem: This routine returns the io scan event posted by the
+       driver when an online watch of any crate has completed.
+
+  Side: None
+
+  Ret: long
+         OK - Always
+
+=============================================================*/
+static long get_ioint_info_crates( int cmd, dbCommon *rec_ps, IOSCANPVT *evt_pp )
+{
+    *evt_pp = CV_CrateBlockEvent();
+    return(OK);
+}
+
+
 /*====================================================
  
   Abs:  Initialize the private devicec info for this record
@@ -1002,6 +1457,16 @@ static long read_wf(struct waveformRecord *rec_ps)
         field of the specified record and initialize the
         private device information.
 
+        Input records only read the status and data kept in
+        the module for their function, so all input records of
+        a module and function share one request, interned in
+        module_ps->dsup_aps[]. The shared request is keyed by 
+        module and function only, so it holds no subaddress or 
+        function code of a record; the subaddress of an ai record 
+        is taken from its own INP field. Output records keep their
+        own request, as the request completion processes the
+        record that submitted it.
+
   Side: None
   
   Ret:  long 
@@ -1023,10 +1488,12 @@ static long CV_RequestInit(dbCommon             * const rec_ps,
     CV_MODULE         *module_ps = NULL;
     CV_REQUEST        *dpvt_ps   = NULL;
     waveformRecord    *wf_ps     = NULL;     
+    epicsTimeStamp     start;
 
 
     /* parameter check */
     if ((rtyp_e<=EPICS_RECTYPE_NONE) || (rtyp_e>EPICS_RECTYPE_WF)) return(status);
+    epicsTimeGetCurrent(&start);
 
     /* Is this a valid function for this record type? If not, return after issuing an error message */
     func_e = CV_FindFuncIndex( inout_ps->parm, rtyp_e );
@@ -1070,15 +1537,34 @@ static long CV_RequestInit(dbCommon             * const rec_ps,
             }
             else
             {
-               dpvt_ps = (CV_REQUEST *)callocMustSucceed(1, sizeof(CV_REQUEST), "calloc CV_REQUEST");
-               status  = CV_DeviceInit( func_e, "DSUP", rec_ps,module_ps,dpvt_ps );
+               /* Input records share the request of their module and function */
+               if (rtyp_e!=EPICS_RECTYPE_BO)
+                  dpvt_ps = module_ps->dsup_aps[func_e];
+               if (dpvt_ps)
+               {
+                  rec_ps->dpvt = dpvt_ps;
+                  status = OK;
+                  break;
+               }
+               dpvt_ps = CV_RequestAlloc();
+               if (!dpvt_ps)
+               {
+                  status = S_dev_noMemory;
+                  break;
+               }
+               if (rtyp_e==EPICS_RECTYPE_BO)
+                  status = CV_DeviceInit( func_e, CV_MSG_DSUP, rec_ps,module_ps,dpvt_ps );
+               else
+               {
+                  status = CV_DeviceInit( func_e, CV_MSG_DSUP, NULL,module_ps,dpvt_ps );
+                  if (status==OK) module_ps->dsup_aps[func_e] = dpvt_ps;
+               }
                rec_ps->dpvt = dpvt_ps;
-               dpvt_ps->a   = inout_ps->a;
-               dpvt_ps->f   = inout_ps->f;
             }
             break;
       }/* End of switch statement */
     }
+    CV_BootTimeAdd(CV_BOOT_RECINIT,inout_ps->c,&start);
     return(status);
 }
 
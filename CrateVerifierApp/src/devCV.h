@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <stddef.h>
 
 /*
@@ -50,6 +51,7 @@
 #include "errlog.h"
 #include "special.h"
 #include "epicsTime.h"
+#include "epicsTypes.h"
 #include "epicsMutex.h"
 #include "epicsEvent.h"
 #include "epicsInterrupt.h"
@@ -87,11 +89,18 @@ extern "C" {
 
 #define CV_MODU_MSG          "Crate Verifier modules (%d) have been registered with the PSCD\n"
 #define CV_NOMODU_MSG        "No Crate Verifier Modules have been registerd with the PSCD\n"
+#define CV_LOCPARSE_MSG      "CV location \"%s\" invalid at \"%s\", expected [Bb]Cc[Ss]n[,...]\n"
+#define CV_LOCDUP_MSG        "CV location B%hdC%hdS%hd ignored, crate %hd already registered\n"
 #define CV_QCREATE_ERR_MSG   "Failed to create message Queue for CV Operation!\n"
+#define CV_SNAPLOAD_MSG      "CV snapshot %s: %hu crates loaded\n"
+#define CV_SNAPFAIL_MSG      "CV snapshot %s: %s failed (%s)\n"
 #define CV_NOQ_MSG           "No messag Queue for CV Operation!\n"
-#define CV_OPNOQ_MSG         "CV_OP thread exiting, no queue available!\n"
+#define CV_OPNOQ_MSG         "%s thread exiting, no queue available!\n"
 #define CV_QTMO_MSG          "%s thread error, message Queue timeout occurred - status %d. Suspending thread!\n"
 #define CV_INVFUNC_MSG       "Invalid Camac function %d sent to CV Operations thread\n"
+#define CV_REQPOOL_MSG       "CV request pool exhausted (%hu requests), request not allocated!\n"
+#define CV_REQDROP_MSG       "%s: no request for camac func(%d) of CV[b=%hd,c=%hd,n=%hd], request dropped!\n"
+#define CV_REQGROW_MSG       "CV request pool full (%d modules), module B%hdC%hdS%hd not added!\n"
 #define CV_ASYNSEND_MSG      "CV_ASYN sending periodic messages to queue!\n"
 #define CV_THREADSTART_MSG   "%s thread starting, tid = %p\n"
 #define CV_THREADFAIL_MSG    "%s thread failed to start!\n"
@@ -128,6 +137,57 @@ extern "C" {
 #define CRAT_ACBAD_MSG          "Crate watch found CAMAC problem in crate %.2d\n"
 #define CRAT_CREXCTVF_MSG       "Crate %2.d verifier test: reps, errors: %.hd\n"
 #define CRAT_CREXERV_MSG        "Verifier in crate %.2d gave %s; test expected %s\n"
+#define CRAT_ZLINEON_MSG        "Crate %.2d Z-Line On\n"
+#define CRAT_SUPPRESS_MSG       "Crate %.2d message \"%s\" repeated, %lu repeats suppressed\n"
+#define CRAT_WARMSTART_MSG      "Crate %.2d verifier data kept since last snapshot, Z not pulsed\n"
+
+/******************************************************************************************/
+/*********************            Asynchronous Message Log      ***************************/
+/******************************************************************************************/
+
+/* 
+ * Messages posted by the CV_OP thread are queued as binary records in 
+ * a ring and formatted by the low priority CV_LOG thread (see CVLog.c).
+ * Each code below maps to one of the CRAT_*_MSG formats above.
+ */
+typedef enum cv_log_code_e
+{
+    CV_LOG_ZLINEON,                /* CRAT_ZLINEON_MSG                  */
+    CV_LOG_ZISSUED,                /* CRAT_ZISSUED_MSG                  */
+    CV_LOG_INITSUCC,               /* CRAT_INITSUCC_MSG                 */
+    CV_LOG_INITFAIL_RD,            /* CRAT_INITFAIL_MSG, data read      */
+    CV_LOG_INITFAIL_WT,            /* CRAT_INITFAIL_MSG, data write     */
+    CV_LOG_CANTINIT,               /* CRAT_CANTINIT_MSG                 */
+    CV_LOG_OFFVER,                 /* CRAT_OFFVER_MSG                   */
+    CV_LOG_CHNGSTAT,               /* CRAT_CHNGSTAT_MSG                 */
+    CV_LOG_VERDAT,                 /* CRAT_VERDAT_MSG                   */
+    CV_LOG_VERDAT1,                /* CRAT_VERDAT1_MSG                  */
+    CV_LOG_OFFON,                  /* CRAT_OFFON_MSG                    */
+    CV_LOG_WARMSTART               /* CRAT_WARMSTART_MSG                */
+} cv_log_code_te;
+
+#define CV_LOG_NUM_CODES   12
+#define CV_LOG_NUM_ARGS    4
+#define CV_LOG_RING_SIZE   64      /* must be a power of 2              */
+#define CV_LOG_MAX_CRATE   (CAMAC_CRATE_MASK+1)
+
+typedef struct cv_log_rec_s
+{
+    epicsTimeStamp     time;                      /* time message posted           */
+    cv_log_code_te     code_e;                    /* message code                  */
+    short              c;                         /* CAMAC crate                   */
+    short              n;                         /* CAMAC slot                    */
+    unsigned long      arg_a[CV_LOG_NUM_ARGS];    /* message arguments             */
+    unsigned long      suppressed;                /* repeats suppressed before it  */
+} cv_log_rec_ts;
+
+typedef struct cv_log_dedup_s
+{
+    epicsTimeStamp     lastTime;                  /* time last posted to the ring  */
+    unsigned long      posted;                    /* number posted to the ring     */
+    unsigned long      suppressed;                /* repeats since last posted     */
+    unsigned long      totSuppressed;             /* total repeats suppressed      */
+} cv_log_dedup_ts;
 
 /******************************************************************************************/
 /*********************                   Status Codes           ***************************/
@@ -166,6 +226,7 @@ extern "C" {
 #define REPORT_DETAILED  3
 #define REPORT_VOLTAGE   4
 #define REPORT_EXPERT    5
+#define REPORT_BOOT      6     /* startup phase timers only */
 
 /******************************************************************************************/
 /******************************************************************************************/
@@ -178,6 +239,8 @@ extern "C" {
 #define CAMAC_SLOT_MASK             0x1F             /* Camac slot number mask   */
 #define CAMAC_FUNC_MASK             0xF              /* Camac function code mask */
 #define CAMAC_SUBADDR_MASK          0x1F             /* Camac subaddress mask    */
+#define CAMAC_MAX_BRANCH            3                /* Camac branch number 0-3  */
+#define CAMAC_MAX_SLOT              24               /* Camac slot number 1-24   */
 
 /* Error Masks */
 #define CAMAC_EMASK_XQ              0xF300
@@ -265,6 +328,31 @@ typedef struct
                 {0.0010,1,"VGND"}, {0.0015,1,"-6V"}, {0.0030,1,"-12V"},\
                 {0.0060,1,"-24V"}, {0.0010,25,"Temp"}}
 
+/*
+ * Alarm limits of each analog channel, used by the driver for the crate
+ * summary status and the fast watch. A reading at or beyond HIHI/LOLO is
+ * a MAJOR alarm, at or beyond HIGH/LOW a MINOR alarm, as for the ai
+ * record. Each crate keeps the limits of its own ai records, taken when
+ * the records are initialized and each time they process, so a limit
+ * changed over CA is used from the record's next processing (see
+ * CV_VoltLimitUpdate). CV_VOLT_LIMITS, those of 
+ * cv_camac_crat_volts.substitutions, are used until then and for the
+ * channels with no record (+12V, -12V), which have all limits 0 and are
+ * not checked. CV_VoltLimitSet() sets the limits of the records.
+ */
+typedef struct
+{
+  float   lolo;
+  float   low;
+  float   high;
+  float   hihi;
+}cv_volt_limit_ts;
+
+#define CV_VOLT_LIMITS \
+               {{ 23.0, 23.0, 25.0, 25.0}, {  0.0,  0.0,  0.0,  0.0},{ 5.7, 5.7, 6.3, 6.3},\
+                { -0.1, -0.1,  0.1,  0.1}, { -6.3, -6.3, -5.7, -5.7},{ 0.0, 0.0, 0.0, 0.0},\
+                {-25.0,-25.0,-23.0,-23.0}, {  0.0,  0.0, 50.0, 50.0}}
+
 #define CV_VOLT_LABEL  const char *vlabel_a[] = \
               {"+24V","+12V","+6V ","GND "  ,"-6V " ,"-12V","-24V","Temp"}
 
@@ -277,6 +365,39 @@ typedef struct
 #define CV_ANLG_MASK           0x00ff      /* Analog registers */
 #define CV_DATA_MASK           0x000000ff  /* Data register    */
 
+/*
+ * Conversion of the 8-bit analog registers. Each module points to a table
+ * holding, for each channel, the value converted for every raw reading:
+ *      volts = gain * ((CV_ANLG_SLOPE * rval - CV_ANLG_ZERO) * m1 * m2) + offset
+ * The modules share the nominal table (gain 1, offset 0) until a calibration
+ * file gives them their own (see CVVolts.c).
+ */
+#define CV_ANLG_LUT_SIZE       (CV_ANLG_MASK+1)
+
+typedef struct cv_volt_lut_s
+{
+  float   volts_a[CV_NUM_ANLG_CHANNELS][CV_ANLG_LUT_SIZE];  /* converted value by raw reading */
+  float   gain_a[CV_NUM_ANLG_CHANNELS];                     /* calibration gain               */
+  float   offset_a[CV_NUM_ANLG_CHANNELS];                   /* calibration offset             */
+} cv_volt_lut_ts;
+
+/*
+ * A voltage read is published as one sample for all channels of a crate.
+ * The CV_OP thread fills the next of CV_VOLT_NUM_SAMPLE samples and then
+ * makes it current, so the ai records of a crate read the same, complete 
+ * sample with no lock. The previous samples are left untouched for a
+ * read cycle, long enough for any record still reading one of them.
+ */
+#define CV_VOLT_NUM_SAMPLE     3
+
+typedef struct cv_volt_sample_s
+{
+  epicsTimeStamp  time;                                     /* time of the read               */
+  float           volts_a[CV_NUM_ANLG_CHANNELS];            /* converted values               */
+  unsigned int    stat_a[CV_NUM_ANLG_CHANNELS];             /* camac status word per channel  */
+  unsigned short  raw_a[CV_NUM_ANLG_CHANNELS];              /* raw register data              */
+} cv_volt_sample_ts;
+
 /******************************************************************************************/
 /*********************                    CAMAC Bus             ***************************/
 /*********************               Command Line Test          ***************************/
@@ -370,24 +491,26 @@ typedef struct cv_busdata_s
 /******************************************************************************************/
 
 /* 
- * There are two threads that supports the crate verifier application:
- *    CV_OpThread - Operational, which process all camac messages from a queue
- *    CV_AsynThread - Sends periodic camac function request to the  messages queue 
+ * The threads that support the crate verifier application:
+ *    CV_OpThread - Operational, which process all camac messages from a queue.
+ *                  There is one queue and one such thread per PSCD card, 
+ *                  for the crates on that card (see CV_CardOf).
+ *    CV_AsynThread - Sends periodic camac function request to the  messages queues 
  */
-#define CV_OP_THREAD   0    /* CV_OpThread index into cvThread_as structure   */
-#define CV_ASYN_THREAD 1    /* CV_AsynThread index into cvThread_as structure */
-#define CV_NUM_THREADS 2    /* # of threads that support the crate verifier   */
+#define CV_MAX_PSCD    1    /* # of PSCD cards, drvPSCD drives one (pscd_card)  */
+#define CV_OP_THREAD   0    /* CV_OpThread index of the first card              */
+#define CV_ASYN_THREAD (CV_OP_THREAD+CV_MAX_PSCD) /* CV_AsynThread index       */
+#define CV_NUM_THREADS (CV_ASYN_THREAD+1)  /* # of threads that support the crate verifier */
+
+#define CV_OP_THREAD_OF(card)  (CV_OP_THREAD+(card))   /* CV_OpThread index of a card */
 
 /*
- * enum for interval for pocessing asyn messages. This is an index
- * into the asyn message list.
+ * The asyn thread wakes up once every tick and sends each periodic
+ * request whose period has elapsed. Periods are kept per crate and
+ * per function in seconds, and may be changed at runtime (see CV_PollSet).
  */
-#define CV_NUM_ASYN_PERIOD  2  /* number of asyn groupings */
-typedef enum cv_interval_e
- {
-   CV_10SEC, 
-   CV_60SEC
- }cv_interval_te;
+#define CV_ASYN_TICK        1.0    /* asyn thread tick, in seconds       */
+#define CV_POLL_MAX_PERIOD  3600   /* longest polling period, in seconds */
 
 
 typedef struct cv_thread_s
@@ -419,13 +542,13 @@ typedef struct cv_message_status_s
   IOSCANPVT         evt_p;              /* io scan event                */
 
   /*
-   * This lock should be used when accessing anything within this data structure.
    * The functions CV_ClrMsgStatus() and CV_SetMsgStatus() should be used to
    * update the information in this structure. The function CV_ClrMsgStatus()
    * is called before a message is sent to the queue, and the function
    * CV_SetMsgStatus() is called after completion of the camac request.
+   * The sender owns the structure until the request is queued and the
+   * CV_OP thread owns it until completion, so no lock is kept.
    */
-  epicsMutexId      mlock;              /* Mutex lock                   */ 
 } cv_message_status_ts;
 
 /******************************************************************************************/
@@ -495,18 +618,23 @@ typedef struct
     {"RW_PATTERN" , EPICS_RECTYPE_WF   , CAMAC_TST_RW_PATTERN  } }
 
 
+/*
+ * Default polling period of the periodic requests added for each 
+ * module. The dataway test is time-sliced, one step every 
+ * period/CV_DATAWAY_NUM_STEP seconds. A period of 0 disables polling.
+ */
 typedef struct cv_asyn_types_s
 {
    cv_camac_func_te func_e;
-   cv_interval_te   interval_e;
+   unsigned long    period;          /* seconds */
 } cv_asyn_types_ts;
 
 #define CV_NUM_ASYN_FUNC    4
 #define CV_ASYN_TYPES  \
-    const cv_asyn_types_ts asynMsgs_as[CV_NUM_ASYN_FUNC] = { {CAMAC_RD_DATA,CV_10SEC},\
-                                                             {CAMAC_RD_VOLTS,CV_10SEC},\
-                                                             {CAMAC_RD_CRATE_STATUS, CV_10SEC},\
-                                                             {CAMAC_TST_DATAWAY,CV_60SEC}}
+    const cv_asyn_types_ts asynMsgs_as[CV_NUM_ASYN_FUNC] = { {CAMAC_RD_DATA,10},\
+                                                             {CAMAC_RD_VOLTS,10},\
+                                                             {CAMAC_RD_CRATE_STATUS,10},\
+                                                             {CAMAC_TST_DATAWAY,60}}
 
 /******************************************************************************************/
 /*********************       CAMAC Status/Data Structures       ***************************/
@@ -614,10 +742,14 @@ typedef struct campkg_data_s
   statd_4u_ts             statd_as[2];   /* status-data                   */
 } campkg_data_ts;
 
-/* Command Line test camac package */
+/* 
+ * Command Line test camac packets, part of the dataway package.
+ * The first seven lines are tested starting with a read from
+ * the SCC to address the crate controller (statd_s), the remainder
+ * end with a clear of the inhibit line (inhibit_stat).
+ */
 typedef struct campkg_cmd_s
 {
-  void                   *pkg_p[2];             /* ptr to camac package   */
   statd_4u_ts             statd_s;
   unsigned int            stat_a[CMD_LINE_NUM];  
   statd_4u_ts             rd_statd_as[CMD_LINE_NUM+1]; 
@@ -630,7 +762,6 @@ typedef struct campkg_cmd_s
  */
 typedef struct campkg_rlines_walk1_s
 {
-  void                   *pkg_p;             /* ptr to camac package                          */
   unsigned int            stat;              /* clear registers on bus, pulse the C-line      */
   campkt_statd_rw_ts      rd_statd_s;        /* read DATA register                            */
 } campkg_rlines_walk1_ts;
@@ -641,7 +772,6 @@ typedef struct campkg_rlines_walk1_s
  */
 typedef struct campkg_rlines_walk0_s
 {
-  void                   *pkg_p;             /* ptr to camac package                          */
   unsigned int            stat;              /* clear registers on bus, pulse the C-line      */
   unsigned int            wt_stat;           /* set ROTATE register for walking zeros         */
   campkt_statd_rw_ts      rd_statd_s;        /* read DATA register and rotate left            */
@@ -653,7 +783,6 @@ typedef struct campkg_rlines_walk0_s
  */
 typedef struct campkg_rlines_walk1_4_s
 {
-  void                   *pkg_p;             /* ptr to camac package                          */
   unsigned int            stat;              /* clear registers on bus, pulse the C-line      */
   campkt_statd_4u_rw_ts   rd_statd_s;        /* read DATA register and rotate left            */
 } campkg_rlines_walk1_4_ts;
@@ -661,7 +790,6 @@ typedef struct campkg_rlines_walk1_4_s
 
 typedef struct campkg_rlines_walk0_4_s
 {
-  void                   *pkg_p;             /* ptr to camac package                          */
   unsigned int            stat;              /* clear registers on bus, pulse the C-line       */
   unsigned int            wt_stat;           /* set ROTATE register for walking zero          */
   campkt_statd_4u_rw_ts   rd_statd_s;        /* read DATA register                            */
@@ -670,26 +798,26 @@ typedef struct campkg_rlines_walk0_4_s
 /* 
  * Write line test with simulated walking ones and zeros.
  * This test is done with p24 on the write and read operations.
+ * There is a write and read packet for each bit of each type 
+ * of test, so the test needs no camac package of its own.
  */
 typedef struct campkg_wlines_4_s
 {
-  void                   *pkg_p;             /* ptr to camac package  */
-  statd_4u_ts             wt_statd_s;        /* set DATA register     */
-  statd_4u_ts             rd_statd_s;        /* read DATA register    */
+  statd_4u_ts             wt_statd_as[RW_LINE_NUM_TYPE][RW_LINE_NUM];  /* set DATA register  */
+  statd_4u_ts             rd_statd_as[RW_LINE_NUM_TYPE][RW_LINE_NUM];  /* read DATA register */
 } campkg_wlines_4_ts;
 
 /* 
  * Write line test with simulated walking ones and zeros.
  * This test is done without p24 on the write and with p24
- * on read operation
+ * on read operation, one set of packets for each bit tested.
  */
 typedef struct campkg_wlines_s
 {
-  void                   *pkg_p;             /* ptr to camac package               */
-  statd_4u_ts             clr_statd_s;       /* clear out old data from            */
-					     /* high order bytes of DATA registser */
-  statd_2u_ts             wt_statd_s;        /* load DATA register                 */
-  statd_4u_ts             rd_statd_s;        /* read DATA register                 */
+  statd_4u_ts             clr_statd_as[RW_LINE_NUM_TYPE][RW_LINE_NUM2]; /* clear out old data from            */
+					                                 /* high order bytes of DATA registser */
+  statd_2u_ts             wt_statd_as[RW_LINE_NUM_TYPE][RW_LINE_NUM2];  /* load DATA register                 */
+  statd_4u_ts             rd_statd_as[RW_LINE_NUM_TYPE][RW_LINE_NUM2];  /* read DATA register                 */
 } campkg_wlines_ts;
 
 typedef struct campkg_rwlines_s
@@ -701,8 +829,7 @@ typedef struct campkg_rwlines_s
     /*  
      * Write line test with simulated alking ones and zeros. This test
      * is donw with P24 on both the read and write operations.
-     * Note: teste 4 just uses test 3 package....setting the data 
-     * with walking zero bit.
+     * Note: test 4 is the walking zero half of test 3.
      */
     campkg_wlines_4_ts            test3_s;    /* simulated walking ones bit with p24  */
 
@@ -713,26 +840,63 @@ typedef struct campkg_rwlines_s
     /*
      * Write line test with simulated walking ones and zeros.
      * This test is done without p24 on the write and with p24 on read operation.
-     * Note: teste 8 just uses test 7 package....setting the data 
-     * with walking zero bit.    
+     * Note: test 8 is the walking zero half of test 7.
      */
     campkg_wlines_ts             test7_s;    /* simulated walking ones bit           */
    
 }campkg_rwlines_ts;
 
+/*
+ * The dataway test is split into steps, so that the periodic
+ * test can be spread over its polling period (by default one step 
+ * every 10 seconds), in between the other polls:
+ *
+ *   step 0: C-line, inhibit and SCC              3
+ *           command lines                       28
+ *           read id register                     1
+ *   step 1: read line tests #1,2 with p24        5
+ *   step 2: write line tests #3,4 with p24     100
+ *   step 3: read line tests #5,6 without p24     5
+ *   step 4: write line tests #7,8 without p24  102
+ *   step 5: read analog voltages                 8
+ *
+ * Each step ends by leaving the test pattern in the DATA register
+ * (one more packet) so the online watch is not upset by the test
+ * between steps. The packets of a step are added to as few packages 
+ * as the MBCD allows, CV_MBCD_MAX_PKTS packets in each.
+ */
+#define CV_MBCD_MAX_PKTS      128
+#define CV_DATAWAY_NUM_STEP   6
+#define CV_DATAWAY_NUM_PKTS   (3 + 2*(CMD_LINE_NUM+1) + 1 + 10 +\
+                               RW_LINE_NUM_TYPE*RW_LINE_NUM*2  +\
+                               RW_LINE_NUM_TYPE*RW_LINE_NUM2*3 +\
+                               CV_NUM_ANLG_CHANNELS + CV_DATAWAY_NUM_STEP)
+#define CV_DATAWAY_MAX_PKG    (CV_DATAWAY_NUM_STEP + CV_DATAWAY_NUM_PKTS/CV_MBCD_MAX_PKTS)
+
 /* 
  * A dataway verification test performs a series of camac functions,
- * whereby a separate camac package has been initialized for each
- * module. 
+ * which are issued as a few large camac packages per module, one 
+ * step at a time. The X and Q responses are checked once the last 
+ * step has completed.
  */
 typedef struct campkg_dataway_s
 {
-
-  campkg_nodata_ts         pulseC_s;     /* clear registers on bus        */
-  campkg_nodata_ts         inhibit_s;    /* clear inhibit line I=0        */
-  campkg_4u_ts             scc_s;        /* set into addressing mode      */
-  campkg_cmd_ts            cmd_s;        /* command line package          */
+  void                    *pkg_p[CV_DATAWAY_MAX_PKG];   /* ptr to camac packages         */
+  unsigned int            *stat_p[CV_DATAWAY_MAX_PKG];  /* last packet status, for trace */
+  unsigned short           npkg;                        /* packages allocated            */
+  unsigned short           npkts;                       /* packets in last package       */
+  unsigned short           stepEnd_a[CV_DATAWAY_NUM_STEP]; /* last package+1 of each step */
+  unsigned short           nstep;                       /* steps built                   */
+  unsigned short           step;                        /* next step to issue, 0=idle    */
+
+  unsigned int             pulseC_stat;  /* clear registers on bus        */
+  unsigned int             inhibit_stat; /* clear inhibit line I=0        */
+  statd_4u_ts              scc_statd_s;  /* set into addressing mode      */
+  campkg_cmd_ts            cmd_s;        /* command line packets          */
+  statd_2u_ts              id_statd_s;   /* read id register              */
   campkg_rwlines_ts        rwlines_s;    /* Read Write lines test         */
+  statd_2_ts               volts_as[CV_NUM_ANLG_CHANNELS]; /* analog voltages  */
+  statd_4u_ts              wt_statd_s;   /* leave pattern in DATA register, each step */
 
   epicsBoolean             init;          /* flag all packages initalized  */
   camac_xq_status_ts       Xstat_s;       /* X-response status             */
@@ -768,8 +932,100 @@ typedef struct camac_block_s
   campkg_volts_ts         rd_volts_s;   /* read voltage package          */
   campkg_init_ts          init_s;       /* crate online watch            */
   campkg_dataway_ts       dataway_s;    /* dataway test packages         */    
+  campkg_nodata_ts        pulseC_s;     /* clear bus after failed R/W test */
 } camac_block_ts;
 
+/******************************************************************************************/
+/*********************          CAMAC Transaction Trace         ***************************/
+/******************************************************************************************/
+
+/* Camac package identifiers, recorded with each camgo() in the trace ring (see CVTrace.c) */
+typedef enum cv_pkg_id_e
+{
+    CV_PKG_RD_VOLTS,          /* rd_volts_s                      */
+    CV_PKG_RD_ID,             /* rd_id_s                         */
+    CV_PKG_RD_DATA,           /* rd_data_s                       */
+    CV_PKG_WT_DATA,           /* wt_data_s                       */
+    CV_PKG_INIT_Z,            /* init_s, Z/inhibit/write pattern */
+    CV_PKG_INIT_RBK,          /* init_s, read back pattern       */
+    CV_PKG_DATAWAY,           /* dataway_s.pkg_p[]               */
+    CV_PKG_PULSE_C            /* pulseC_s, after a failed R/W test */
+} cv_pkg_id_te;
+
+#define CV_NUM_PKG_ID     8
+#define CV_PKG_LABELS \
+    static const char * const cv_pkg_label_ac[CV_NUM_PKG_ID] = { \
+    "RD_VOLTS", "RD_ID",   "RD_DATA", "WT_DATA", "INIT_Z", "INIT_RBK",\
+    "DATAWAY",  "PULSE_C" }
+
+#define CV_TRACE_SIZE        1024     /* trace ring entries, must be a power of 2 */
+#define CV_TRACE_NUM_FREEZE  8        /* max status codes that freeze the trace   */
+
+typedef struct cv_trace_rec_s
+{
+    epicsTimeStamp     start;         /* time camgo() was issued                  */
+    unsigned long      usec;          /* camgo() duration in microseconds         */
+    vmsstat_t          iss;           /* camgo() return status                    */
+    unsigned int       stat;          /* camac status of the checked packet (X/Q) */
+    unsigned char      c;             /* CAMAC crate                              */
+    unsigned char      n;             /* CAMAC slot                               */
+    unsigned char      func_e;        /* cv_camac_func_te                         */
+    unsigned char      pkg_e;         /* cv_pkg_id_te                             */
+} cv_trace_rec_ts;
+
+/******************************************************************************************/
+/*********************           Startup Phase Timers           ***************************/
+/******************************************************************************************/
+
+/*
+ * Time spent in each phase of the IOC startup, in total and per crate,
+ * recorded by CV_BootTimeAdd() and listed by CV_BootShow() (see CVBoot.c).
+ */
+typedef enum cv_boot_phase_e
+{
+    CV_BOOT_START,                   /* CV_Start or CV_StartLoc, whole call         */
+    CV_BOOT_STARTINIT,               /* CV_StartInit, dataway test and init, crate  */
+    CV_BOOT_PKGBUILD,                /* camac package builds, per crate             */
+    CV_BOOT_RECINIT,                 /* record device support init, per crate       */
+    CV_BOOT_ASYNWAIT,                /* CV_ASYN waiting for drvCV_Init              */
+    CV_BOOT_NUM_PHASES
+} cv_boot_phase_te;
+
+#define CV_BOOT_PHASE_LABELS  const char *cv_boot_phase_ac[CV_BOOT_NUM_PHASES] = \
+              {"CV_Start","CV_StartInit","Package build","Record init","Asyn wait"}
+
+typedef struct cv_boot_time_s
+{
+    double             sec;           /* total time in the phase (sec)            */
+    double             max;           /* longest single call (sec)                */
+    unsigned long      count;         /* calls timed                              */
+} cv_boot_time_ts;
+
+/******************************************************************************************/
+/*********************           Warm Restart Snapshot          ***************************/
+/******************************************************************************************/
+
+/*
+ * The state of each crate is saved to a local file every CV_SNAP_PERIOD 
+ * seconds and at IOC exit (see CVSnap.c). At boot, a crate that was 
+ * online and initialized in the snapshot, and whose verifier DATA register
+ * still holds the saved pattern, is initialized without pulsing Z.
+ */
+#define CV_SNAP_VERSION      1
+#define CV_SNAP_PERIOD       300      /* default seconds between saves            */
+#define CV_SNAP_MAX_CRATE    64       /* crates held from the loaded snapshot     */
+#define CV_SNAP_FILE_LEN     128      /* max length of the snapshot file name     */
+
+typedef struct cv_snap_rec_s
+{
+    short              b;             /* CAMAC branch                             */
+    short              c;             /* CAMAC crate                              */
+    short              n;             /* CAMAC slot                               */
+    unsigned short     stat;          /* crate status (stat_u._i)                 */
+    unsigned short     bus_stat;      /* crate bus status (bus_stat_u._i)         */
+    unsigned long      pattern;       /* pattern written to the DATA register     */
+} cv_snap_rec_ts;
+
 /******************************************************************************************/
 /*********************               Crate Bus Status           ***************************/
 /******************************************************************************************/
@@ -840,9 +1096,13 @@ typedef union
 /******************************************************************************************/
 
 /*
- * These bitmasks are used by the PV
+ * These codes are computed by the driver after each operation on
+ * a crate (see CV_StatSumy) and read by the mbbi PV
  *  <device>:STATMSG
  * to provide a worst case status summary
+ *
+ *     field(DTYP, "Crate Verifier")
+ *     field(INP,  "CAMAC_IO - #B0 C1 N1 A0 F0 @STATSUMY")
  */
 #define CRATE_STATSUMY_MASK      0xf
 #define CRATE_STATSUMY_VPWROFF   0  
@@ -936,6 +1196,33 @@ typedef enum cv_crate_flag_e
   CV_CRATENOINIT
 } cv_crate_flag_te;
  
+/* 
+ * Crate health (circuit breaker). After CV_BREAKER_TRIP consecutive
+ * online watches find the crate not responding, the crate is only
+ * probed with a single read of the DATA register, with the interval
+ * between probes doubled after each failed probe up to
+ * CV_BREAKER_MAX_BACKOFF watch periods. Full polling resumes as soon
+ * as a probe succeeds.
+ */
+#define CV_BREAKER_TRIP          3     /* consecutive failed watches to trip  */
+#define CV_BREAKER_MAX_BACKOFF   32    /* max watch periods between probes    */
+
+/* 
+ * Fast watch. A crate with a failed read, a voltage beyond its warning
+ * limits (see cv_volt_limit_ts) or a dataway test error is watched every
+ * CV_FASTWATCH_PERIOD seconds, online check only, until
+ * CV_FASTWATCH_STABLE consecutive watches find it healthy. The
+ * other periodic requests keep their period.
+ */
+#define CV_FASTWATCH_PERIOD      1     /* fast watch period, in seconds       */
+#define CV_FASTWATCH_STABLE      30    /* healthy watches to resume period    */
+
+typedef enum cv_crate_health_e
+{
+  CV_HEALTH_OK,                        /* full polling                        */
+  CV_HEALTH_PROBE                      /* crate offline, probe with backoff   */
+} cv_crate_health_te;
+
 typedef struct cv_crate_online_status_s
 {
        epicsBoolean             z_off;
@@ -943,13 +1230,28 @@ typedef struct cv_crate_online_status_s
        epicsBoolean             idErr;         
 
        unsigned short           first_watch;
+       epicsBoolean             warm;          /* DATA kept since snapshot, no Z */
        unsigned short           reinit;
        unsigned short           nr_reinit;
-       float                    volts_a[CV_NUM_ANLG_CHANNELS];
+       cv_volt_sample_ts        vsample_as[CV_VOLT_NUM_SAMPLE]; /* voltage samples    */
+       volatile unsigned short  vcur;          /* current voltage sample       */
+       cv_volt_limit_ts         vlimit_as[CV_NUM_ANLG_CHANNELS]; /* alarm limits     */
+       dbCommon                *vrec_aps[CV_NUM_ANLG_CHANNELS];  /* ai record, or NULL */
+
+       cv_crate_health_te       health_e;      /* circuit breaker state        */
+       unsigned short           failCnt;       /* consecutive failed watches   */
+       unsigned short           backoff;       /* watch periods between probes */
+       unsigned short           skip;          /* watch periods to next probe  */
+       unsigned long            nprobes;       /* probes issued while offline  */
+       unsigned short           fastCnt;       /* fast watches to go, 0=normal */
+       unsigned long            nfast;         /* times put in fast watch      */
 
        cv_crate_status_tu       stat_u;        /* current crate status         */
        cv_crate_status_tu       prev_stat_u;   /* crate status from last check */
        cv_bus_status_tu         bus_stat_u;    /* current dataway test status  */
+       epicsTimeStamp           okTime;        /* last watch found crate good  */
+       unsigned short           statsumy;      /* summary, CRATE_STATSUMY_xxx  */
+       IOSCANPVT                statsumy_evt_p; /* posted on summary change    */
        epicsMutexId             mlock;        /* Mutex lock                    */ 
 } cv_crate_online_status_ts;
 
@@ -968,23 +1270,46 @@ typedef struct cv_crate_online_status_s
 #define STATSUMY_DATA_ERR        9  
 
 /******************************************************************************************/
-/*********************        Module Information Structure      ***************************/
+/*********************          Crate Status Block PV           ***************************/
 /******************************************************************************************/
 
-typedef struct cv_module_s
+/*
+ * The status of every crate packed in one ULONG waveform, one block per
+ * crate in module list order, so that a client reads a consistent view
+ * of all crates in one transfer. Each block is copied under the crate's
+ * lock. The waveform is posted by the CV_ASYN thread once per tick in
+ * which an online watch completed.
+ *
+ *     field(DTYP, "Crate Verifier Crates")
+ *     field(INP,  "@")
+ *     field(FTVL, "ULONG")
+ *     field(NELM, "<crates * CV_CRATE_BLOCK_NUM>")
+ */
+typedef struct cv_crate_block_s
 {
-    ELLNODE                      node;                          /* Link List Node            */
-    epicsMessageQueueId	         msgQId_ps;                     /* all modules share one Q   */  
+  epicsUInt32  bcn;              /* branch<<16 | crate<<8 | slot          */
+  epicsUInt32  stat;             /* crate status, cv_crate_status_tu      */
+  epicsUInt32  bus_stat;         /* dataway test status, cv_bus_status_tu */
+  epicsUInt32  id;               /* id register                           */
+  epicsUInt32  data;             /* data register                         */
+  epicsUInt32  flag;             /* crate flag, cv_crate_flag_te          */
+  epicsUInt32  okTime;           /* last good watch, sec past EPICS epoch */
+  epicsUInt32  errCode;          /* status of the last online watch       */
+} cv_crate_block_ts;
+
+#define CV_CRATE_BLOCK_NUM  (sizeof(cv_crate_block_ts)/sizeof(epicsUInt32))
 
-    short	     	         b;  	                        /* CAMAC branch              */
-    short	 	         c;	                        /* CAMAC crate               */
-    short		         n;	                        /* CAMAC slot (ie node)      */
-    short                        present;                       /* Module present  X=1       */
-    unsigned long                pattern;                       /* write to data register    */
+/******************************************************************************************/
+/*********************        Module Information Structure      ***************************/
+/******************************************************************************************/
 
-     /* Crate Verifierd data */
-     unsigned long	   id;                                  /* module ID register        */
-     unsigned long         data;                                /* DATA register pattern     */
+/*
+ * Diagnostic buffers filled only by the once-per-minute dataway test and
+ * read by the waveform device support. These are kept out of line so that
+ * the periodic status path does not drag them through the cache.
+ */
+typedef struct cv_module_diag_s
+{
      struct 
      {
           epicsMutexId          mlock;
@@ -1001,29 +1326,81 @@ typedef struct cv_module_s
           unsigned long         expected_data_a[RW_LINE_NUM];  /* expected read write data  */
      } rwLine_s;
 
-     /* Status */
-     cv_crate_online_status_ts   prev_crate_s;              /* previous crate online status */
-     cv_crate_online_status_ts   crate_s;                   /* crate online status          */
-     cv_message_status_ts        mstat_as[MAX_CAMAC_FUNC];                /* message status */
+     struct cv_request_s       *testReq_aps[MAX_CAMAC_FUNC];    /* requests from CVTest      */
+} cv_module_diag_ts;
+
+typedef struct cv_module_s
+{
+    ELLNODE                      node;                          /* Link List Node            */
+
+     /* Status (hot, touched on every periodic request) */
+     cv_crate_online_status_ts   crate_s;                       /* crate online status       */
+     unsigned long	         id;                            /* module ID register        */
+     unsigned long               data;                          /* DATA register pattern     */
+
+    epicsMessageQueueId	         msgQId_ps;                     /* Q of the module's card    */  
+    unsigned short               card;                          /* PSCD card (see CV_CardOf) */
+    short	     	         b;  	                        /* CAMAC branch              */
+    short	 	         c;	                        /* CAMAC crate               */
+    short		         n;	                        /* CAMAC slot (ie node)      */
+    short                        present;                       /* Module present  X=1       */
+    unsigned long                pattern;                       /* write to data register    */
+    unsigned long                ctlw;                          /* camac control word        */
+    cv_volt_lut_ts const        *vlut_ps;                       /* analog conversion table   */
+
+     cv_message_status_ts        mstat_as[MAX_CAMAC_FUNC];      /* message status            */
+     struct cv_request_s        *poll_aps[MAX_CAMAC_FUNC];      /* periodic requests         */
+     dbCommon                   *prec_aps[MAX_CAMAC_FUNC];      /* POLL_ record, or NULL     */
+     struct cv_request_s        *dsup_aps[MAX_CAMAC_FUNC];      /* input record requests     */
 
     /* 
      * Camac package block. The packages for a module and operation are
      * allocated once and reused on subsequent Camac requset.
      */
-     unsigned long               ctlw;           /* camac control word (crate+ slot) */
      camac_block_ts              cam_s;   
 
+     /* Dataway test diagnostics (cold, allocated out of line) */
+     cv_module_diag_ts          *diag_ps;
+
 } cv_module_ts;
 
 typedef cv_module_ts CV_MODULE;
 
+/* Crate verifier module location, as listed for CV_StartLoc() */
+typedef struct cv_module_loc_s
+{
+    short                        b;                             /* CAMAC branch              */
+    short                        c;                             /* CAMAC crate               */
+    short                        n;                             /* CAMAC slot                */
+} cv_module_loc_ts;
+
 /******************************************************************************************/
 /*********************   Device Support Private Data Structure  ***************************/
 /******************************************************************************************/
 
-#define MAX_QUEUED_MSGS         (20)         /* max num of queued msgs                */
-#define CV_MSG_ASYN             "ASYN"       /* message from asyn thread (periodic)   */
-#define CV_MSG_DSUP             "DSUP"       /* message from device support on demand */
+/* 
+ * Requests are held in a pool allocated by CV_Start() and are passed
+ * through the message queue by handle (index into the pool), so the
+ * queue holds many more outstanding requests in the same memory.
+ * The pool is made of one chunk of requests per module.
+ */
+#define MAX_QUEUED_MSGS         (200)        /* max num of queued msgs                */
+#define CV_REQ_PER_MODULE       (32)         /* pool requests reserved per module     */
+#define CV_REQ_MAX_CHUNK        (64)         /* max pool chunks, so max modules       */
+
+typedef unsigned short cv_request_handle_t;  /* index into the request pool           */
+
+/* Message source */
+typedef enum cv_msg_source_e
+{
+    CV_MSG_ASYN,                             /* message from asyn thread (periodic)   */
+    CV_MSG_DSUP,                             /* message from device support on demand */
+    CV_MSG_TEST                              /* message from test functions           */
+} cv_msg_source_te;
+
+#define CV_NUM_MSG_SOURCE       3
+#define CV_MSG_SOURCE \
+    static const char * const cv_msg_source_ac[CV_NUM_MSG_SOURCE] = {"ASYN","DSUP","TEST"}
 
 /* 
  * The private device support is also as the message sent to the queue.
@@ -1034,7 +1411,8 @@ typedef cv_module_ts CV_MODULE;
 typedef struct cv_request_s
 {
     ELLNODE                node;                         /* Link List Node           */
-    char                   source_c[MAX_STRING_LEN];     /* source of message        */
+    cv_request_handle_t    handle;                       /* index in request pool    */
+    cv_msg_source_te       source_e;                     /* source of message        */
     cv_camac_func_te       func_e;                       /* Camac function type      */
 
     CV_MODULE             *module_ps;                    /* ptr to module info       */
@@ -1042,8 +1420,10 @@ typedef struct cv_request_s
     cv_message_status_ts  *mstat_ps;                     /* message status           */
 
     dbCommon              *rec_ps;                       /* ptr to record info       */    
-    short                  a;                            /* camac subaddress code    */
-    short                  f;                            /* camac function code      */
+
+    unsigned long          period;                       /* poll period (sec), 0=off */
+    unsigned long          countdown;                    /* sec until next poll      */
+    volatile epicsBoolean  queued;                       /* handle in the queue      */
  
 } cv_request_ts;
 typedef cv_request_ts CV_REQUEST;
@@ -11,7 +11,8 @@
 
          Threads
          -------
-         *  CV_OpThread       - Processes messages from the queue
+         *  CV_OpThread       - Processes messages from the queue of a PSCD card
+         *  CV_OpActive       - Check that the CV_OP threads are running
 	 *  CV_AsynThread     - Sends asynchronouse messages to the queue
          *  CV_AsynThreadStop - Force the Asynchronous thread to exit
 
@@ -19,16 +20,38 @@
         -------------------
 	*   CV_AddMsg        - Add a request message to the asynronous message linked list.
             CV_ClrMsgStatus  - Message setup, performed prior to sending message to queue
+            CV_RequestAlloc  - Allocate a request message from the request pool
+            CV_SendRequest   - Send a request message handle to the queue
         *   CV_SetMsgStatus  - Message completion, performed after messasge has completed
         *   CV_SendMsgs      - Submit messages from linked list provided to the queue
         *   CV_ProcessMsg    - Process message from the queue
+        *   CV_CrateBreaker  - Probe offline crates with backoff instead of full polling
+        *   CV_CrateBreakerUpdate - Trip the crate circuit breaker after repeated failed watches
+        *   CV_FastWatch     - Watch a suspect crate at the fast watch period
+            CV_FastWatchSet  - Set the fast watch period and stable window (iocsh)
+        *   CV_StatSumy      - Compute the crate summary status (worst case)
+        *   CV_VoltsSevr     - Return the alarm severity of the analog channels
+            CV_VoltLimitUpdate - Take the alarm limits of an analog channel from its ai record
+            CV_VoltLimitSet  - Set the alarm limits of an analog channel (iocsh)
+            CV_PollPeriodSet - Set the polling period of a periodic request
+            CV_PollSet       - Set the polling period by crate and function (iocsh)
+            CV_PollShow      - Display the polling table (iocsh)
 
         Miscellaneous
         ---------------
 	    CV_Start           - Build module list,start threads and init camac bus for each crate
+	    CV_StartLoc        - Same as CV_Start, for the crate verifier locations listed in a string
+         *  CV_StartThreads    - Start threads and init camac bus for each crate in the module list
+         *  CV_SlabAlloc       - Allocate the module slab and request pool
+         *  CV_RequestGrow     - Add a request pool chunk for a module beyond the slab
+         *  CV_ParseLoc        - Parse a crate verifier location string ("B0C3S1,B1C7S1")
          *  CV_StartInit       - Initialize camac crate bus before iocInit
+         *  CV_WarmCheck       - Check if a crate was kept running since the last snapshot
             CV_AddModule       - Add crate verifier module to the module linked list
+         *  CV_CardOf          - Return the PSCD card of a crate
             CV_FindModuleByBCN - Find a crate verifier module in the module linked list 
+            CV_CrateBlockGet   - Copy the status of all crates to a packed waveform buffer
+            CV_CrateBlockEvent - Return the io scan event of the crate status block
             CV_DeviceInit      - Initialize a requeset message 
             CV_SetBusStatus    - Set Camac Crate bus status based on verification test
             CV_SetCrateStatus  - Set Camac Crate status bitmask used as a pv
@@ -37,6 +60,7 @@
         I/O Functions
         ---------------
 	*   CV_ReadVoltage     - Read the crate verifier analog registers (ie. subaddress 0-7)
+	*   CV_VoltsConvert    - Convert the crate verifier analog register data to volts
         *   CV_ReadId          - Read the crate verifier identification register
 	*   CV_ReadData        - Read the crate verifier data register
 	*   CV_WriteData       - Set the crate verifier data register
@@ -51,14 +75,16 @@
 	*   CV_ReadIdInit          - Initalize the Camac package to read the crate verifier identification register
 	*   CV_ReadDataInit        - Initalize the Camac package to read the crate verifier data register
 	*   CV_WriteDataInit       - Initalize the Camac package to set the crate verifier data register
-	*   CV_TestDatawayInit     - Initalize the Camac package to test the Camac crate dataway
-	*   CV_CratePulseCInit     - Initalize the Camac package to clear the Camac crate bus registers (pulse C-Line)
-	*   CV_CrateClrInhibitInit - Initalize the Camac package to clear the Camac crate bus inhibit line (I-line)
-	*   CV_CrateSCCInit        - Initalize the Camac package to reset the Camac crate to addresssing mode
-	*   CV_CrateCmdLineInit    - Initalize the Camac package #1 to test the Camac crate command lines
-	*   CV_CrateCmdInit2       - Initalize the Camac package #2 to test the Camac crate command lines
-	*   CV_CrateRWLineInit     - Initalize the Camac package #1 to test the Camac crate read write lines (ie. test #1-4)
-	*   CV_CrateRWLineInit2    - Initalize the Camac package #2 to test the Camac crate read write lines (ie. test #5-8)
+	*   CV_TestDatawayInit     - Initalize the Camac packages to test the Camac crate dataway
+	*   CV_DatawayPktAdd       - Add a packet to the Camac crate dataway test packages
+	*   CV_DatawayStepEnd      - End a step of the Camac crate dataway test packages
+	*   CV_CratePulseCInit     - Add the packet to clear the Camac crate bus registers (pulse C-Line)
+	*   CV_CrateClrInhibitInit - Add the packet to clear the Camac crate bus inhibit line (I-line)
+	*   CV_CrateSCCInit        - Add the packet to reset the Camac crate to addresssing mode
+	*   CV_CrateCmdLineInit    - Add the packets #1 to test the Camac crate command lines
+	*   CV_CrateCmdInit2       - Add the packets #2 to test the Camac crate command lines
+	*   CV_CrateRWLineInit     - Add the packets #1 to test the Camac crate read write lines (ie. test #1-4)
+	*   CV_CrateRWLineInit2    - Add the packets #2 to test the Camac crate read write lines (ie. test #5-8)
 
 	*   CV_DatawayInitData     - Initalize the dataway test local data
 	*   CV_CheckReadData       - Check the data register data for errors 
@@ -87,31 +113,50 @@
 #include "cam_proto.h"         /* for camalo,camalo_reset,camadd,camio,camgo */
 #include "drvCV_proto.h"
 #include "CVTest_proto.h"
+#include "CVLog_proto.h"
+#include "CVTrace_proto.h"
+#include "CVSnap_proto.h"
+#include "CVVolts_proto.h"
+#include "CVBoot_proto.h"
 
 /* Local Prototypes for EPICS Driver Support Routines */
 static long         drvCV_Init(void);
 static long         drvCV_Report(int level);
 
 /* Local Prototypes for Thread Routines */
-static void         CV_OpThread(void); 
+static void         CV_OpThread(void *card_p); 
+static epicsBoolean CV_OpActive(void);
+static unsigned short CV_CardOf(short branch);
 static void         CV_AsynThread(void);
 static void         CV_StartInit(void);
+static epicsBoolean CV_WarmCheck( CV_MODULE * const module_ps );
+static long         CV_StartThreads(void);
+static void         CV_SlabAlloc( unsigned short num );
+static long         CV_RequestGrow( unsigned short num );
+static long         CV_ParseLoc( char const * const loc_c, cv_module_loc_ts * const loc_as, unsigned short max );
 
 /* Local Prototypes for Message Utilities */
 static void         CV_SetMsgStatus( vmsstat_t status, cv_message_status_ts * const msgstat_ps );
 static void         CV_AddMsg( cv_camac_func_te func_e,
-                               cv_interval_te   interval_e, 
-                               char           * const source_c,
+                               unsigned long    period, 
+                               cv_msg_source_te source_e,
                                CV_MODULE      * const module_ps );
 static void         CV_SendMsgs( ELLLIST * const msgList_p );
 static void         CV_ProcessMsg( CV_REQUEST * const  msgRecv_ps );
+static epicsBoolean CV_CrateBreaker( CV_REQUEST * const msg_ps );
+static void         CV_CrateBreakerUpdate( CV_MODULE * const module_ps );
+static void         CV_FastWatch( CV_MODULE * const module_ps, cv_camac_func_te func_e, long status );
+static void         CV_StatSumy( CV_MODULE * const module_ps );
+static unsigned short CV_VoltsSevr( CV_MODULE * const module_ps, cv_volt_sample_ts const * const sample_ps, 
+                                    unsigned short first, unsigned short last );
 
 /* Local Prototypes for IO Routines */
 static long         CV_ReadVoltage(   CV_MODULE * const module_ps );
+static void         CV_VoltsConvert(  CV_MODULE * const module_ps, statd_2_ts const * const statd_as );
 static long         CV_ReadId(        CV_MODULE * const module_ps );
 static long         CV_ReadData(      CV_MODULE * const module_ps );
 static long         CV_WriteData(     CV_MODULE * const module_ps, unsigned long data );
-static long         CV_TestDataway(   CV_MODULE * const module_ps );
+static long         CV_TestDataway(   CV_MODULE * const module_ps, epicsBoolean slice_e );
 static long         CV_IsCrateOnline( CV_MODULE * const module_ps );
 
 static vmsstat_t    CV_ReadVoltageInit( short b, short c, short n, campkg_volts_ts   * const cam_ps );
@@ -119,11 +164,14 @@ static vmsstat_t    CV_ReadIdInit(      short b, short c, short n, campkg_ts
 static vmsstat_t    CV_ReadDataInit(    short b, short c, short n, campkg_data_ts    * const cam_ps );
 static vmsstat_t    CV_WriteDataInit(   short b, short c, short n, campkg_data_ts    * const cam_ps );
 static vmsstat_t    CV_TestDatawayInit( short b, short c, short n, campkg_dataway_ts * const cam_ps );
-static vmsstat_t    CV_CratePulseCInit( short branch, short crate, short slot , campkg_nodata_ts * const cam_ps );
-static vmsstat_t    CV_CrateClrInhibitInit( short branch, short crate, short slot , campkg_nodata_ts * const cam_ps );
-static vmsstat_t    CV_CrateSCCInit( short branch, short crate, short slot , campkg_4u_ts * const cam_ps );
-static vmsstat_t    CV_CrateCmdLineInit( short branch, short crate, short slot ,  campkg_cmd_ts * const cam_ps );
-static vmsstat_t    CV_CrateCmdInit2( short branch, short crate, short slot , campkg_cmd_ts * const cam_ps );
+static vmsstat_t    CV_DatawayPktAdd( campkg_dataway_ts * const cam_ps, unsigned int ctlw, void * const statd_p,
+                                      unsigned short bcnt, unsigned short emask );
+static vmsstat_t    CV_DatawayStepEnd( short crate, short slot, campkg_dataway_ts * const cam_ps );
+static vmsstat_t    CV_CratePulseCInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps );
+static vmsstat_t    CV_CrateClrInhibitInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps );
+static vmsstat_t    CV_CrateSCCInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps );
+static vmsstat_t    CV_CrateCmdLineInit( short branch, short crate, short slot ,  campkg_dataway_ts * const cam_ps );
+static vmsstat_t    CV_CrateCmdInit2( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps );
 static vmsstat_t    CV_CrateRWLineInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps );
 static vmsstat_t    CV_CrateRWLineInit2( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps );
 static void         CV_DatawayInitData( CV_MODULE * const module_ps );
@@ -139,24 +187,65 @@ static void         CV_SetCrateStatus( CV_MODULE * const module_ps, unsigned sho
 
 /* Global functions */
 long         CV_Start( unsigned long ncrates );
+long         CV_StartLoc( char const * const loc_c );
 CV_MODULE  * CV_AddModule( short b, short c, short n );
 void         CV_AsynThreadStop(void);
+void         CV_PollSet( int crate, char const * const func_c, int period );
+void         CV_PollShow( int crate );
+void         CV_FastWatchSet( int period, int stable );
+void         CV_VoltLimitSet( int ch, double lolo, double low, double high, double hihi );
 
 
 /* Global variables */
 int     CV_DRV_DEBUG = 0;
-extern  struct PSCD_CARD pscd_card;
 struct  drvet drvCV = {2, drvCV_Report, drvCV_Init};
 
 
 /* 
- * All Crate Verifier Camac transactions go thru one PSCD.
- * We have only one task per msgQ that will be needed 
+ * Crate Verifier Camac transactions go thru the PSCD card of the crate.
+ * We have one msgQ and one CV_OP task per card, and the CV_ASYN task.
  */
 static  int                     nmodules = 0;
 static  ELLLIST                 moduleList_s  = {{NULL, NULL}, 0};
-static  ELLLIST                 asynMsgList_as[2] = {{{NULL, NULL}, 0}, {{NULL, NULL}, 0}};
-static  cv_thread_ts            threads_as[CV_NUM_THREADS] = {{NULL,0,0,NULL}, {NULL,0,0,NULL}};
+static  ELLLIST                 asynMsgList_s = {{NULL, NULL}, 0};
+static  cv_thread_ts            threads_as[CV_NUM_THREADS] = {{NULL,0,0,NULL}};
+
+/*
+ * Module slab. CV_Start() allocates the module information for all
+ * crates in one contiguous block (modules first, followed by the cold
+ * diagnostic buffers) so that the periodic status path walks adjacent
+ * memory. Modules added beyond the slab fall back to calloc.
+ */
+static  CV_MODULE              *moduleSlab_ps = NULL;
+static  cv_module_diag_ts      *diagSlab_ps   = NULL;
+static  unsigned short          slabSize      = 0;
+static  unsigned short          slabUsed      = 0;
+
+/* 
+ * Request pool, indexed by the handle sent through the message queue.
+ * The pool is kept in chunks of CV_REQ_PER_MODULE requests, one per
+ * module, so that it can grow for a module added beyond the slab
+ * without moving the requests in use. The chunks of the slab are 
+ * contiguous. The pool lock guards the queued flag of the requests,
+ * which is set by the senders and cleared by the CV_OP threads.
+ */
+static  CV_REQUEST             *reqChunk_aps[CV_REQ_MAX_CHUNK];
+static  unsigned short          reqPoolSize   = 0;
+static  unsigned short          reqPoolUsed   = 0;
+static  epicsMutexId            reqLock       = NULL;
+
+#define CV_REQ_OF(handle)  (&reqChunk_aps[(handle)/CV_REQ_PER_MODULE][(handle)%CV_REQ_PER_MODULE])
+
+/* Fast watch of suspect crates, period 0 = disabled (see CV_FastWatch) */
+static  unsigned long           fastPeriod    = CV_FASTWATCH_PERIOD;
+static  unsigned short          fastStable    = CV_FASTWATCH_STABLE;
+
+/* Alarm limits of the analog channels, until a crate has its ai records */
+static  cv_volt_limit_ts        vlimit_as[CV_NUM_ANLG_CHANNELS] = CV_VOLT_LIMITS;
+
+/* Crate status block, posted once per tick with a completed online watch */
+static  IOSCANPVT               crateEvt_p    = NULL;
+static  volatile epicsBoolean   crateNew      = epicsFalse;
 
 
 /*====================================================
@@ -175,24 +264,15 @@ static  cv_thread_ts            threads_as[CV_NUM_THREADS] = {{NULL,0,0,NULL}, {
        and initalize the message queue id for each module 
        in the linked list.
 
-       -----------------------------------------------
-       Future:  (use string input)
-       The input argument is a string representation of each
-       crate verifier module location. The crate and slot
-       are identified by "CxSy" where x represents the crate number
-       and y represents the slot number. A comma is used to separate
-       multiple crate verifier modules as follows:
- 
-         "C1S1,C2S1,C3S1"
- 
-       The above example, identifies a crate verifier module
-       is crate 1 slot 1, crate 2 slot 1 and crate 3 slot 1.
-       ----------------------------------------------- 
+       This function registers crates 1 to ncrates, in slot 1
+       on branch 0. Use CV_StartLoc() for sparse crate numbers or
+       more than one branch.
         
        There should be only ONE crate verifier module
        per crate, and this modules should be installed
        in slot 1 to provide a comprehensive dataway
-       verification test, which takes place once per minute.
+       verification test, which takes place once per minute
+       by default (see CV_PollSet).
 
        This function performs the following tasks:
          1) creates the linked list
@@ -213,21 +293,115 @@ static  cv_thread_ts            threads_as[CV_NUM_THREADS] = {{NULL,0,0,NULL}, {
 =======================================================*/
 long CV_Start( unsigned long ncrates )
 {
-    long           status     = OK;              /* status return               */  
     short          num        = 0;               /* number of crates            */
     short          branch     = 0;               /* branch number (0,1) ignored */
     short          crate      = 1;               /* crate number                */
     short          slot       = 1;               /* slot number (always=1)      */
-    int            maxMsgs    = MAX_QUEUED_MSGS;
-    unsigned int   stackSize  = 20480;
-    cv_thread_ts  *thread_ps  = &threads_as[CV_OP_THREAD];
+    long           status     = OK;
     CV_MODULE     *module_ps  = NULL;
+    epicsTimeStamp start;
 
-    /* Build module linked list */
+    /* Allocate one slab for all modules, then build module linked list */
+    epicsTimeGetCurrent(&start);
     num = min(ncrates,MAX_CRATE_ADR);
+    CV_SlabAlloc(num);
     for ( ; crate<=num; crate++)
       module_ps = CV_AddModule(branch,crate,slot);
 
+    status = CV_StartThreads();
+    CV_BootTimeAdd(CV_BOOT_START,0,&start);
+    return( status );
+}
+
+/*====================================================
+ 
+  Abs:  Initalization for the Crate Verifiers listed
+  Name: CV_StartLoc
+ 
+  Args:  loc_c                  Crate verifier locations
+          Type: ascii-string    Note: see CV_ParseLoc()
+          Use:  char const * const    
+          Acc:  read-only       
+          Mech: By reference        
+ 
+  Rem: This function is the same as CV_Start(), except that only 
+       the crate verifier modules listed are registered. The 
+       string holds the location of each module, identified by
+       "BwCxSy" where w is the branch (optional, default 0), x is
+       the crate number and y is the slot number. A comma is used
+       to separate multiple crate verifier modules as follows:
+ 
+         "B0C3S1,B1C7S1"
+ 
+       The above example identifies a crate verifier module
+       in crate 3 slot 1 on branch 0 and in crate 7 slot 1 on branch 1.
+       Only the crates listed are polled, so sparse crate numbers do
+       not cost a Camac timeout every cycle.
+
+       Crate numbers must be unique across branches, as the module 
+       is addressed by crate and slot only (see CV_FindModuleByBCN).
+ 
+  Side: This function should be called prior to iocInit, 
+        instead of CV_Start().
+ 
+  Ret:  long
+           OK    - Successful operation
+           ERROR - Location string invalid, nothing registered
+ 
+=======================================================*/
+long CV_StartLoc( char const * const loc_c )
+{
+    cv_module_loc_ts loc_as[MAX_CRATE_ADR];    /* locations parsed              */
+    long           num        = 0;             /* number of modules listed      */
+    unsigned short i          = 0;             /* index counter                 */
+    long           status     = OK;
+    CV_MODULE     *module_ps  = NULL;
+    epicsTimeStamp start;
+
+    epicsTimeGetCurrent(&start);
+    num = CV_ParseLoc(loc_c,loc_as,MAX_CRATE_ADR);
+    if (num<0) return(ERROR);
+
+    /* Allocate one slab for all modules, then build module linked list */
+    CV_SlabAlloc(num);
+    for (i=0; i<num; i++)
+      module_ps = CV_AddModule(loc_as[i].b,loc_as[i].c,loc_as[i].n);
+
+    status = CV_StartThreads();
+    CV_BootTimeAdd(CV_BOOT_START,0,&start);
+    return( status );
+}
+
+/*====================================================
+ 
+  Abs:  Start the Crate Verifier threads
+  Name: CV_StartThreads
+ 
+  Args:  None
+ 
+  Rem: This function is called from CV_Start() and CV_StartLoc(),
+       once the modules have been added to the linked list, to
+       create a message queue and a CV_OP thread for each PSCD card
+       that has crates, the CV_ASYN thread, and to initialize the 
+       camac bus of each crate.
+ 
+  Side: None
+ 
+  Ret:  long
+           OK    - Always
+ 
+=======================================================*/
+static long CV_StartThreads(void)
+{
+    long           status     = OK;              /* status return               */  
+    int            maxMsgs    = MAX_QUEUED_MSGS;
+    unsigned int   stackSize  = 20480;
+    cv_thread_ts  *thread_ps  = NULL;
+    CV_MODULE     *module_ps  = NULL;            /* pointer to registered module   */
+    unsigned short card       = 0;               /* PSCD card                      */
+    epicsBoolean   used_a[CV_MAX_PSCD];          /* card has crates                */
+    char           name_c[16];                   /* CV_OP thread name              */
+
     /*
      * Keep track of the number of modules at this point in case other
      * modules are added after iocInit().
@@ -240,55 +414,248 @@ long CV_Start( unsigned long ncrates )
     }
     errlogSevPrintf(errlogInfo,CV_MODU_MSG,nmodules);
 
-    /* Create message queue */
-    thread_ps->msgQId_ps = epicsMessageQueueCreate( maxMsgs,sizeof(CV_REQUEST));
-    if ( thread_ps->msgQId_ps == NULL)
-    {
-        /* Fail to create messageQ */
-        errlogSevPrintf(errlogFatal,CV_QCREATE_ERR_MSG);
-        epicsThreadSuspendSelf();
-    }
-    else
+    /* Start the message log thread, used by the CV_OP threads to report crate errors */
+    CV_LogInit();
+    CV_TraceInit();
+
+    /* Find the PSCD cards that have crates */
+    for (card=0; card<CV_MAX_PSCD; card++)
+       used_a[card] = epicsFalse;
+    for ( module_ps = (CV_MODULE *)ellFirst(&moduleList_s);
+	  module_ps; 
+          module_ps =(CV_MODULE *)ellNext((ELLNODE *)module_ps) ) 
+       used_a[module_ps->card] = epicsTrue;
+
+    /* Create the message queue and the thread to process it, for each card */
+    for (card=0; card<CV_MAX_PSCD; card++)
     {
-       /* Create thread to process messages from queue */      
-       thread_ps->tid_ps = epicsThreadMustCreate("CV_OP",
-						 epicsThreadPriorityLow,
+       if (!used_a[card]) continue;
+       thread_ps = &threads_as[CV_OP_THREAD_OF(card)];
+       thread_ps->msgQId_ps = epicsMessageQueueCreate( maxMsgs,sizeof(cv_request_handle_t));
+       if ( thread_ps->msgQId_ps == NULL)
+       {
+           /* Fail to create messageQ */
+           errlogSevPrintf(errlogFatal,CV_QCREATE_ERR_MSG);
+           epicsThreadSuspendSelf();
+       }
+       sprintf(name_c,"CV_OP%hu",card);
+       thread_ps->tid_ps = epicsThreadMustCreate(name_c,
+                                                 epicsThreadPriorityLow,
                                                  stackSize,
                                                  (EPICSTHREADFUNC)CV_OpThread,
-                                                 NULL );
-
-       /* Create thread to send periodic (asyn) messages to the queue. */
-       if (thread_ps->tid_ps)
-       {  
-          /* 
-           * Perform initalization of camac crates before iocInit.
-           * This MUST be done after the message queue has been created
-           * so that the device init can be done.
-           */
-           CV_StartInit();
-
-          /* 
-	   * reate the event so that the asyn thread can be woken up  
-	   * by the driver initialization (drvCV_Iinit) after epics
-           * has been started.
-	   */
-           thread_ps = &threads_as[CV_ASYN_THREAD];
-           thread_ps->evtId_ps = epicsEventMustCreate(epicsEventEmpty);
-           thread_ps->tid_ps   = epicsThreadMustCreate("CV_ASYN",
-                                                       epicsThreadPriorityLow,
-                                                       stackSize,
-                                                       (EPICSTHREADFUNC)CV_AsynThread,
-                                                       NULL );       
-           if (!thread_ps->tid_ps)
-             errlogSevPrintf(errlogFatal,CV_THREADFAIL_MSG,"CV_ASYN");
+                                                 (void *)(unsigned long)card );
+       if (!thread_ps->tid_ps)
+       {
+          errlogSevPrintf(errlogFatal,CV_THREADFAIL_MSG,name_c);
+          return(status);
        }
-       else
-         errlogSevPrintf(errlogFatal,CV_THREADFAIL_MSG,"CV_OP");
     }
 
+    /* 
+     * Perform initalization of camac crates before iocInit.
+     * This MUST be done after the message queues have been created
+     * so that the device init can be done.
+     */
+    CV_StartInit();
+
+    /* 
+     * Create the event so that the asyn thread can be woken up  
+     * by the driver initialization (drvCV_Iinit) after epics
+     * has been started.
+     */
+    thread_ps = &threads_as[CV_ASYN_THREAD];
+    thread_ps->evtId_ps = epicsEventMustCreate(epicsEventEmpty);
+    thread_ps->tid_ps   = epicsThreadMustCreate("CV_ASYN",
+                                                epicsThreadPriorityLow,
+                                                stackSize,
+                                                (EPICSTHREADFUNC)CV_AsynThread,
+                                                NULL );       
+    if (!thread_ps->tid_ps)
+      errlogSevPrintf(errlogFatal,CV_THREADFAIL_MSG,"CV_ASYN");
+
     return(status);
 }
 
+/*====================================================
+ 
+  Abs:  Allocate the module slab and request pool
+  Name: CV_SlabAlloc
+ 
+  Args:  num                    Number of modules
+          Type: integer         
+          Use:  unsigned short  
+          Acc:  read-only       
+          Mech: By value        
+ 
+  Rem: This function allocates the module information for all
+       crates in one contiguous block (modules first, followed 
+       by the cold diagnostic buffers), and the request pool
+       chunks of these modules in one block. It is only done once.
+ 
+  Side: None
+ 
+  Ret:  None
+ 
+=======================================================*/
+static void CV_SlabAlloc( unsigned short num )
+{
+    CV_REQUEST     *pool_as = NULL;
+    unsigned short  nchunk  = 0;
+    unsigned short  i       = 0;
+
+    if ((num > 0) && !moduleSlab_ps)
+    {
+      moduleSlab_ps = callocMustSucceed(1,
+                                        num * (sizeof(CV_MODULE) + sizeof(cv_module_diag_ts)),
+                                        "calloc slab for CV_MODULE");
+      diagSlab_ps   = (cv_module_diag_ts *)&moduleSlab_ps[num];
+      slabSize      = num;
+      nchunk        = min(num,CV_REQ_MAX_CHUNK);
+      pool_as       = callocMustSucceed(nchunk * CV_REQ_PER_MODULE,sizeof(CV_REQUEST),
+                                        "calloc pool for CV_REQUEST");
+      for (i=0; i<nchunk; i++)
+        reqChunk_aps[i] = &pool_as[i * CV_REQ_PER_MODULE];
+      reqPoolSize   = nchunk * CV_REQ_PER_MODULE;
+      if (!reqLock) reqLock = epicsMutexMustCreate();
+    }
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Make sure the request pool has a chunk for each module
+  Name: CV_RequestGrow
+ 
+  Args:  num                    Number of modules
+          Type: integer         
+          Use:  unsigned short  
+          Acc:  read-only       
+          Mech: By value        
+ 
+  Rem: This function adds a chunk of CV_REQ_PER_MODULE requests
+       to the pool when the modules outnumber the chunks, which
+       happens for a module added beyond the slab. The requests
+       already in use do not move.
+ 
+  Side: None
+ 
+  Ret:  long
+           OK    - The pool has a chunk for each module
+           ERROR - The pool has CV_REQ_MAX_CHUNK chunks already
+ 
+=======================================================*/
+static long CV_RequestGrow( unsigned short num )
+{
+    unsigned short  nchunk = reqPoolSize / CV_REQ_PER_MODULE;
+
+    if (nchunk >= num) return(OK);
+    if (nchunk >= CV_REQ_MAX_CHUNK) return(ERROR);
+
+    reqChunk_aps[nchunk] = callocMustSucceed(CV_REQ_PER_MODULE,sizeof(CV_REQUEST),
+                                             "calloc pool chunk for CV_REQUEST");
+    reqPoolSize += CV_REQ_PER_MODULE;
+    if (!reqLock) reqLock = epicsMutexMustCreate();
+    return(OK);
+}
+
+/*====================================================
+ 
+  Abs:  Parse the crate verifier location string
+  Name: CV_ParseLoc
+ 
+  Args:  loc_c                  Crate verifier locations
+          Type: ascii-string    Note: "BwCxSy,..." where the
+          Use:  char const * const    branch Bw is optional
+          Acc:  read-only       
+          Mech: By reference        
+
+         loc_as                 Locations parsed
+          Type: array           
+          Use:  cv_module_loc_ts * const
+          Acc:  write access
+          Mech: By reference        
+
+         max                    Size of loc_as
+          Type: integer         
+          Use:  unsigned short  
+          Acc:  read-only       
+          Mech: By value        
+ 
+  Rem: This function parses the comma separated list of crate
+       verifier locations. Letters may be upper or lower case
+       and blanks are ignored. The branch must be 0-3, the crate
+       1-15 and the slot 1-24. A location whose crate is already
+       listed is ignored with a message.
+ 
+  Side: None
+ 
+  Ret:  long
+           number of locations - Successful operation
+           ERROR               - Location string invalid
+ 
+=======================================================*/
+static long CV_ParseLoc( char const * const loc_c, cv_module_loc_ts * const loc_as, unsigned short max )
+{
+    long           num    = 0;       /* number of locations     */
+    long           i      = 0;       /* index counter           */
+    long           val    = 0;       /* number parsed           */
+    short          b      = 0;       /* branch                  */
+    short          c      = 0;       /* crate                   */
+    short          n      = 0;       /* slot                    */
+    char const    *p      = loc_c;   /* parse position          */
+    char          *end_p  = NULL;    /* end of number parsed    */
+    char const    *err_p  = NULL;    /* position of error       */
+
+
+    if (!loc_c) return(ERROR);
+    while (*p && !err_p)
+    {
+       b = 0;
+       c = 0;
+       n = 0;
+       while (isspace((int)*p)) p++;
+       if (toupper((int)*p)=='B')
+       {
+          val = strtol(p+1,&end_p,10);
+          if ((end_p==p+1) || (val<0) || (val>CAMAC_MAX_BRANCH)) { err_p = p; break; }
+          b = (short)val;
+          p = end_p;
+       }
+       if (toupper((int)*p)!='C') { err_p = p; break; }
+       val = strtol(p+1,&end_p,10);
+       if ((end_p==p+1) || (val<1) || (val>MAX_CRATE_ADR)) { err_p = p; break; }
+       c = (short)val;
+       p = end_p;
+       if ((toupper((int)*p)!='S') && (toupper((int)*p)!='N')) { err_p = p; break; }
+       val = strtol(p+1,&end_p,10);
+       if ((end_p==p+1) || (val<1) || (val>CAMAC_MAX_SLOT)) { err_p = p; break; }
+       n = (short)val;
+       p = end_p;
+       while (isspace((int)*p)) p++;
+       if (*p==',') p++;
+       else if (*p) { err_p = p; break; }
+
+       /* Only one crate verifier per crate */
+       for (i=0; (i<num) && (loc_as[i].c!=c); i++);
+       if (i<num)
+          errlogSevPrintf(errlogMinor,CV_LOCDUP_MSG,b,c,n,c);
+       else if (num<max)
+       {
+          loc_as[num].b = b;
+          loc_as[num].c = c;
+          loc_as[num].n = n;
+          num++;
+       }
+    }
+
+    if (err_p) 
+    {
+       errlogSevPrintf(errlogMajor,CV_LOCPARSE_MSG,loc_c,err_p);
+       return(ERROR);
+    }
+    return(num);
+}
+
 /*====================================================
  
   Abs:  Initialize the Message Queue Id for each module
@@ -310,8 +677,12 @@ static void CV_StartInit(void)
 { 
     CV_MODULE   *module_ps = NULL;     /* pointer to registered module   */
     vmsstat_t   iss = CRAT_OKOK;       /* local return status            */
+    epicsTimeStamp start;              /* start of the crate init        */
+
 
 
+     /* Load the crate state saved before the reboot, if any */
+     CV_SnapshotLoad(&moduleList_s);
 
      /* Initialize module in linked list with message queue id. */
      for ( module_ps = (CV_MODULE *)ellFirst(&moduleList_s);
@@ -319,23 +690,90 @@ static void CV_StartInit(void)
            module_ps =(CV_MODULE *)ellNext((ELLNODE *)module_ps) ) 
     {
        /* Initialize the message queue id */
-       module_ps->msgQId_ps = threads_as[CV_OP_THREAD].msgQId_ps;
+       epicsTimeGetCurrent(&start);
+       module_ps->msgQId_ps = threads_as[CV_OP_THREAD_OF(module_ps->card)].msgQId_ps;
        if ( !module_ps->msgQId_ps )
           
 
-       /* Dataway test */
+       /* 
+        * Dataway test, unless the crate was kept running since the
+        * last snapshot. The test pulses C, which would clear the 
+        * modules of a crate that we want to leave undisturbed.
+        * The test also reads the ID register, so read it here for
+        * a warm crate; the id is not kept in the snapshot.
+        */
        CV_ClrMsgStatus( &module_ps->mstat_as[CAMAC_TST_DATAWAY] );
-       iss = CV_TestDataway(module_ps);
+       if ( !CV_WarmCheck(module_ps) )
+          iss = CV_TestDataway(module_ps,epicsFalse);
+       else
+       {
+          CV_ClrMsgStatus( &module_ps->mstat_as[CAMAC_RD_ID] );
+          CV_ReadId(module_ps);
+       }
 
        /* Check crate online status */
        CV_ClrMsgStatus( &module_ps->mstat_as[CAMAC_RD_CRATE_STATUS] );
        iss = CV_IsCrateOnline(module_ps);
+       CV_BootTimeAdd(CV_BOOT_STARTINIT,module_ps->c,&start);
 
     }/* End of module FOR loop */
 
     return;
 }
 
+/*====================================================
+ 
+  Abs:  Check if a crate was kept running since the last snapshot
+ 
+  Name: CV_WarmCheck
+ 
+  Args: module_ps               Module information
+          Type: pointer            
+          Use:  CV_MODULE * const
+          Acc:  read-write access
+          Mech: By reference
+
+  Rem:  The purpose of this function is to decide, at boot,
+        whether a crate can be trusted as initialized. The crate
+        must have been online and initialized in the snapshot
+        saved before the reboot, and a double-read of its verifier
+        DATA register must still return the pattern saved, which 
+        shows that the crate was not power cycled in between.
+
+  Side: For a warm crate, the dataway test status is restored
+        from the snapshot, the ID register is read by CV_StartInit()
+        and the crate is initialized by CV_IsCrateOnline() without 
+        pulsing Z.
+  
+  Ret:  epicsBoolean
+            epicsTrue  - Crate is warm
+            epicsFalse - Crate must be fully initialized
+        
+=======================================================*/ 
+static epicsBoolean CV_WarmCheck( CV_MODULE * const module_ps )
+{
+    cv_snap_rec_ts const *snap_ps = NULL;
+
+
+    module_ps->crate_s.warm = epicsFalse;
+    snap_ps = CV_SnapshotFind(module_ps->b,module_ps->c,module_ps->n);
+    if ( !snap_ps || !module_ps->present                                 ||
+         ((snap_ps->stat & CRATE_STATUS_GOOD) != CRATE_STATUS_GOOD)     || 
+         (snap_ps->pattern != module_ps->pattern) )
+       return(epicsFalse);
+
+    CV_ClrMsgStatus(&module_ps->mstat_as[CAMAC_RD_DATA]);
+    CV_ReadData( module_ps );
+    if ( (module_ps->crate_s.flag_e == CV_CRATEON)                    &&
+         SUCCESS(module_ps->mstat_as[CAMAC_RD_DATA].errCode)           &&
+         !(module_ps->crate_s.stat_u._i & CRATE_STATUS_RDATA_ERR) )
+    {
+       module_ps->crate_s.warm = epicsTrue;
+       module_ps->crate_s.bus_stat_u._i = snap_ps->bus_stat;
+    }
+    return(module_ps->crate_s.warm);
+}
+
 
 /*====================================================
  
@@ -343,24 +781,32 @@ static void CV_StartInit(void)
  
   Name: CV_OpThread
  
-  Args: None
+  Args: card_p                  PSCD card number
+          Type: integer
+          Use:  void *
+          Acc:  read-only
+          Mech: By value
 
   Rem:  The purpose of this thread is to process messages
-        from the message Q and perform Camac transactions.
+        from the message Q of a PSCD card and perform Camac
+        transactions.
 
   Side: This thread process all Camac transactions for
-        the crate verifier modules.
+        the crate verifier modules on its card. There is
+        one such thread per card, so the cards work in
+        parallel.
   
   Ret:  long
             OK - Successfully completed
         
             
 =======================================================*/ 
-static void CV_OpThread(void)
+static void CV_OpThread(void *card_p)
 {
-    int              msgQstat   = 0;                       /* status of message receive  */
-    CV_REQUEST       msgRecv_s ;                           /* message received           */
-    cv_thread_ts    *thread_ps  = &threads_as[CV_OP_THREAD];
+    int                  msgQstat   = 0;                   /* status of message receive  */
+    cv_request_handle_t  handle     = 0;                   /* handle of message received */
+    unsigned short       card       = (unsigned short)(unsigned long)card_p;
+    cv_thread_ts    *thread_ps  = &threads_as[CV_OP_THREAD_OF(card)];
 
 
    /*
@@ -369,13 +815,13 @@ static void CV_OpThread(void)
     * to the log */
    if (thread_ps->msgQId_ps == NULL)
    {
-      errlogSevPrintf(errlogInfo,CV_OPNOQ_MSG);
+      errlogSevPrintf(errlogInfo,CV_OPNOQ_MSG,epicsThreadGetNameSelf());
       return;
    }
 
    /* Indicate that this thread is active!*/
    thread_ps->active = epicsTrue;
-   errlogSevPrintf( errlogInfo,CV_THREADSTART_MSG,"CV_OP",thread_ps->tid_ps );
+   errlogSevPrintf( errlogInfo,CV_THREADSTART_MSG,epicsThreadGetNameSelf(),thread_ps->tid_ps );
 
    /* 
     * Continuously process messages from queue. Exit only
@@ -384,16 +830,20 @@ static void CV_OpThread(void)
    while ( !thread_ps->stop )
    {
       /* Wait for a request message in queue */
-      msgQstat = epicsMessageQueueReceive(thread_ps->msgQId_ps,&msgRecv_s,sizeof(CV_REQUEST));
+      msgQstat = epicsMessageQueueReceive(thread_ps->msgQId_ps,&handle,sizeof(handle));
       if (msgQstat<0)
       {
           /* We should never time out, so something wrong */
   	  errlogSevPrintf(errlogMajor,CV_QTMO_MSG,epicsThreadGetNameSelf(),msgQstat);
 	  thread_ps->stop = epicsTrue;
       } 
-      else 
+      else if (handle < reqPoolUsed)
       {           
-	  CV_ProcessMsg( &msgRecv_s );
+          /* The request may be sent again from now on */
+          epicsMutexMustLock(reqLock);
+          CV_REQ_OF(handle)->queued = epicsFalse;
+          epicsMutexUnlock(reqLock);
+	  CV_ProcessMsg( CV_REQ_OF(handle) );
       }
    } /* End of while statement */
 
@@ -401,10 +851,43 @@ static void CV_OpThread(void)
    epicsMessageQueueDestroy( thread_ps->msgQId_ps );
    thread_ps->msgQId_ps = NULL;
 
-   errlogSevPrintf( errlogInfo,CV_THREADEXIT_MSG,"CV_OP" );
+   errlogSevPrintf( errlogInfo,CV_THREADEXIT_MSG,epicsThreadGetNameSelf() );
    return;
 }
 
+/*====================================================
+ 
+  Abs:  Check that the CV_OP threads are running
+ 
+  Name: CV_OpActive
+ 
+  Args: None
+
+  Rem:  The purpose of this function is to let the asyn
+        thread keep sending its periodic messages while
+        the threads of all cards with crates are running.
+
+  Side: None
+  
+  Ret:  epicsBoolean
+            epicsTrue  - All the CV_OP threads started are active
+            epicsFalse - None started, or one has exited
+            
+=======================================================*/ 
+static epicsBoolean CV_OpActive(void)
+{
+    epicsBoolean    active = epicsFalse;
+    unsigned short  card   = 0;
+
+    for (card=0; card<CV_MAX_PSCD; card++)
+    {
+       if (!threads_as[CV_OP_THREAD_OF(card)].tid_ps) continue;
+       if (!threads_as[CV_OP_THREAD_OF(card)].active) return(epicsFalse);
+       active = epicsTrue;
+    }
+    return(active);
+}
+
 
 /*=============================================================================
 
@@ -414,8 +897,15 @@ static void CV_OpThread(void)
         
   Args: None
 
-  Rem: This thread sends periodic function request to the CV message queue,
-       which is the only task to perform Camac operations.
+  Rem: This thread sends periodic function request to the CV message queue
+       of the crate's PSCD card, whose CV_OP thread is the only task to 
+       perform Camac operations on that card.
+
+       The thread wakes up every CV_ASYN_TICK seconds and sends each
+       periodic request whose polling period has elapsed (see CV_SendMsgs).
+       The periods are set per crate and function, and may be changed
+       at runtime (see CV_PollSet). The dataway test is time-sliced, 
+       each message issues one step of the test (see CV_TestDataway).
 
   Side: None
 
@@ -424,10 +914,8 @@ static void CV_OpThread(void)
 ==============================================================================*/
 static void  CV_AsynThread(void)
 {
-  static const float      nsec         = 10.0;                  /* delay in seconds            */ 
-  float                   max_interval = 60.0;                  /* maximum time interval       */
-  float                   total        = 0;                     /* interval, 0=5sec 1=60sec    */
   cv_thread_ts           *thread_ps    = &threads_as[CV_ASYN_THREAD];
+  epicsTimeStamp          start;
  
 
   /* Indicate that this thread is active!*/
@@ -437,8 +925,10 @@ static void  CV_AsynThread(void)
 
  /* Halt processing of thread until driver initialization has completed */
   errlogSevPrintf( errlogInfo,CV_WAITEVT_MSG,"CV_ASYN" );
+  epicsTimeGetCurrent(&start);
   if ( thread_ps->evtId_ps )
      epicsEventMustWait(thread_ps->evtId_ps);
+  CV_BootTimeAdd(CV_BOOT_ASYNWAIT,0,&start);
 
  /*
   * Event signal received from driver initalization (drvCV_Init) 
@@ -449,26 +939,26 @@ static void  CV_AsynThread(void)
 
  /* start sendind periodic messages to the queue */
   errlogSevPrintf(errlogInfo,CV_ASYNSEND_MSG );
-  while ( !thread_ps->stop && threads_as[CV_OP_THREAD].active && nmodules )
+  while ( !thread_ps->stop && CV_OpActive() && nmodules )
   {
      /* 
-      * Submit all messages that take place every 10 seconds.
+      * Submit all messages whose polling period has elapsed.
       * Note:  CV_OpThread() processes messages from the queue
       */
-      for (total=0.0; total<max_interval; total+=nsec)
-      {
-         CV_SendMsgs( &asynMsgList_as[CV_10SEC] );
+      CV_SendMsgs( &asynMsgList_s );
 
-         /* wait for 5 seconds before sending next */
-         epicsThreadSleep(nsec); 
+      /* Save the crate state for the next boot, once per snapshot period */
+      CV_SnapshotPoll( &moduleList_s );
 
-      }/* End of interval */
+      /* Update the crate status block if an online watch completed */
+      if (crateNew && crateEvt_p)
+      {
+         crateNew = epicsFalse;
+         scanIoRequest( crateEvt_p );
+      }
 
-      /* 
-       * Submit all messages that take place every 60 seconds.
-       * Note: CV_OpThread() processes messages from the queue
-       */
-       CV_SendMsgs( &asynMsgList_as[CV_60SEC] );
+      /* wait one tick before sending next */
+      epicsThreadSleep(CV_ASYN_TICK); 
    
   }/* End of while statement */ 
 
@@ -512,8 +1002,16 @@ void  CV_AsynThreadStop(void)
           Acc:  read-only
           Mech: By value
 
-  Rem: The purpose of this function is to submit all of the messages in the ilst
-       provided, to the message queue.
+  Rem: The purpose of this function is to submit the messages in the list
+       provided, whose polling period has elapsed, to the message queue.
+       Messages with a period of 0 are disabled. Each call is one tick.
+
+       A dataway test message is sent every period/CV_DATAWAY_NUM_STEP
+       seconds, one step of the test each, so the whole test completes
+       once per period.
+
+       The online watch of a crate in fast watch is sent at the fast
+       watch period, if shorter than its own (see CV_FastWatch).
 
   Side: This function is called by the asyn thread, CV_AsynThread()
 
@@ -527,9 +1025,11 @@ static void CV_SendMsgs( ELLLIST * const msgList_ps )
    unsigned long       i_msg     = 0;                       /* message counter             */
    unsigned long       nmsgs     = 0;                       /* # of messages in lined list */  
    cv_camac_func_te    func_e    = CAMAC_INVALID_OP;        /* function reuqest            */
+   unsigned long       period    = 0;                       /* polling period (sec)        */
    CV_REQUEST         *msg_ps    = NULL;                    /* message information         */
    CV_MODULE          *module_ps = NULL;                    /* module information          */
    CV_CAMAC_FUNC;
+   CV_MSG_SOURCE;
  
    
    nmsgs = ellCount( msgList_ps );
@@ -537,15 +1037,30 @@ static void CV_SendMsgs( ELLLIST * const msgList_ps )
         i_msg<nmsgs && msg_ps;
         i_msg++, msg_ps = (CV_REQUEST *)ellNext((ELLNODE *)msg_ps) )
    {
+       /* Has the polling period elapsed? */
+       period = msg_ps->period;
+       if (!period) continue;
+       func_e    = msg_ps->func_e;
        module_ps = msg_ps->module_ps;
+       if ((func_e==CAMAC_RD_CRATE_STATUS) && module_ps->crate_s.fastCnt && fastPeriod)
+          period = min(period,fastPeriod);
+       if (msg_ps->countdown > period) msg_ps->countdown = period;
+       if (msg_ps->countdown && --msg_ps->countdown) continue;
+       if (func_e==CAMAC_TST_DATAWAY)
+          msg_ps->countdown = max(period/CV_DATAWAY_NUM_STEP,1);
+       else
+          msg_ps->countdown = period;
+
+       if (msg_ps->queued) continue;                    /* last poll still pending */
        if (module_ps->msgQId_ps && (CV_DRV_DEBUG!=2))
        {   
-          func_e = msg_ps->func_e;
-          CV_ClrMsgStatus( &module_ps->mstat_as[func_e] );  
-          status = epicsMessageQueueTrySend(module_ps->msgQId_ps,msg_ps,sizeof(CV_REQUEST));
+          /* A time-sliced dataway test keeps its status until the last step */
+          if ((func_e!=CAMAC_TST_DATAWAY) || !module_ps->cam_s.dataway_s.step)
+             CV_ClrMsgStatus( &module_ps->mstat_as[func_e] );  
+          status = CV_SendRequest( msg_ps );
           if ((status==ERROR) && CV_DRV_DEBUG==3)
 	      printf("CV_OP Message queue send error - %s func %s for CV[c=%hd n=%hd]\n",
-                     msg_ps->source_c,
+                     cv_msg_source_ac[msg_ps->source_e],
                      cv_camac_func_as[msg_ps->func_e].func_c,
                      module_ps->c,
                      module_ps->n );                
@@ -580,6 +1095,8 @@ static long drvCV_Init(void)
     long           status    = OK;                          /* status return    */  
     cv_thread_ts  *thread_ps = &threads_as[CV_ASYN_THREAD]; /* Asyn thread info */
 
+    if ( !crateEvt_p )
+       scanIoInit( &crateEvt_p );
     if ( thread_ps->evtId_ps )
        epicsEventSignal( thread_ps->evtId_ps );
     return(status);
@@ -620,6 +1137,7 @@ static long drvCV_Init(void)
          1     Additionally, module list listing branch, crate and slot
          2     Additionally, module id and data register with timestamp of last read.
          3     Additionally, crate voltages and temperatures
+         6     Startup phase timers only (see CV_BootShow)
 
   Side: Report is sent to the standard output device
   
@@ -634,13 +1152,23 @@ static long drvCV_Report(int level)
     unsigned short               first  = 0;
     unsigned short               i      = 0;
     int                          qlevel = 0;
-    statd_2_ts                  *statd_as   = NULL;
+    cv_volt_sample_ts const     *sample_ps  = NULL;
     CV_MODULE                   *module_ps  = NULL;
     campkg_dataway_ts           *dataway_ps = NULL;
-    epicsMessageQueueId         msgQId_ps  = threads_as[CV_OP_THREAD].msgQId_ps;
+    char                         time_c[40];
+    epicsMessageQueueId         msgQId_ps  = NULL;
+    unsigned short               card       = 0;
 
 
     printf("\n"CV_DRV_VER_STRING"\n");
+
+    /* Startup phase timers, instead of the module list */
+    if (level==REPORT_BOOT)
+    {
+       CV_BootShow(0);
+       return(status);
+    }
+
     for( module_ps = (CV_MODULE *)ellFirst(&moduleList_s);
          module_ps; 
 	 module_ps = (CV_MODULE *)ellNext((ELLNODE *)module_ps))
@@ -658,6 +1186,12 @@ static long drvCV_Report(int level)
                    (module_ps->crate_s.stat_u._s.online)?"On ":"Off",                  
                    (module_ps->crate_s.stat_u._s.init)?"Init Done":"Init Failed",   
 		   (module_ps->crate_s.first_watch)?"Yes":"No");
+           if (module_ps->crate_s.health_e==CV_HEALTH_PROBE)
+              printf("\t\tOffline, probing every %hu watch periods (%lu probes)\n",
+                     module_ps->crate_s.backoff, module_ps->crate_s.nprobes);
+           else if (module_ps->crate_s.fastCnt)
+              printf("\t\tFast watch, %hu healthy watches to go (%lu times)\n",
+                     module_ps->crate_s.fastCnt, module_ps->crate_s.nfast);
            break;
 
       case REPORT_DETAILED:
@@ -672,12 +1206,16 @@ static long drvCV_Report(int level)
            {
 	      /* Print task IDs */
               printf("\tAsyn Thread:\t\tTask Id=%p\n",threads_as[CV_ASYN_THREAD].tid_ps);
-              printf("\tOperational Thread:\tTask Id=%p\n",threads_as[CV_OP_THREAD].tid_ps);
-
-	      /* Print the Message Queue IDs */
-	      msgQId_ps = threads_as[CV_OP_THREAD].msgQId_ps;
-              printf("\tMessage Queue (%p): \n\n",msgQId_ps);
-   	      epicsMessageQueueShow(msgQId_ps,qlevel);
+              for (card=0; card<CV_MAX_PSCD; card++)
+              {
+                 if (!threads_as[CV_OP_THREAD_OF(card)].tid_ps) continue;
+                 printf("\tOperational Thread (PSCD %hu):\tTask Id=%p\n",card,threads_as[CV_OP_THREAD_OF(card)].tid_ps);
+
+	         /* Print the Message Queue IDs */
+	         msgQId_ps = threads_as[CV_OP_THREAD_OF(card)].msgQId_ps;
+                 printf("\tMessage Queue (%p): \n\n",msgQId_ps);
+   	         epicsMessageQueueShow(msgQId_ps,qlevel);
+              }
               first = 1;
 	   }            
            break;
@@ -689,15 +1227,18 @@ static long drvCV_Report(int level)
                    module_ps->crate_s.stat_u._i,
                    module_ps->crate_s.prev_stat_u._i);
 
-           /* List Crate Voltages and Temperature */
-           statd_as = module_ps->cam_s.rd_volts_s.statd_as;
-           printf("\t\tCrate Voltages & Temperature: iss=%8.8lX\n",module_ps->mstat_as[CAMAC_RD_VOLTS].errCode);
+           /* List Crate Voltages and Temperature, from the current sample */
+           sample_ps = &module_ps->crate_s.vsample_as[module_ps->crate_s.vcur];
+           epicsTimeToStrftime(time_c,sizeof(time_c),"%H:%M:%S.%03f",&sample_ps->time);
+           printf("\t\tCrate Voltages & Temperature: iss=%8.8lX at %s\n",module_ps->mstat_as[CAMAC_RD_VOLTS].errCode,time_c);
            for (i=0; i<CV_NUM_ANLG_CHANNELS;i++) 
-	     printf("\t\t%s\t%5.2f\t0x%4.4hX\tiss=%8.8X\n",
+	     printf("\t\t%s\t%5.2f\t0x%4.4hX\tiss=%8.8X\tgain=%.5f offset=%.5f\n",
                     vmult_as[i].label_c,
-                    module_ps->crate_s.volts_a[i],
-                    statd_as[i].data,
-                    statd_as[i].stat );
+                    sample_ps->volts_a[i],
+                    sample_ps->raw_a[i],
+                    sample_ps->stat_a[i],
+                    module_ps->vlut_ps->gain_a[i],
+                    module_ps->vlut_ps->offset_a[i] );
            break;
  
       default:
@@ -707,7 +1248,7 @@ static long drvCV_Report(int level)
                   (dataway_ps->cmdLineErr)?"Failed":"Successful");
             for (i=0; i<CMD_LINE_NUM; i++)
 	    {
-	       printf("   0x%8.8lx",module_ps->cmdLine_s.data_a[i]);
+	       printf("   0x%8.8lx",module_ps->diag_ps->cmdLine_s.data_a[i]);
                if (( i%4 )==0) printf("\n\t\t");
 	    }
          
@@ -718,7 +1259,7 @@ static long drvCV_Report(int level)
 	      printf("\n\n\t\tRead Write Lines: Successful\n\t\t");	     
             for (i=0; i<RW_LINE_NUM; i++)
 	    {
-	       printf("   0x%8.8lx",module_ps->rwLine_s.data_a[i]);
+	       printf("   0x%8.8lx",module_ps->diag_ps->rwLine_s.data_a[i]);
                if (( i%4 )==0) printf("\n\t\t");
 	    } 
             printf("\n\n");
@@ -790,6 +1331,92 @@ CV_MODULE * CV_FindModuleByBCN(short branch, short crate, short slot)
     return( found_ps );
 }   
 
+/*====================================================
+ 
+  Abs:  Copy the status of all crates to a packed buffer
+ 
+  Name: CV_CrateBlockGet
+ 
+  Args: val_a                        Waveform buffer
+          Type: array                Note: NULL = size only
+          Use:  epicsUInt32 * const
+          Acc:  write-only
+          Mech: By reference
+
+        nelm                         Number of elements in buffer
+          Type: integer             
+          Use:  unsigned long
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to fill the buffer
+        with one cv_crate_block_ts per module, in module list
+        order, for as many whole blocks as fit. With no buffer,
+        the number of elements for all crates is returned. All
+        the fields of a crate but its location are copied under
+        the crate's lock, so each block is consistent. The id and
+        data registers are stored under the same lock.
+
+  Side: None
+  
+  Ret:  unsigned long
+              Number of elements filled
+            
+=======================================================*/ 
+unsigned long CV_CrateBlockGet( epicsUInt32 * const val_a, unsigned long nelm )
+{
+    CV_MODULE          *module_ps = NULL;
+    cv_crate_block_ts   block_s;
+    unsigned long       nord      = 0;
+ 
+    if (!val_a)
+       return( ellCount(&moduleList_s) * CV_CRATE_BLOCK_NUM );
+    for( module_ps = (CV_MODULE *)ellFirst(&moduleList_s); 
+         module_ps && (nord+CV_CRATE_BLOCK_NUM <= nelm); 
+         module_ps = (CV_MODULE *)ellNext((ELLNODE *)module_ps) )
+    {
+       block_s.bcn     = (module_ps->b<<16) | (module_ps->c<<8) | module_ps->n;
+
+       epicsMutexMustLock( module_ps->crate_s.mlock );
+       block_s.id       = module_ps->id;
+       block_s.data     = module_ps->data;
+       block_s.errCode  = module_ps->mstat_as[CAMAC_RD_CRATE_STATUS].errCode;
+       block_s.stat     = module_ps->crate_s.stat_u._i;
+       block_s.bus_stat = module_ps->crate_s.bus_stat_u._i;
+       block_s.flag     = module_ps->crate_s.flag_e;
+       block_s.okTime   = module_ps->crate_s.okTime.secPastEpoch;
+       epicsMutexUnlock( module_ps->crate_s.mlock );
+
+       memcpy( &val_a[nord], &block_s, sizeof(block_s) );
+       nord += CV_CRATE_BLOCK_NUM;
+    }/* End of FOR looop */
+    return( nord );
+}   
+
+/*====================================================
+ 
+  Abs:  Return the io scan event of the crate status block
+ 
+  Name: CV_CrateBlockEvent
+ 
+  Args: None
+
+  Rem:  The purpose of this function is to return the io
+        scan event posted by the CV_ASYN thread once per tick
+        in which an online watch has completed, for the
+        "I/O Intr" scan of the crate status block waveform.
+
+  Side: None
+  
+  Ret:  IOSCANPVT
+              NULL - drvCV_Init has not been called
+            
+=======================================================*/ 
+IOSCANPVT CV_CrateBlockEvent( void )
+{
+    return( crateEvt_p );
+}   
+
 
 /*====================================================
  
@@ -822,6 +1449,7 @@ static void CV_ProcessMsg(  CV_REQUEST * const  msg_ps  )
     cv_message_status_ts  *mstat_ps     = NULL;
     IOSCANPVT              volts_evt_p  = NULL;
     IOSCANPVT              id_evt_p     = NULL;
+    CV_MSG_SOURCE;
 
 
     if (msg_ps==NULL)
@@ -831,7 +1459,14 @@ static void CV_ProcessMsg(  CV_REQUEST * const  msg_ps  )
     }
 
     if (CV_DRV_DEBUG==2) 
-        printf("...Processing %s request message for camac func(%d)\n",msg_ps->source_c,msg_ps->func_e);
+        printf("...Processing %s request message for camac func(%d)\n",cv_msg_source_ac[msg_ps->source_e],msg_ps->func_e);
+
+    /* 
+     * Periodic requests to a crate that has been found offline
+     * are replaced by a probe with backoff (see CV_CrateBreaker). 
+     */
+    if ((msg_ps->source_e==CV_MSG_ASYN) && CV_CrateBreaker( msg_ps ))
+        return;
 
     /* Process Camac Request */ 
     module_ps = msg_ps->module_ps;                      /* ptr to module info    */
@@ -844,6 +1479,14 @@ static void CV_ProcessMsg(  CV_REQUEST * const  msg_ps  )
          */
         case CAMAC_RD_CRATE_STATUS:
 	    status = CV_IsCrateOnline( module_ps );
+            CV_CrateBreakerUpdate( module_ps );
+            if ((module_ps->crate_s.stat_u._i & CRATE_STATUS_MASK)==CRATE_STATUS_GOOD)
+            {
+               epicsMutexMustLock( module_ps->crate_s.mlock );
+               epicsTimeGetCurrent( &module_ps->crate_s.okTime );
+               epicsMutexUnlock( module_ps->crate_s.mlock );
+            }
+            crateNew = epicsTrue;
 
             /* Process records waiting on an io scan event.*/
             if (mstat_ps && mstat_ps->evt_p) 
@@ -891,63 +1534,846 @@ static void CV_ProcessMsg(  CV_REQUEST * const  msg_ps  )
                scanIoRequest( mstat_ps->evt_p );
             break;
 
-        /* 
-	 * Perform Camac dataway checkout
-	 * CAMC:<loca>:<crate>:BUSTAT
-	 * CAMC:<loca>:<crate>:CMDLINE  
-	 * CAMC:<loca>:<crate>:RWLINE
-	 * CAMC:<loca>:<crate>:RWLINE_PATTERN
-         */
-        case CAMAC_TST_DATAWAY:                   
-            status  = CV_TestDataway( module_ps );
+        /* 
+	 * Perform Camac dataway checkout
+	 * CAMC:<loca>:<crate>:BUSTAT
+	 * CAMC:<loca>:<crate>:CMDLINE  
+	 * CAMC:<loca>:<crate>:RWLINE
+	 * CAMC:<loca>:<crate>:RWLINE_PATTERN
+         */
+        case CAMAC_TST_DATAWAY:                   
+            /* 
+             * Periodic requests issue one step of the test at a time,
+             * the records are processed once the last step is done.
+             */
+            status  = CV_TestDataway( module_ps,(msg_ps->source_e==CV_MSG_ASYN) );
+            if (module_ps->cam_s.dataway_s.step) 
+               break;
+
+            /* Process records waiting on an io scan event.*/
+            if (mstat_ps && mstat_ps->evt_p) 
+	    {
+               scanIoRequest( mstat_ps->evt_p );
+               volts_evt_p = module_ps->mstat_as[CAMAC_RD_VOLTS].evt_p;
+               id_evt_p   =  module_ps->mstat_as[CAMAC_RD_ID].evt_p;
+               if (volts_evt_p) scanIoRequest( volts_evt_p );
+               if (id_evt_p)    scanIoRequest( id_evt_p ); 
+	    }
+  
+           /*
+	    * If this is an on-demand request, from a binary output record
+	    * then make sure to callback the record to finish
+	    * up with post-processing of the record.
+	    */
+            if ( msg_ps->rec_ps && (msg_ps->source_e==CV_MSG_DSUP) )
+            {
+              rec_ps = msg_ps->rec_ps;
+              dbScanLock(rec_ps);
+              (*(rec_ps->rset->process))(rec_ps);
+              dbScanUnlock(rec_ps);
+            }
+	    break;
+
+        /*
+	 * Set pattern in data register 
+	 * MODU:<loca>:<crate><slot>:DATASETPT
+         */
+        case CAMAC_WT_DATA:
+            status   = CV_WriteData( module_ps, module_ps->pattern );
+            if ( msg_ps->rec_ps && (msg_ps->source_e==CV_MSG_DSUP) )
+            {
+              rec_ps = msg_ps->rec_ps;
+              dbScanLock(rec_ps);
+              (*(rec_ps->rset->process))(rec_ps);
+              dbScanUnlock(rec_ps);
+            }
+	    break;
+	   
+        /* Invalid function requested  */
+        default:                 
+	   status = ERROR;
+           errlogSevPrintf(errlogMinor,CV_INVFUNC_MSG,msg_ps->func_e);
+           return;
+
+     } /* End of switch statement */
+
+    /* Update the crate summary, and watch the crate more often while it looks suspect */
+    CV_StatSumy( module_ps );
+    CV_FastWatch( module_ps, msg_ps->func_e, status );
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Crate circuit breaker, probe offline crates
+ 
+  Name: CV_CrateBreaker
+ 
+  Args: msg_ps                    Periodic request message
+          Type: pointer          
+          Use:  CV_REQUEST * const 
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to keep periodic requests
+        from burning Camac timeouts on a crate that has been found
+        offline on repeated watches (see CV_CrateBreakerUpdate).
+
+        While the breaker is open, only the online watch request
+        touches the crate, and only every crate_s.backoff watch
+        periods, as a single double-read of the DATA register.
+        Each failed probe doubles the backoff, up to
+        CV_BREAKER_MAX_BACKOFF. All other periodic requests are
+        completed with CRAT_OFFLINE without Camac access.
+
+        When a probe finds the crate responding, the breaker is
+        closed and the online watch proceeds as normal, which
+        will initialize the crate.
+
+  Side: None
+
+  Ret:  epicsBoolean
+            epicsTrue  - Request completed here, skip processing
+            epicsFalse - Process the request as normal
+            
+=======================================================*/ 
+static epicsBoolean CV_CrateBreaker( CV_REQUEST * const msg_ps )
+{
+    CV_MODULE                 *module_ps = msg_ps->module_ps;
+    cv_crate_online_status_ts *crate_ps  = &module_ps->crate_s;
+    cv_message_status_ts      *mstat_ps  = msg_ps->mstat_ps;
+
+
+    if (crate_ps->health_e==CV_HEALTH_OK) 
+       return(epicsFalse);
+
+    if (msg_ps->func_e==CAMAC_RD_CRATE_STATUS)
+    {
+       if (crate_ps->skip) 
+          crate_ps->skip--;
+       else
+       {
+          /* Probe the crate with one read of the DATA register */
+          crate_ps->nprobes++;
+          CV_ClrMsgStatus(&module_ps->mstat_as[CAMAC_RD_DATA]);
+          CV_ReadData( module_ps );
+          if (crate_ps->flag_e!=CV_CRATEOFF)
+          {
+             /* The crate responded, so resume full polling */
+             crate_ps->health_e = CV_HEALTH_OK;
+             crate_ps->failCnt  = 0;
+             crate_ps->backoff  = 0;
+             return(epicsFalse);
+          }
+          crate_ps->backoff = min(crate_ps->backoff*2,CV_BREAKER_MAX_BACKOFF);
+          crate_ps->skip    = crate_ps->backoff;
+       }
+    }
+
+    /* A dataway test in progress starts over once the crate is back */
+    if (msg_ps->func_e==CAMAC_TST_DATAWAY)
+       module_ps->cam_s.dataway_s.step = 0;
+
+    /* Complete the request as offline and update the records */
+    CV_SetMsgStatus( CRAT_OFFLINE,mstat_ps );
+    if (mstat_ps && mstat_ps->evt_p) 
+       scanIoRequest( mstat_ps->evt_p );
+    return(epicsTrue);
+}
+
+/*====================================================
+ 
+  Abs:  Update the crate circuit breaker after an online watch
+ 
+  Name: CV_CrateBreakerUpdate
+ 
+  Args: module_ps                 Module information       
+          Type: pointer          
+          Use:  CV_MODULE * const 
+          Acc:  read-write
+          Mech: By reference
+
+  Rem:  The purpose of this function is to count consecutive
+        online watches that found the crate not responding
+        (crate timeout), and to open the crate circuit breaker
+        once CV_BREAKER_TRIP has been reached.
+
+  Side: None
+
+  Ret:  None
+            
+=======================================================*/ 
+static void CV_CrateBreakerUpdate( CV_MODULE * const module_ps )
+{
+    cv_crate_online_status_ts *crate_ps = &module_ps->crate_s;
+
+    if (crate_ps->flag_e!=CV_CRATEOFF)
+    {
+       crate_ps->failCnt = 0;
+       return;
+    }
+    if (++crate_ps->failCnt >= CV_BREAKER_TRIP)
+    {
+       crate_ps->health_e = CV_HEALTH_PROBE;
+       crate_ps->backoff  = 1;
+       crate_ps->skip     = 1;
+    }
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Watch a suspect crate at the fast watch period
+ 
+  Name: CV_FastWatch
+ 
+  Args: module_ps                 Module information       
+          Type: pointer          
+          Use:  CV_MODULE * const 
+          Acc:  read-write
+          Mech: By reference
+
+        func_e                    Camac function completed
+          Type: enum
+          Use:  cv_camac_func_te
+          Acc:  read-only
+          Mech: By value
+
+        status                    Completion status of the function
+          Type: integer           
+          Use:  long
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to put a crate in fast
+        watch when a request finds it suspect: a failed read, 
+        an online watch that finds the crate not online and 
+        initialized or with a DATA register error, a voltage or
+        temperature beyond its warning limits, or a dataway test error.
+        In fast watch, the online watch of the crate is sent every
+        fastPeriod seconds by CV_SendMsgs(). Each new suspect result
+        restarts the stable window, and fastStable consecutive
+        healthy online watches return the crate to its own period.
+
+        A crate whose circuit breaker is open is probed with backoff
+        instead (see CV_CrateBreaker), so it leaves fast watch.
+
+  Side: Called by the CV_OP thread of the crate's card, after
+        each request is processed.
+
+  Ret:  None
+            
+=======================================================*/ 
+static void CV_FastWatch( CV_MODULE * const module_ps, cv_camac_func_te func_e, long status )
+{
+    cv_crate_online_status_ts *crate_ps  = &module_ps->crate_s;
+    epicsBoolean               suspect   = epicsFalse;
+
+
+    if (!fastPeriod || (crate_ps->health_e!=CV_HEALTH_OK))
+    {
+       crate_ps->fastCnt = 0;
+       return;
+    }
+
+    switch(func_e)
+    {
+        case CAMAC_RD_CRATE_STATUS:
+            suspect = ((crate_ps->flag_e!=CV_CRATEON) || 
+                       ((crate_ps->stat_u._i & CRATE_STATUS_MASK)!=CRATE_STATUS_GOOD));
+            break;
+
+        case CAMAC_RD_VOLTS:
+            suspect = ((status!=OK) || 
+                       CV_VoltsSevr(module_ps,&crate_ps->vsample_as[crate_ps->vcur],0,CV_NUM_ANLG_CHANNELS-1));
+            break;
+
+        case CAMAC_TST_DATAWAY:
+            /* The test status is complete after its last step */
+            if (module_ps->cam_s.dataway_s.step) 
+               return;
+            suspect = ((status!=OK) || crate_ps->bus_stat_u._i);
+            break;
+
+        default:
+            suspect = (status!=OK);
+            break;
+    }
+
+    if (suspect)
+    {
+       if (!crate_ps->fastCnt)
+       {
+          crate_ps->nfast++;
+          if (CV_DRV_DEBUG) 
+             printf("CV[c=%hd n=%hd] fast watch every %lu sec\n",module_ps->c,module_ps->n,fastPeriod);
+       }
+       crate_ps->fastCnt = fastStable;
+    }
+    else if ((func_e==CAMAC_RD_CRATE_STATUS) && crate_ps->fastCnt)
+    {
+       if (!--crate_ps->fastCnt && CV_DRV_DEBUG)
+          printf("CV[c=%hd n=%hd] fast watch ended\n",module_ps->c,module_ps->n);
+    }
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Compute the crate summary status
+ 
+  Name: CV_StatSumy
+ 
+  Args: module_ps                 Module information       
+          Type: pointer          
+          Use:  CV_MODULE * const 
+          Acc:  read-write
+          Mech: By reference
+
+  Rem:  The purpose of this function is to compute the worst case
+        summary of the crate, a CRATE_STATSUMY_xxx code, from the
+        state kept in the module: the crate status, the dataway test
+        status, the id register and the last voltage sample, checked
+        against the alarm limits of the analog channels. In order:
+
+            Crate power off
+            Bad id
+            Verify init, command line, read-write line and bus errors
+            Voltage, then temperature, alarm
+            Voltage, then temperature, warning
+            X, then Q, response warning
+            Crate online (power on and initialized), or power on
+
+        Last, as CV_Stat did, a crate with the initialized bit but
+        not the online bit is shown as power on, whatever the errors.
+
+        A voltage sample or id register whose last read failed is
+        not checked. The summary io scan event is posted when the
+        code changes.
+
+  Side: Called by the CV_OP thread of the crate's card, after
+        each request is processed, and when the alarm limits of
+        the crate change (see CV_VoltLimitUpdate). The summary
+        is computed and stored under the crate lock.
+
+  Ret:  None
+            
+=======================================================*/ 
+static void CV_StatSumy( CV_MODULE * const module_ps )
+{
+    cv_crate_online_status_ts  *crate_ps   = &module_ps->crate_s;
+    cv_message_status_ts const *mstat_ps   = NULL;
+    cv_volt_sample_ts const    *sample_ps  = NULL;
+    unsigned short              crateOn    = 0;
+    unsigned short              bus_stat   = 0;
+    unsigned short              vsevr      = NO_ALARM;
+    unsigned short              tsevr      = NO_ALARM;
+    unsigned short              sumy       = CRATE_STATSUMY_VPWROFF;
+    epicsBoolean                badId      = epicsFalse;
+
+
+    epicsMutexMustLock(crate_ps->mlock);
+    crateOn  = crate_ps->stat_u._i & CRATE_STATUS_GOOD;
+    bus_stat = crate_ps->bus_stat_u._i & BUS_STATUS_MASK;
+
+    /* Id register, as the id record alarm limits (crate +/- 1) */
+    mstat_ps = &module_ps->mstat_as[CAMAC_RD_ID];
+    badId    = ((module_ps->id!=module_ps->c) || (mstat_ps->opDone && !SUCCESS(mstat_ps->errCode)));
+
+    /* Voltage and temperature severity of the last good sample */
+    mstat_ps  = &module_ps->mstat_as[CAMAC_RD_VOLTS];
+    sample_ps = &crate_ps->vsample_as[crate_ps->vcur];
+    if (sample_ps->time.secPastEpoch && !(mstat_ps->opDone && !SUCCESS(mstat_ps->errCode)))
+    {
+       vsevr = CV_VoltsSevr(module_ps,sample_ps,0,CV_TEMP_SUBADDR-1);
+       tsevr = CV_VoltsSevr(module_ps,sample_ps,CV_TEMP_SUBADDR,CV_TEMP_SUBADDR);
+    }
+
+    if (!crateOn)
+       sumy = CRATE_STATSUMY_VPWROFF;
+    else if (badId)
+       sumy = CRATE_STATSUMY_BADID;
+
+    /* Data verification errors */
+    else if (bus_stat & BUS_STATUS_INIT_ERR)
+       sumy = CRATE_STATSUMY_INITERR;
+    else if (bus_stat & BUS_STATUS_CMD_ERR)
+       sumy = CRATE_STATSUMY_CMDERR;
+    else if (bus_stat & BUS_STATUS_RW_ERR)
+       sumy = CRATE_STATSUMY_RWERR;
+    else if (bus_stat & BUS_STATUS_BUS_ERR)
+       sumy = CRATE_STATSUMY_BUSERR;
+
+    /* Voltage and Temperature errors, then warnings */
+    else if (vsevr==MAJOR_ALARM)
+       sumy = CRATE_STATSUMY_VOLTERR;
+    else if (tsevr==MAJOR_ALARM)
+       sumy = CRATE_STATSUMY_TEMPERR;
+    else if (vsevr==MINOR_ALARM)
+       sumy = CRATE_STATSUMY_VOLTWARN;
+    else if (tsevr==MINOR_ALARM)
+       sumy = CRATE_STATSUMY_TEMPWARN;
+
+    /* Dataway verification test warnings */
+    else if (bus_stat & (BUS_STATUS_X_ERR | BUS_STATUS_NOX_ERR))
+       sumy = CRATE_STATSUMY_XWARN;
+    else if (bus_stat & (BUS_STATUS_Q_ERR | BUS_STATUS_NOQ_ERR))
+       sumy = CRATE_STATSUMY_QWARN;
+    else if (crateOn==CRATE_STATUS_GOOD)
+       sumy = CRATE_STATSUMY_ONINIT;
+    else
+       sumy = CRATE_STATSUMY_VPWRON;
+
+    /* Initialized but not online overrides the errors */
+    if (crateOn==CRATE_STATUS_ONINIT)
+       sumy = CRATE_STATSUMY_VPWRON;
+
+    if (sumy!=crate_ps->statsumy)
+    {
+       crate_ps->statsumy = sumy;
+       if (crate_ps->statsumy_evt_p)
+          scanIoRequest( crate_ps->statsumy_evt_p );
+    }
+    epicsMutexUnlock(crate_ps->mlock);
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Return the alarm severity of the analog channels
+ 
+  Name: CV_VoltsSevr
+ 
+  Args: module_ps                 Module information
+          Type: pointer          
+          Use:  CV_MODULE * const 
+          Acc:  read-only
+          Mech: By reference
+
+        sample_ps                 Voltage sample
+          Type: pointer          
+          Use:  cv_volt_sample_ts const * const
+          Acc:  read-only
+          Mech: By reference
+
+        first                     First analog channel
+          Type: integer           Note: 0-7
+          Use:  unsigned short
+          Acc:  read-only
+          Mech: By value
+
+        last                      Last analog channel
+          Type: integer           Note: 0-7
+          Use:  unsigned short
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to return the highest
+        alarm severity of the channels first to last of the 
+        sample, against the alarm limits of each channel of
+        the crate, as taken from its ai records.
+
+  Side: The limits are read under the crate lock.
+
+  Ret:  unsigned short
+            NO_ALARM, MINOR_ALARM or MAJOR_ALARM
+            
+=======================================================*/ 
+static unsigned short CV_VoltsSevr( CV_MODULE * const module_ps, cv_volt_sample_ts const * const sample_ps, 
+                                    unsigned short first, unsigned short last )
+{
+    cv_volt_limit_ts const *limit_ps = NULL;
+    unsigned short          sevr     = NO_ALARM;
+    unsigned short          ch       = 0;
+    float                   volts    = 0.0;
+
+
+    epicsMutexMustLock(module_ps->crate_s.mlock);
+    for (ch=first; (ch<=last) && (ch<CV_NUM_ANLG_CHANNELS) && (sevr!=MAJOR_ALARM); ch++)
+    {
+       limit_ps = &module_ps->crate_s.vlimit_as[ch];
+       if (!limit_ps->lolo && !limit_ps->low && !limit_ps->high && !limit_ps->hihi) 
+          continue;
+       volts = sample_ps->volts_a[ch];
+       if ((volts >= limit_ps->hihi) || (volts <= limit_ps->lolo))
+          sevr = MAJOR_ALARM;
+       else if ((volts >= limit_ps->high) || (volts <= limit_ps->low))
+          sevr = MINOR_ALARM;
+    }
+    epicsMutexUnlock(module_ps->crate_s.mlock);
+    return(sevr);
+}
+
+/*====================================================
+ 
+  Abs:  Take the alarm limits of an analog channel from its ai record
+ 
+  Name: CV_VoltLimitUpdate
+ 
+  Args: module_ps                 Module information
+          Type: pointer          
+          Use:  CV_MODULE * const 
+          Acc:  read-write
+          Mech: By reference
+
+        ch                        Analog channel (subaddress)
+          Type: integer           Note: 0-7
+          Use:  unsigned short
+          Acc:  read-only
+          Mech: By value
+
+        lolo, low, high, hihi     Alarm limits of the record
+          Type: float
+          Use:  double
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to keep the limits used
+        for the crate summary and fast watch equal to those of
+        the ai record of the channel. It is called by the ai
+        device support when the record is initialized and each
+        time it is processed, so a limit changed over CA is 
+        used from the record's next processing. The summary is
+        recomputed when a limit has changed.
+
+  Side: None
+
+  Ret:  None
+            
+=======================================================*/ 
+void CV_VoltLimitUpdate( CV_MODULE * const module_ps, unsigned short ch, 
+                         double lolo, double low, double high, double hihi )
+{
+    cv_volt_limit_ts  *limit_ps = NULL;
+    epicsBoolean       changed  = epicsFalse;
+
+
+    if (!module_ps || (ch>=CV_NUM_ANLG_CHANNELS)) return;
+    limit_ps = &module_ps->crate_s.vlimit_as[ch];
+    epicsMutexMustLock(module_ps->crate_s.mlock);
+    if ((limit_ps->lolo!=(float)lolo) || (limit_ps->low !=(float)low) ||
+        (limit_ps->high!=(float)high) || (limit_ps->hihi!=(float)hihi))
+    {
+       limit_ps->lolo = lolo;
+       limit_ps->low  = low;
+       limit_ps->high = high;
+       limit_ps->hihi = hihi;
+       changed = epicsTrue;
+    }
+    epicsMutexUnlock(module_ps->crate_s.mlock);
+    if (changed) CV_StatSumy( module_ps );
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Set the alarm limits of an analog channel
+ 
+  Name: CV_VoltLimitSet
+ 
+  Args: ch                        Analog channel (subaddress)
+          Type: integer           Note: 0-7
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+        lolo                      Low alarm limit
+          Type: float
+          Use:  double
+          Acc:  read-only
+          Mech: By value
+
+        low                       Low warning limit
+          Type: float
+          Use:  double
+          Acc:  read-only
+          Mech: By value
+
+        high                      High warning limit
+          Type: float
+          Use:  double
+          Acc:  read-only
+          Mech: By value
+
+        hihi                      High alarm limit
+          Type: float
+          Use:  double
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to set, for all crates,
+        the limits of an analog channel. The LOLO, LOW, HIGH and
+        HIHI fields of the ai record of the channel are written,
+        so the record and the crate summary use the same limits,
+        and the limits of crates with no record are set directly.
+        The summary of each crate is recomputed. All limits 0 
+        disables the checks of the channel.
+
+  Side: Modules added later start with these limits.
+
+  Ret:  None
+            
+=======================================================*/ 
+void CV_VoltLimitSet( int ch, double lolo, double low, double high, double hihi )
+{
+    CV_VOLT_LABEL;
+    static char const *field_ac[] = {"LOLO","LOW","HIGH","HIHI"};
+    double             val_a[4];
+    CV_MODULE         *module_ps = NULL;
+    DBADDR             addr;
+    char               name_c[PVNAME_STRINGSZ+8];
+    int                i;
+
+
+    if ((ch<0) || (ch>=CV_NUM_ANLG_CHANNELS) || (lolo>low) || (low>high) || (high>hihi))
+    {
+       printf("CV_VoltLimitSet: channel 0-%d, lolo <= low <= high <= hihi required\n",
+              CV_NUM_ANLG_CHANNELS-1);
+       return;
+    }
+    vlimit_as[ch].lolo = lolo;
+    vlimit_as[ch].low  = low;
+    vlimit_as[ch].high = high;
+    vlimit_as[ch].hihi = hihi;
+    val_a[0] = lolo;
+    val_a[1] = low;
+    val_a[2] = high;
+    val_a[3] = hihi;
+
+    for( module_ps = (CV_MODULE *)ellFirst(&moduleList_s);
+         module_ps; 
+	 module_ps = (CV_MODULE *)ellNext((ELLNODE *)module_ps))
+    {
+       /* The record's device support passes the new limits on when it processes */
+       if (module_ps->crate_s.vrec_aps[ch])
+       {
+          for (i=0; i<4; i++)
+          {
+             sprintf(name_c,"%s.%s",module_ps->crate_s.vrec_aps[ch]->name,field_ac[i]);
+             if (dbNameToAddr(name_c,&addr) || dbPutField(&addr,DBR_DOUBLE,&val_a[i],1))
+                printf("CV_VoltLimitSet: failed to set %s\n",name_c);
+          }
+       }
+       CV_VoltLimitUpdate(module_ps,ch,lolo,low,high,hihi);
+    }
+    printf("CV %s limits LOLO %g LOW %g HIGH %g HIHI %g\n",vlabel_a[ch],lolo,low,high,hihi);
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Set the fast watch period and stable window
+ 
+  Name: CV_FastWatchSet
+ 
+  Args: period                    Fast watch period, in seconds
+          Type: integer           Note: 0 = fast watch disabled
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+        stable                    Consecutive healthy online watches
+          Type: integer           to end the fast watch of a crate
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to tune the fast watch
+        of suspect crates from the shell (see CV_FastWatch). The
+        defaults are CV_FASTWATCH_PERIOD and CV_FASTWATCH_STABLE.
+
+  Side: None
+
+  Ret:  None
+            
+=======================================================*/ 
+void CV_FastWatchSet( int period, int stable )
+{
+    if ((period<0) || (period>CV_POLL_MAX_PERIOD) || (stable<1) || (stable>CV_POLL_MAX_PERIOD))
+    {
+       printf("CV_FastWatchSet: period 0 (off) to %d sec, stable 1 to %d watches\n",
+              CV_POLL_MAX_PERIOD,CV_POLL_MAX_PERIOD);
+       return;
+    }
+    fastPeriod = (unsigned long)period;
+    fastStable = (unsigned short)stable;
+    if (fastPeriod)
+       printf("CV fast watch every %lu sec, until %hu healthy watches\n",fastPeriod,fastStable);
+    else
+       printf("CV fast watch disabled\n");
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Set the polling period of a periodic request
+ 
+  Name: CV_PollPeriodSet
+ 
+  Args: msg_ps                    Periodic request message
+          Type: pointer           Note: from module_ps->poll_aps[]
+          Use:  CV_REQUEST * const 
+          Acc:  read-write
+          Mech: By reference
+
+        period                    Polling period, in seconds
+          Type: integer           Note: 0 = disabled
+          Use:  long
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to change the polling
+        period of a periodic request at runtime. The period is
+        limited to CV_POLL_MAX_PERIOD seconds. A shorter period
+        takes effect on the next tick of the asyn thread, a longer
+        one after the next poll.
+
+  Side: None
+
+  Ret:  long
+            OK    - Operation successful
+            ERROR - Not a periodic request, or period invalid
+            
+=======================================================*/ 
+long CV_PollPeriodSet( CV_REQUEST * const msg_ps, long period )
+{
+    if (!msg_ps || (msg_ps->source_e!=CV_MSG_ASYN) || (period<0)) 
+       return(ERROR);
+    msg_ps->period = min((unsigned long)period,CV_POLL_MAX_PERIOD);
+    return(OK);
+}
+
+/*====================================================
+ 
+  Abs:  Set the polling period by crate and function
+ 
+  Name: CV_PollSet
+ 
+  Args: crate                     Camac Crate Number
+          Type: integer           Note: 0 = all crates
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+        func_c                    Function name: VOLTS, STAT,
+          Type: ascii-string      DATA or VERIFY (dataway test)
+          Use:  char const * const  Note: NULL or "" = all functions
+          Acc:  read-only
+          Mech: By reference
+
+        period                    Polling period, in seconds
+          Type: integer           Note: 0 = disabled
+          Use:  int
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to set the polling period
+        of the periodic requests from the shell, for example to watch
+        a critical crate every second and a spare crate every 
+        5 minutes. It may be called before or after iocInit, but
+        only after the modules have been added by CV_Start().
+
+        The POLL_ longout records are the source of truth for the
+        period (they are saved and restored by autosave). Once a 
+        record is initialized, the new period is written to it with
+        dbPutField(), so that its value is posted and saved, and the
+        record passes it on to the driver. Before iocInit, the period
+        is only a default for records without a restored value.
+
+  Side: None
+
+  Ret:  None
+            
+=======================================================*/ 
+void CV_PollSet( int crate, char const * const func_c, int period )
+{
+    CV_CAMAC_FUNC;
+    unsigned short   i_func    = 0;    /* function index          */
+    unsigned short   nset      = 0;    /* periods set             */
+    long             val       = period;
+    DBADDR           addr;             /* POLL_ record address    */
+    CV_MODULE       *module_ps = NULL; /* module information      */
+
+
+    if ((period<0) || (period>CV_POLL_MAX_PERIOD))
+    {
+       printf("CV_PollSet: period %d sec invalid, 0 (off) to %d sec\n",period,CV_POLL_MAX_PERIOD);
+       return;
+    }
+    for( module_ps = (CV_MODULE *)ellFirst(&moduleList_s);
+         module_ps; 
+         module_ps = (CV_MODULE *)ellNext((ELLNODE *)module_ps))
+    {
+       if (crate && (module_ps->c!=crate)) continue;
+       for (i_func=CAMAC_RD_VOLTS; i_func<MAX_CAMAC_FUNC; i_func++)
+       {
+          if (!module_ps->poll_aps[i_func]) continue;
+          if (func_c && func_c[0] && strcmp(func_c,cv_camac_func_as[i_func-1].func_c)) continue;
+          if (module_ps->prec_aps[i_func])
+          {
+             if (dbNameToAddr(module_ps->prec_aps[i_func]->name,&addr) || 
+                 dbPutField(&addr,DBR_LONG,&val,1))
+                printf("CV_PollSet: failed to set %s\n",module_ps->prec_aps[i_func]->name);
+             else
+                nset++;
+          }
+          else if (CV_PollPeriodSet(module_ps->poll_aps[i_func],period)==OK) 
+             nset++;
+       }
+    }
+    if (!nset)
+       printf("CV_PollSet: no periodic request for crate %d function %s\n",
+              crate,(func_c && func_c[0])?func_c:"(all)");
+    return;
+}
+
+/*====================================================
+ 
+  Abs:  Display the polling table
+ 
+  Name: CV_PollShow
+ 
+  Args: crate                     Camac Crate Number
+          Type: integer           Note: 0 = all crates
+          Use:  int
+          Acc:  read-only
+          Mech: By value
 
-            /* Process records waiting on an io scan event.*/
-            if (mstat_ps && mstat_ps->evt_p) 
-	    {
-               scanIoRequest( mstat_ps->evt_p );
-               volts_evt_p = module_ps->mstat_as[CAMAC_RD_VOLTS].evt_p;
-               id_evt_p   =  module_ps->mstat_as[CAMAC_RD_ID].evt_p;
-               if (volts_evt_p) scanIoRequest( volts_evt_p );
-               if (id_evt_p)    scanIoRequest( id_evt_p ); 
-	    }
-  
-           /*
-	    * If this is an on-demand request, from a binary output record
-	    * then make sure to callback the record to finish
-	    * up with post-processing of the record.
-	    */
-            if ( msg_ps->rec_ps && strlen(msg_ps->source_c) && (strcmp("DSUP",msg_ps->source_c)==0))
-            {
-              rec_ps = msg_ps->rec_ps;
-              dbScanLock(rec_ps);
-              (*(rec_ps->rset->process))(rec_ps);
-              dbScanUnlock(rec_ps);
-            }
-	    break;
+  Rem:  The purpose of this function is to list the polling
+        period of each periodic request, by crate and function.
 
-        /*
-	 * Set pattern in data register 
-	 * MODU:<loca>:<crate><slot>:DATASETPT
-         */
-        case CAMAC_WT_DATA:
-            status   = CV_WriteData( module_ps, module_ps->pattern );
-            if ( msg_ps->rec_ps && strlen(msg_ps->source_c) && (strcmp("DSUP",msg_ps->source_c)==0))
-            {
-              rec_ps = msg_ps->rec_ps;
-              dbScanLock(rec_ps);
-              (*(rec_ps->rset->process))(rec_ps);
-              dbScanUnlock(rec_ps);
-            }
-	    break;
-	   
-        /* Invalid function requested  */
-        default:                 
-	   status = ERROR;
-           errlogSevPrintf(errlogMinor,CV_INVFUNC_MSG,msg_ps->func_e);
-           break;
+  Side: Output is sent to the standard output device
 
-     } /* End of switch statement */
+  Ret:  None
+            
+=======================================================*/ 
+void CV_PollShow( int crate )
+{
+    CV_CAMAC_FUNC;
+    unsigned short   i_func    = 0;    /* function index          */
+    CV_REQUEST      *msg_ps    = NULL; /* periodic request        */
+    CV_MODULE       *module_ps = NULL; /* module information      */
 
+
+    printf("CV polling table (sec, 0=off), tick %.1f sec\n",CV_ASYN_TICK);
+    for( module_ps = (CV_MODULE *)ellFirst(&moduleList_s);
+         module_ps; 
+         module_ps = (CV_MODULE *)ellNext((ELLNODE *)module_ps))
+    {
+       if (crate && (module_ps->c!=crate)) continue;
+       printf("\tCV Module[b%d c%d n%d]:",module_ps->b,module_ps->c,module_ps->n);
+       for (i_func=CAMAC_RD_VOLTS; i_func<MAX_CAMAC_FUNC; i_func++)
+       {
+          msg_ps = module_ps->poll_aps[i_func];
+          if (msg_ps) 
+             printf(" %s=%lu",cv_camac_func_as[i_func-1].func_c,msg_ps->period);
+       }
+       if (module_ps->cam_s.dataway_s.step)
+          printf(" (dataway step %hu/%d)",module_ps->cam_s.dataway_s.step,CV_DATAWAY_NUM_STEP);
+       if (module_ps->crate_s.fastCnt && fastPeriod)
+          printf(" (fast watch %lu sec)",fastPeriod);
+       printf("\n");
+    }
     return;
 }
 
@@ -1006,43 +2432,90 @@ CV_MODULE * CV_AddModule( short branch, short crate, short slot )
        printf("Add Module CV[b=%d,c=%d,n=%d]\n",branch,crate,slot);
 
     /* 
-     * This module is not in the list so allocate module information structure..
+     * Each module needs its requests, for its periodic messages
+     * and records. Do not add a module the pool cannot serve.
+     */
+    if (CV_RequestGrow(ellCount(&moduleList_s)+1) != OK)
+    {
+      errlogSevPrintf(errlogFatal,CV_REQGROW_MSG,CV_REQ_MAX_CHUNK,branch,crate,slot);
+      return(module_ps);
+    }
+
+    /* 
+     * This module is not in the list so take the module information
+     * structure from the slab, or allocate it if the slab is used up.
      */
-    module_ps = callocMustSucceed(1,sizeof(CV_MODULE), "calloc buffer for CV_MODULE");
+    if (slabUsed < slabSize)
+    {
+      module_ps          = &moduleSlab_ps[slabUsed];
+      module_ps->diag_ps = &diagSlab_ps[slabUsed];
+      slabUsed++;
+    }
+    else
+    {
+      module_ps          = callocMustSucceed(1,sizeof(CV_MODULE), "calloc buffer for CV_MODULE");
+      module_ps->diag_ps = callocMustSucceed(1,sizeof(cv_module_diag_ts), "calloc buffer for cv_module_diag_ts");
+    }
   
    /* Populate structure with basic info */
-    module_ps->msgQId_ps = threads_as[CV_OP_THREAD].msgQId_ps;
+    module_ps->card      = CV_CardOf(branch);
+    module_ps->msgQId_ps = threads_as[CV_OP_THREAD_OF(module_ps->card)].msgQId_ps;
     module_ps->b         = branch;                        /* SLAC system does not use branch */
     module_ps->c         = crate & CAMAC_CRATE_MASK;
     module_ps->n         = slot  & CAMAC_SLOT_MASK;
     module_ps->ctlw      = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc);
     module_ps->pattern   = CV_DATA_PATTERN;
+    module_ps->vlut_ps   = CV_VoltsLutDefault();          /* until calibrated                */
+    memcpy(module_ps->crate_s.vlimit_as,vlimit_as,sizeof(vlimit_as));  /* until the ai records init */
     module_ps->present   = epicsTrue;  
-    module_ps->crate_s.mlock   = epicsMutexMustCreate();    /* used to lock flag_e and stat_u */
-    module_ps->cmdLine_s.mlock = epicsMutexMustCreate();    /* cmdLine_s */
-    module_ps->rwLine_s.mlock  = epicsMutexMustCreate();    /* rwLine_s  */
+    module_ps->crate_s.mlock   = epicsMutexMustCreate();    /* used to lock flag_e, stat_u, id and data */
+    module_ps->diag_ps->cmdLine_s.mlock = epicsMutexMustCreate();    /* cmdLine_s */
+    module_ps->diag_ps->rwLine_s.mlock  = epicsMutexMustCreate();    /* rwLine_s  */
     module_ps->crate_s.first_watch = 1;
 
     if(CV_DRV_DEBUG) 
       printf("CV module present [c=%hd,n=%hd]\n",module_ps->c,module_ps->n);
 
-    /*
-     * Initialize locks so that both CV_AsynThread() and device support 
-     * can write to cv_message_status_ts (i.e. mstat_s)
-     */
-    for (i=0; (i<MAX_CAMAC_FUNC); i++)
-       module_ps->mstat_as[i].mlock = epicsMutexMustCreate();
-
     /* Now, add the new module to the linked list. */
     ellAdd(&moduleList_s, (ELLNODE *)module_ps);
 
-    /* Add message to the proper processing list (ie. by interval) */
+    /* Add the periodic messages, with the default polling period */
     for (i=0; i<CV_NUM_ASYN_FUNC; i++)
-      CV_AddMsg(asynMsgs_as[i].func_e,asynMsgs_as[i].interval_e,"ASYN",module_ps);
+      CV_AddMsg(asynMsgs_as[i].func_e,asynMsgs_as[i].period,CV_MSG_ASYN,module_ps);
 
     return(module_ps);
 }
 
+/*====================================================
+ 
+  Abs:  Return the PSCD card of a crate
+ 
+  Name: CV_CardOf
+ 
+  Args: branch                    Crate branch
+          Type: value             Note: 0-3            
+          Use:  short 
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to assign a crate to
+        the PSCD card that serves it, which selects the queue
+        and the CV_OP thread of its requests. drvPSCD drives
+        a single card (pscd_card) that serves all branches,
+        so all crates are on card 0; an IOC with more cards
+        maps the branch to its card here, and sets CV_MAX_PSCD.
+
+  Side: None
+
+  Ret:  unsigned short
+              PSCD card number, 0 to CV_MAX_PSCD-1
+            
+=======================================================*/ 
+static unsigned short CV_CardOf( short branch )
+{
+    return(0);
+}
+
 
 /*====================================================
  
@@ -1056,17 +2529,17 @@ CV_MODULE * CV_AddModule( short branch, short crate, short slot )
           Acc:  read-only
           Mech: By value
 
-        interval_e                Interval to process asyn messages
-          Type: enum         
-          Use:  cv_interval_te 
+        period                    Polling period, in seconds
+          Type: integer           Note: 0 = disabled
+          Use:  unsigned long 
           Acc:  read-only
           Mech: By value
 
-        source_c                  Message source
-          Type: ascii-string      Note: NULL terminated        
-          Use:  char * const      TEST = Test functions
-          Acc:  read-only         DSUP = device support
-          Mech: By reference      ASYN = Asyn thread
+        source_e                  Message source
+          Type: enum              CV_MSG_TEST = Test functions
+          Use:  cv_msg_source_te  CV_MSG_DSUP = device support
+          Acc:  read-only         CV_MSG_ASYN = Asyn thread
+          Mech: By value
 
 
         module_ps                 Module information       
@@ -1085,11 +2558,12 @@ CV_MODULE * CV_AddModule( short branch, short crate, short slot )
             
 =======================================================*/ 
 static void CV_AddMsg( cv_camac_func_te             func_e, 
-                       cv_interval_te               interval_e,
-                       char                 * const source_c,  
+                       unsigned long                period,
+                       cv_msg_source_te             source_e,  
                        CV_MODULE            * const module_ps )
 {
     CV_REQUEST   *msg_ps = NULL;  /* Pointer to message info used by the asyn thread */
+    CV_MSG_SOURCE;
     
     /* 
      * Initialize asyn message, which is used by CV_AsynThread() 
@@ -1097,20 +2571,29 @@ static void CV_AddMsg( cv_camac_func_te             func_e,
      * Note that the messag Q pointer will be NULL if this function
      * has been called prior to CV_Start().
      *
-     * Allocate memory for message block, used to send request to the queu
-     * from the asyn task CV_AsynThread(). Device support will create their
+     * Take a message block from the request pool, used to send request to the queu
+     * from the asyn task CV_AsynThread(). Device support will take their
      * own message block.
      */
-     msg_ps = callocMustSucceed(1,sizeof(CV_REQUEST),"calloc buffer for async CV_MESSAGE");
-     CV_DeviceInit( func_e,source_c,NULL,module_ps, msg_ps );
+     msg_ps = CV_RequestAlloc();
+     if (!msg_ps)
+     {
+       errlogSevPrintf(errlogMajor,CV_REQDROP_MSG,"CV_AddMsg",func_e,
+                       module_ps->b,module_ps->c,module_ps->n);
+       return;
+     }
+     CV_DeviceInit( func_e,source_e,NULL,module_ps, msg_ps );
+     msg_ps->period    = min(period,CV_POLL_MAX_PERIOD);
+     msg_ps->countdown = 0;
+     module_ps->poll_aps[func_e] = msg_ps;
   
      /* Now, add the new module to the linked list.*/
-     ellAdd(&asynMsgList_as[interval_e],(ELLNODE *)msg_ps);
+     ellAdd(&asynMsgList_s,(ELLNODE *)msg_ps);
   
      /* Print module location */
      if(CV_DRV_DEBUG) 
        printf("Add %s Message camac func(%d) for CV[b=%hd,c=%hd,n=%hd]\n",
-               source_c,
+               cv_msg_source_ac[source_e],
                func_e,
                module_ps->b,
                module_ps->c,
@@ -1118,6 +2601,99 @@ static void CV_AddMsg( cv_camac_func_te             func_e,
      return;
 }
 
+/*====================================================
+ 
+  Abs:  Allocate a request message from the request pool
+ 
+  Name: CV_RequestAlloc
+ 
+  Args: None
+
+  Rem:  The purpose of this function is to take the next free
+        request message from the pool allocated by CV_Start(),
+        and grown by CV_AddModule() beyond the slab. If the pool
+        is not allocated yet, or all its requests are taken, a
+        chunk is added to it, so that a request made before 
+        CV_Start() is not lost. The failure is logged when the
+        pool has CV_REQ_MAX_CHUNK chunks already.
+        The request keeps its pool index as the handle that is
+        sent to the message queue. Requests are never returned
+        to the pool; each asyn message, record and test function
+        owns its request for the life of the IOC.
+
+  Side: None
+
+  Ret:  CV_REQUEST
+              address of request structure - Successfully completed
+              NULL - Pool exhausted
+            
+=======================================================*/ 
+CV_REQUEST * CV_RequestAlloc( void )
+{
+    CV_REQUEST   *req_ps = NULL;  /* Pointer to request from the pool */
+
+    if ((reqPoolUsed >= reqPoolSize) &&
+        (CV_RequestGrow(reqPoolSize/CV_REQ_PER_MODULE + 1) != OK))
+    {
+       errlogSevPrintf(errlogMajor,CV_REQPOOL_MSG,reqPoolSize);
+       return(req_ps);
+    }
+    req_ps = CV_REQ_OF(reqPoolUsed);
+    req_ps->handle = reqPoolUsed++;
+    return(req_ps);
+}
+
+/*====================================================
+ 
+  Abs:  Send a request message to the queue
+ 
+  Name: CV_SendRequest
+ 
+  Args: req_ps                    Request message
+          Type: pointer           Note: must be from CV_RequestAlloc()
+          Use:  CV_REQUEST * const 
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to send the handle
+        of the request message provided to the CV_OP thread queue.
+        The request itself stays in the pool and is not copied.
+
+        A request is identified by its handle, so a request 
+        already in the queue is not sent again; the pending
+        one does the same work. The queued flag is tested and 
+        set under the pool lock, since a request may be sent by
+        the asyn thread and by record processing at the same time.
+        The send does not block, so the lock is held briefly.
+
+  Side: None
+
+  Ret:  long
+            OK    - Operation successful, or request already queued
+            ERROR - No queue, or queue full
+            
+=======================================================*/ 
+long CV_SendRequest( CV_REQUEST * const req_ps )
+{
+    long         status    = OK;
+    CV_MODULE   *module_ps = NULL;  /* Pointer to module information */
+
+    if (!req_ps || !req_ps->module_ps) return(ERROR);
+    module_ps = req_ps->module_ps;
+    if (!module_ps->msgQId_ps) return(ERROR);
+
+    epicsMutexMustLock(reqLock);
+    if (!req_ps->queued)
+    {
+       status = epicsMessageQueueTrySend(module_ps->msgQId_ps,
+                                         &req_ps->handle,
+                                         sizeof(req_ps->handle));
+       if (!status) req_ps->queued = epicsTrue;
+    }
+    epicsMutexUnlock(reqLock);
+    return(status);
+}
+
 /*====================================================
  
   Abs:  Initialize Message contents
@@ -1130,11 +2706,11 @@ static void CV_AddMsg( cv_camac_func_te             func_e,
           Acc:  read-only
           Mech: By value
 
-        source_c                  Message source
-          Type: ascii-string      Note: NULL terminated        
-          Use:  char * const      TEST = Test functions
-          Acc:  read-only         DSUP = device support
-          Mech: By reference      ASYN = Asyn thread
+        source_e                  Message source
+          Type: enum              CV_MSG_TEST = Test functions
+          Use:  cv_msg_source_te  CV_MSG_DSUP = device support
+          Acc:  read-only         CV_MSG_ASYN = Asyn thread
+          Mech: By value
 
         rec_ps                    Record Information
           Type: pointer           Note: Optional, NULL if not provided       
@@ -1167,7 +2743,7 @@ static void CV_AddMsg( cv_camac_func_te             func_e,
                   
 =======================================================*/ 
 long CV_DeviceInit( cv_camac_func_te         func_e, 
-                    char       const * const source_c,
+                    cv_msg_source_te         source_e,
                     dbCommon         * const rec_ps,
                     CV_MODULE        * const module_ps,
                     CV_REQUEST       * const dpvt_ps   )
@@ -1182,7 +2758,7 @@ long CV_DeviceInit( cv_camac_func_te         func_e,
     dpvt_ps->module_ps = module_ps;
     dpvt_ps->rec_ps    = rec_ps;
     dpvt_ps->func_e    = func_e;
-    sprintf(dpvt_ps->source_c,"%s",source_c);
+    dpvt_ps->source_e  = source_e;
     switch( func_e )
     {
         case CAMAC_RD_ID:
@@ -1297,8 +2873,11 @@ static vmsstat_t CV_ReadVoltageInit( short branch, short crate, short slot, camp
     unsigned int                 ctlw   = 0;                     /* Camac control word    */
     unsigned short               bcnt   = sizeof(short);         /* data byte count       */
     unsigned short               nops   = CV_NUM_ANLG_CHANNELS;  /* # of Camac operations */               
+    epicsTimeStamp               start;
 
  
+    epicsTimeGetCurrent(&start);
+
    /* 
     * Does CAMAC package exists? If so exit. Otherwise, allocate the 
     * package with a single packet to read the all analog voltages sequentially
@@ -1327,6 +2906,7 @@ static vmsstat_t CV_ReadVoltageInit( short branch, short crate, short slot, camp
       }/* End of FOR loop */
     }
 
+    CV_BootTimeAdd(CV_BOOT_PKGBUILD,crate,&start);
     return(iss);
 }
 
@@ -1389,8 +2969,11 @@ static vmsstat_t   CV_ReadIdInit( short branch, short crate, short slot, campkg_
     unsigned int                 ctlw  = 0;
     unsigned short               bcnt  = sizeof(short);
     unsigned short               nops  = 1;
+    epicsTimeStamp               start;
 
 
+    epicsTimeGetCurrent(&start);
+
    /* 
     * Does CAMAC package exists? If so then reset the package. Otherwise, allocate the 
     * package with a single packet to read the module id register.
@@ -1411,6 +2994,7 @@ static vmsstat_t   CV_ReadIdInit( short branch, short crate, short slot, campkg_
           cam_ps->pkg_p = NULL;
        }
     }
+    CV_BootTimeAdd(CV_BOOT_PKGBUILD,crate,&start);
     return(iss);
 }
 
@@ -1466,7 +3050,10 @@ static vmsstat_t   CV_ReadDataInit( short branch, short crate, short slot, campk
     unsigned int                 ctlw   = 0;
     unsigned short               bcnt   = sizeof(long);
     unsigned short               nops   = 2;
+    epicsTimeStamp               start;
+
 
+    epicsTimeGetCurrent(&start);
 
    /* 
     * Does CAMAC package exists? If, so then we're done.Otherwise, allocate the 
@@ -1494,6 +3081,7 @@ static vmsstat_t   CV_ReadDataInit( short branch, short crate, short slot, campk
        }
     }
 
+    CV_BootTimeAdd(CV_BOOT_PKGBUILD,crate,&start);
     return(iss);
 }
 
@@ -1557,8 +3145,11 @@ static vmsstat_t  CV_WriteDataInit( short branch, short crate, short slot, campk
     unsigned int      rd_ctlw = 0;
     unsigned short    bcnt    = sizeof(long);
     unsigned short    nops    = 2;
+    epicsTimeStamp    start;
 
 
+    epicsTimeGetCurrent(&start);
+
     /* 
     * Does CAMAC package exists? If so then we're done. Otherwise, allocate the 
     * package with a two packets, setting the data register and then reading
@@ -1582,6 +3173,7 @@ static vmsstat_t  CV_WriteDataInit( short branch, short crate, short slot, campk
        if (!SUCCESS(iss)) 
           iss2 = camdel (&cam_ps->pkg_p);
     }
+    CV_BootTimeAdd(CV_BOOT_PKGBUILD,crate,&start);
     return(iss);
 }
 
@@ -1653,7 +3245,7 @@ static vmsstat_t  CV_CrateInit( CV_MODULE * const module_ps,epicsBoolean pulseZ_
    {
       if (pulseZ_e) 
       {
-         printf("Z-Line On\n");
+         CV_LogPost(CV_LOG_ZLINEON,module_ps->c,module_ps->n,0,0,0,0);
          module_ps->crate_s.z_off = epicsFalse;
       }
       else	
@@ -1755,7 +3347,8 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
             iss   = camadd(&ctlw, &cam_ps->wt_statd_s, &bcnt, &emask, &cam_ps->pkg_p);
             if (SUCCESS(iss))
 	    {
-               iss = camgo( &cam_ps->pkg_p );
+               iss = CV_TraceCamgo( module_ps,CAMAC_RD_CRATE_STATUS,CV_PKG_INIT_Z,
+                                    &cam_ps->pkg_p,&cam_ps->wt_statd_s.stat );
                if (SUCCESS(iss))
 	       {
                  /*
@@ -1766,7 +3359,8 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
                  iss  = camalo_reset( &cam_ps->pkg_p );
                  ctlw = (module_ps->c << CCTLW__C_shc) | (module_ps->n << CCTLW__M_shc) | (F4A0 | CCTLW__P24);
                  iss  = camadd(&ctlw, &cam_ps->rd_statd_s, &bcnt, &emask, &cam_ps->pkg_p);
-                 iss  = camgo( &cam_ps->pkg_p );
+                 iss  = CV_TraceCamgo( module_ps,CAMAC_RD_CRATE_STATUS,CV_PKG_INIT_RBK,
+                                       &cam_ps->pkg_p,&cam_ps->rd_statd_s.stat );
                  data = cam_ps->rd_statd_s.data & CV_DATA_MASK;
                  if (SUCCESS(iss) && (data==module_ps->pattern))
 		 {
@@ -1778,9 +3372,9 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
                      * then issue a message.
 		     */
                     if (!module_ps->crate_s.z_off && !module_ps->crate_s.first_watch)
-		       errlogSevPrintf(errlogInfo,CRAT_ZISSUED_MSG,module_ps->c);
+		       CV_LogPost(CV_LOG_ZISSUED,module_ps->c,module_ps->n,0,0,0,0);
                     if (module_ps->crate_s.first_watch)
-		       errlogSevPrintf(errlogInfo,CRAT_INITSUCC_MSG,module_ps->c);
+		       CV_LogPost(CV_LOG_INITSUCC,module_ps->c,module_ps->n,0,0,0,0);
 		 }
                  /*
                   * Reading the data register does not match pattern written, so 
@@ -1793,22 +3387,20 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
 		 {   
                      iss = CRAT_INITFAIL;
                      if (module_ps->crate_s.first_watch)
-	               errlogSevPrintf(errlogMajor,
-                                       CRAT_INITFAIL_MSG, 
-                                       module_ps->c,"rd",
-                                       cam_ps->rd_statd_s.data,
-                                       cam_ps->rd_statd_s.stat);
+	               CV_LogPost(CV_LOG_INITFAIL_RD,
+                                  module_ps->c,module_ps->n,
+                                  cam_ps->rd_statd_s.data,
+                                  cam_ps->rd_statd_s.stat,0,0);
 	         }
 	       }/* end of camgo status check */
 	       else
 	       {
                  iss = CRAT_INITFAIL;
                  if (module_ps->crate_s.first_watch)
-	            errlogSevPrintf(errlogMajor,
-                                    CRAT_INITFAIL_MSG, 
-                                    module_ps->c,"wt",
-                                    cam_ps->wt_statd_s.data,
-                                    cam_ps->wt_statd_s.stat);
+	            CV_LogPost(CV_LOG_INITFAIL_WT,
+                               module_ps->c,module_ps->n,
+                               cam_ps->wt_statd_s.data,
+                               cam_ps->wt_statd_s.stat,0,0);
 	       } 
             }
             /* camadd failure */
@@ -1823,7 +3415,7 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
 
 /*====================================================
  
-  Abs:  Initlized Camac package to set the data register
+  Abs:  Initlized Camac packages for the Dataway Test
  
   Name: CV_TestDatawayInit
  
@@ -1845,7 +3437,7 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        cam_ps                    Dataway camac packages
           Type: struct            and status-data.        
           Use:  campkg_dataway_ts * const
           Acc:  read-write access
@@ -1861,6 +3453,14 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
         3) Id number
         4) Voltages and temperature
         5) X-Q response of module
+
+        The packets are grouped into CV_DATAWAY_NUM_STEP steps,
+        each added to as few packages as the MBCD allows (see 
+        CV_DatawayPktAdd) and ended with a write of the test pattern 
+        to the DATA register (see CV_DatawayStepEnd). Each step can
+        be issued on its own, so the periodic test is spread over 
+        the minute. The X-Q responses are checked from the 
+        status-data once the last step completes.
  
  
   Side: None
@@ -1875,56 +3475,241 @@ static vmsstat_t CV_CrateInitInit( CV_MODULE * const module_ps )
 =======================================================*/ 
 static vmsstat_t   CV_TestDatawayInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps )
 {
-    vmsstat_t      iss = CRAT_OKOK;
+    vmsstat_t      iss   = CRAT_OKOK;
+    vmsstat_t      iss2  = CRAT_OKOK;
+    unsigned int   ctlw  = 0;
+    unsigned short ipkg  = 0;
+    unsigned short i     = 0;
+    epicsTimeStamp start;
  
 
+    epicsTimeGetCurrent(&start);
+
     /*
-     * Setup the Camac package to clear the registers on 
+     * Add the packets to clear the registers on 
      * the bus by pulsing the C-line 
      */
-    iss = CV_CratePulseCInit(branch,crate,slot,&cam_ps->pulseC_s);
+    iss = CV_CratePulseCInit(branch,crate,slot,cam_ps);
+
+    /* 
+     * Add the packet to clear the crate inhibit
+     */
+    if (SUCCESS(iss))
+      iss = CV_CrateClrInhibitInit(branch,crate,slot,cam_ps);
+
+    /* 
+     * Add the packet to write to the Serial Crate Controller
+     * to put it into addressing mode. Expect X=0.
+     */
+    if (SUCCESS(iss))
+      iss = CV_CrateSCCInit(branch,crate,slot,cam_ps);
+
+    /*
+     * Add the packets to test the command lines.
+     * in order of:
+     *     N,F1,F2,F4,F8,F16,A1,A2,A4,A8,C,Z,I
+     */
+    if (SUCCESS(iss))
+       iss = CV_CrateCmdLineInit(branch,crate,slot,cam_ps);
+
+    /* Read the module Id register. Here we are checking for Q=1 */
+    ctlw = (slot << CCTLW__M_shc) | (crate << CCTLW__C_shc) | CCTLW__F4  |  CCTLW__A3; 
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps,ctlw,&cam_ps->id_statd_s,sizeof(short),CAMAC_EMASK_NOX_NOQ);
+
+    /* End of the command line step */
+    if (SUCCESS(iss))
+       iss = CV_DatawayStepEnd(crate,slot,cam_ps);
 
     /* 
-     * Setup the Camac package to clear the crate inhibit
+     * Add the packets to test the
+     *   read lines using the walking one
+     *   read lines using the walking zero
+     *   write lines using the walking one
+     *   write lines using the walking zero
      */
     if (SUCCESS(iss))
-      iss = CV_CrateClrInhibitInit(branch,crate,slot,&cam_ps->inhibit_s);
+       iss = CV_CrateRWLineInit(branch,crate,slot,cam_ps);
+
+    /* Read the crate voltages, ground voltage and temperature */
+    for (i=0; (i<CV_NUM_ANLG_CHANNELS) && SUCCESS(iss); i++)
+    {
+       ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F5 | i;
+       iss  = CV_DatawayPktAdd(cam_ps,ctlw,&cam_ps->volts_as[i],sizeof(short),CAMAC_EMASK_NOX_NOQ);
+    }
+
+    /* End of the voltage step, which is the last */
+    if (SUCCESS(iss))
+       iss = CV_DatawayStepEnd(crate,slot,cam_ps);
+
+    if (SUCCESS(iss))
+      cam_ps->init = epicsTrue;
+    else
+    {
+      /* Start over on the next test */
+      for (ipkg=0; ipkg<cam_ps->npkg; ipkg++)
+      {
+        iss2 = camdel(&cam_ps->pkg_p[ipkg]);
+        cam_ps->pkg_p[ipkg]  = NULL;
+        cam_ps->stat_p[ipkg] = NULL;
+      }
+      cam_ps->npkg  = 0;
+      cam_ps->npkts = 0;
+      cam_ps->nstep = 0;
+    }
+    CV_BootTimeAdd(CV_BOOT_PKGBUILD,crate,&start);
+    return(iss);
+}
+
+ 
+/*====================================================
+ 
+  Abs:  Add a Camac packet to the Dataway Test packages
+ 
+  Name: CV_DatawayPktAdd
+ 
+  Args: cam_ps                    Dataway camac packages
+          Type: struct            and status-data.        
+          Use:  campkg_dataway_ts * const
+          Acc:  read-write access
+          Mech: By reference
+
+        ctlw                      Camac control word
+          Type: value
+          Use:  unsigned int
+          Acc:  read-only
+          Mech: By value
+
+        statd_p                   Packet status-data
+          Type: pointer           Note: must be a member of cam_ps
+          Use:  void * const
+          Acc:  read-write access
+          Mech: By reference
+
+        bcnt                      Data byte count
+          Type: value
+          Use:  unsigned short
+          Acc:  read-only
+          Mech: By value
+
+        emask                     Camac error mask
+          Type: value
+          Use:  unsigned short
+          Acc:  read-only
+          Mech: By value
+
+  Rem:  The purpose of this function is to add a packet to the 
+        last dataway test package, allocating a new package when 
+        the last one holds CV_MBCD_MAX_PKTS packets or the step
+        has ended. This keeps each dataway test step to as few 
+        camgo() calls as the MBCD allows.
+
+  Side: None
+  
+  Ret:  vmsstat_t
+            CRAT_OKOK - Successfully completed
+            CRAT_NOTVALID - Too many packets for the dataway packages
+            Otherwise, see return codes from:
+              camalo()
+              camadd()
+
+=======================================================*/ 
+static vmsstat_t  CV_DatawayPktAdd( campkg_dataway_ts * const cam_ps,
+                                    unsigned int              ctlw,
+                                    void              * const statd_p,
+                                    unsigned short            bcnt,
+                                    unsigned short            emask )
+{
+    vmsstat_t       iss   = CRAT_OKOK;     /* return status                    */
+    unsigned short  nops  = 0;             /* Number of Camac operations (pkt) */
+    unsigned short  ipkg  = 0;             /* index of last camac package      */
+
+
+    /* Is the last package full? If so, then allocate the next one. */
+    if (!cam_ps->npkg || (cam_ps->npkts>=CV_MBCD_MAX_PKTS))
+    {
+       if (cam_ps->npkg>=CV_DATAWAY_MAX_PKG)
+          return(CRAT_NOTVALID);
+       nops = CV_MBCD_MAX_PKTS;
+       iss = camalo(&nops,&cam_ps->pkg_p[cam_ps->npkg]);
+       if (!SUCCESS(iss)) return(iss);
+       cam_ps->npkg++;
+       cam_ps->npkts = 0;
+    }
+
+    ipkg = cam_ps->npkg-1;
+    iss  = camadd(&ctlw, statd_p, &bcnt, &emask, &cam_ps->pkg_p[ipkg]);
+    if (SUCCESS(iss))
+    {
+       cam_ps->stat_p[ipkg] = (unsigned int *)statd_p;
+       cam_ps->npkts++;
+    }
+    return(iss);
+}
+
+/*====================================================
+ 
+  Abs:  End a step of the Dataway Test packages
+ 
+  Name: CV_DatawayStepEnd
+ 
+  Args: crate                     Camac crate number
+          Type: value             Note: 1-15           
+          Use:  short 
+          Acc:  read-only
+          Mech: By value
+
+        slot                      Camac crate slot number
+          Type: value             Note: 1-24           
+          Use:  short 
+          Acc:  read-only
+          Mech: By value
+
+        cam_ps                    Dataway camac packages
+          Type: struct            and status-data.        
+          Use:  campkg_dataway_ts * const
+          Acc:  read-write access
+          Mech: By reference
 
-    /* 
-     * Setup the Camac package to write to the Serial Crate Controller
-     * to put it into addressing mode. Expect X=0.
-     */
-    if (SUCCESS(iss))
-      iss = CV_CrateSCCInit(branch,crate,slot,&cam_ps->scc_s);
+  Rem:  The purpose of this function is to end the current 
+        step of the dataway test. A write of the test pattern to
+        the DATA register is added, so the register holds the
+        pattern expected by the online status check between steps.
+        The readback is not checked. The next packet is added to a
+        new package, so each step can be issued on its own.
 
-    /*
-     * Setup the Camac package to test the command lines.
-     * in order of:
-     *     N,F1,F2,F4,F8,F16,A1,A2,A4,A8,C,Z,I
-     */
-    if (SUCCESS(iss))
-       iss = CV_CrateCmdLineInit(branch,crate,slot,&cam_ps->cmd_s);
+  Side: None
+  
+  Ret:  vmsstat_t
+            CRAT_OKOK - Successfully completed
+            CRAT_NOTVALID - Too many steps for the dataway packages
+            Otherwise, see return codes from:
+              CV_DatawayPktAdd()
 
-    /* 
-     * Setup Camac package to test the
-     *   read lines using the walking one
-     *   read lines using the walking zero
-     *   write lines using the walking one
-     *   write lines using the walking zero
-     */
-    if (SUCCESS(iss))
-       iss = CV_CrateRWLineInit(branch,crate,slot,cam_ps);
+=======================================================*/ 
+static vmsstat_t  CV_DatawayStepEnd( short crate, short slot, campkg_dataway_ts * const cam_ps )
+{
+    vmsstat_t       iss   = CRAT_OKOK;     /* return status        */
+    unsigned int    ctlw  = 0;             /* Camac control word   */
 
+
+    if (cam_ps->nstep>=CV_DATAWAY_NUM_STEP)
+       return(CRAT_NOTVALID);
+
+    /* Leave test pattern in data register for periodic crate online status checking */
+    ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F20A0 | CCTLW__P24;
+    iss  = CV_DatawayPktAdd(cam_ps,ctlw,&cam_ps->wt_statd_s,sizeof(long),CAMAC_EMASK_NOX_NOQ);
     if (SUCCESS(iss))
-      cam_ps->init = epicsTrue;
-     
+    {
+       cam_ps->stepEnd_a[cam_ps->nstep++] = cam_ps->npkg;
+       cam_ps->npkts = CV_MBCD_MAX_PKTS;  /* start the next step in a new package */
+    }
     return(iss);
 }
 
- 
 /*====================================================
  
-  Abs:  Build Camac package to Pulse the C-Line (C=0)
+  Abs:  Add Camac packet to Pulse the C-Line (C=0)
  
   Name: CV_CratePulseCInit
  
@@ -1946,9 +3731,9 @@ static vmsstat_t   CV_TestDatawayInit( short branch, short crate, short slot , c
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        cam_ps                    Dataway camac packages
           Type: struct            and status-data.        
-          Use:  campkg_nodata_ts * const
+          Use:  campkg_dataway_ts * const
           Acc:  read-write access
           Mech: By reference
 
@@ -1988,39 +3773,22 @@ static vmsstat_t   CV_TestDatawayInit( short branch, short crate, short slot , c
               camadd()
 
 =======================================================*/ 
-static vmsstat_t   CV_CratePulseCInit( short branch, short crate, short slot, campkg_nodata_ts * const cam_ps )
+static vmsstat_t   CV_CratePulseCInit( short branch, short crate, short slot, campkg_dataway_ts * const cam_ps )
 {
-    vmsstat_t       iss = CRAT_OKOK;
     unsigned int    ctlw   = 0;
     unsigned short  bcnt   = 0;
-    unsigned short  nops   = 1;
     unsigned short  emask  = CAMAC_EMASK_NOX_NOQ;
 
    /*
-    * Setup the Camac package to clear the bus registers 
-    * by pulsing the C-line.
+    * Clear the bus registers by pulsing the C-line.
     */
-    if (!cam_ps->pkg_p) 
-    {
-      iss = camalo(&nops,&cam_ps->pkg_p);
-      if (SUCCESS(iss))
-      {  
-         /* Clear registers by pulsing the C-line */
-         ctlw = (crate << CCTLW__C_shc) | M28 | F26A9;
-         iss  = camadd(&ctlw, &cam_ps->stat, &bcnt, &emask, &cam_ps->pkg_p);
-         if (!SUCCESS(iss))
-         {
-            camdel( &cam_ps->pkg_p );
-            cam_ps->pkg_p = NULL;
-         }
-      }
-    }
-   return(iss);
+    ctlw = (crate << CCTLW__C_shc) | M28 | F26A9;
+    return( CV_DatawayPktAdd(cam_ps, ctlw, &cam_ps->pulseC_stat, bcnt, emask) );
 }
 
 /*====================================================
  
-  Abs:  Build Camac package to Clear the Crate Inhibit Line (I=0)
+  Abs:  Add Camac packet to Clear the Crate Inhibit Line (I=0)
  
   Name: CV_CrateClrInhibitInit
  
@@ -2042,9 +3810,9 @@ static vmsstat_t   CV_CratePulseCInit( short branch, short crate, short slot, ca
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        cam_ps                    Dataway camac packages
           Type: struct            and status-data.        
-          Use:  campkg_nodata_ts * const
+          Use:  campkg_dataway_ts * const
           Acc:  read-write access
           Mech: By reference
 
@@ -2085,38 +3853,23 @@ static vmsstat_t   CV_CratePulseCInit( short branch, short crate, short slot, ca
               camadd()
 
 =======================================================*/
-static vmsstat_t   CV_CrateClrInhibitInit( short branch, short crate, short slot , campkg_nodata_ts * const cam_ps )
+static vmsstat_t   CV_CrateClrInhibitInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps )
 {
-    vmsstat_t       iss   = CRAT_OKOK;
     unsigned int    ctlw  = 0;
     unsigned short  bcnt  = 0;
-    unsigned short  nops  = 1;
     unsigned short  emask = CAMAC_EMASK_NOX_NOQ;
 
     /* 
-     * Setup the Camac package to clear the bus inhibit line
+     * Clear the bus inhibit line
      */
-    if (!cam_ps->pkg_p) 
-    {
-       iss = camalo(&nops,&cam_ps->pkg_p);
-       if (SUCCESS(iss))
-       {  
-          ctlw = (crate << CCTLW__C_shc) | M30 | F24A9;
-          iss  = camadd(&ctlw, &cam_ps->stat, &bcnt, &emask, &cam_ps->pkg_p);
-          if (!SUCCESS(iss))
-          {
-             camdel( &cam_ps->pkg_p );
-             cam_ps->pkg_p = NULL;
-          }
-       }
-    }
-    return(iss);
+    ctlw = (crate << CCTLW__C_shc) | M30 | F24A9;
+    return( CV_DatawayPktAdd(cam_ps, ctlw, &cam_ps->inhibit_stat, bcnt, emask) );
 }
 
 
 /*====================================================
  
-  Abs:  Build a Camac Package issue a READ command using R-Lines on the bus.
+  Abs:  Add a Camac packet to issue a READ command using R-Lines on the bus.
  
   Name: CV_CrateSCCInit
  
@@ -2138,9 +3891,9 @@ static vmsstat_t   CV_CrateClrInhibitInit( short branch, short crate, short slot
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        cam_ps                    Dataway camac packages
           Type: struct            and status-data.        
-          Use:  campkg_4u_ts * const
+          Use:  campkg_dataway_ts * const
           Acc:  read-write access
           Mech: By reference
 
@@ -2207,41 +3960,25 @@ static vmsstat_t   CV_CrateClrInhibitInit( short branch, short crate, short slot
               camadd()
 
 =======================================================*/
-static vmsstat_t   CV_CrateSCCInit( short branch, short crate, short slot , campkg_4u_ts * const cam_ps )
+static vmsstat_t   CV_CrateSCCInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps )
 {
-    vmsstat_t       iss   = CRAT_OKOK;             /* status return                    */
-    vmsstat_t       iss2  = CRAT_OKOK;             /* local status                     */
     unsigned int    ctlw  = 0;                     /* Camac control word               */
     unsigned short  bcnt  = sizeof(long);          /* Camac data byte count            */
-    unsigned short  nops  = 1;                     /* Number of Camac operations (pkt) */
     unsigned short  emask = CAMAC_EMASK_NOX_NOQ;   /* Camac error mask, returning      */
                                                    /* error on X=0 or Q=0              */
 
     /*
-     * Setup the Camac package to read the command line F0
+     * Read the command line F0
      * to check for a crate timeout .
      */
-    if (!cam_ps->pkg_p) 
-    {
-       iss = camalo(&nops,&cam_ps->pkg_p);
-       if (SUCCESS(iss))
-       {  
-          ctlw  = (crate << CCTLW__C_shc) | M24 | CCTLW__P24;
-          iss   = camadd(&ctlw, &cam_ps->statd_s, &bcnt, &emask, &cam_ps->pkg_p);
-          if (!SUCCESS(iss))
-	  {
-            iss2 = camdel(&cam_ps->pkg_p);
-	    cam_ps->pkg_p = NULL;
-          }
-       }
-    }
-    return(iss);
+    ctlw  = (crate << CCTLW__C_shc) | M24 | CCTLW__P24;
+    return( CV_DatawayPktAdd(cam_ps, ctlw, &cam_ps->scc_statd_s, bcnt, emask) );
 }
 
 
 /*====================================================
  
-  Abs:  Initlized Camac package for Command Lines Test
+  Abs:  Add Camac packets for Command Lines Test
  
   Name: CV_CrateCmdLineInit
  
@@ -2263,9 +4000,9 @@ static vmsstat_t   CV_CrateSCCInit( short branch, short crate, short slot , camp
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        dataway_ps                Dataway camac packages
           Type: struct            and status-data.        
-          Use:  campkg_cmd_ts * const
+          Use:  campkg_dataway_ts * const
           Acc:  read-write access
           Mech: By reference
 
@@ -2283,9 +4020,9 @@ static vmsstat_t   CV_CrateSCCInit( short branch, short crate, short slot , camp
            Z: N(28) F26 A8
            I: N(30) F26 A9
    
-       Two Camac packages are setup, each package with seven packets.
-       The first package issues the command line test for:   N,F1,F2,F4,F8,F16,A1
-       The second package issues the command line test for:  A2,A4,A8,C,Z,I
+       The packets are added to the dataway package in two halves.
+       The first half issues the command line test for:   N,F1,F2,F4,F8,F16,A1
+       The second half issues the command line test for:  A2,A4,A8,C,Z,I
 
        Before the camac package is issued, the write data buffers will
        need to be setup and the read data buffers must be cleared.
@@ -2300,10 +4037,10 @@ static vmsstat_t   CV_CrateSCCInit( short branch, short crate, short slot , camp
               camadd()
 
 =======================================================*/
-static vmsstat_t   CV_CrateCmdLineInit( short                 branch,
-                                        short                 crate, 
-                                        short                 slot, 
-                                        campkg_cmd_ts * const cam_ps )
+static vmsstat_t   CV_CrateCmdLineInit( short                     branch,
+                                        short                     crate, 
+                                        short                     slot, 
+                                        campkg_dataway_ts * const dataway_ps )
 {
     CMD_LINE_FUNC;
     vmsstat_t          iss     = CRAT_OKOK;            /* return status                          */
@@ -2311,57 +4048,52 @@ static vmsstat_t   CV_CrateCmdLineInit( short                 branch,
     unsigned int       rd_ctlw = 0;                    /* Camac control word                     */   
     unsigned short     bcnt    = sizeof(long);         /* byte count                             */
     unsigned short     nobcnt  = 0;                    /* zero byte count                        */
-    unsigned short     nops    = CMD_LINE_NUM+1;       /* Number of Camac operations             */
-    unsigned short     npkts   = 0;                    /* Camac packet counter                   */
     unsigned short     emask   = CAMAC_EMASK_NOX_NOQ;  /* Camac error mask                       */
     unsigned short     i       = 0;                    /* Index to write-read stat-data pkts     */
-    unsigned short     ipkg    = 0;                    /* Camac package pointer index            */
+    campkg_cmd_ts     *cam_ps  = &dataway_ps->cmd_s;   /* command line stat-data                 */
 
    
     /*
-     * Setup the Camac package to test the command lines.
+     * Add the packets to test the command lines.
      * in order of:
      *     N,F1,F2,F4,F8,F16,A1,A2,A4,A8,C,Z,I
      */
-    if (!cam_ps->pkg_p[ipkg])
-    {
-       /* Allocate Camac package for command line test */
-       iss = camalo(&nops,&cam_ps->pkg_p[ipkg]);  
-    
-       /* 
-	*  READ Command using the R-Lines (SCC)
-        *
-	* Note: A crate controller once addressed remains in this state until another
-        * one on the line is addressed using a CAMAC command. Control bit C selects 16 or 24 bit mode. 
-        * The crate controller remains in the selected mode until re-addressed.
-	*/
-       ctlw = (crate << CCTLW__C_shc) | M24;
-       iss = camadd(&ctlw, &cam_ps->statd_s, &bcnt, &emask, &cam_ps->pkg_p[ipkg]);
 
-       /* Read the verifier COMMAND register */
-       rd_ctlw = (crate << CCTLW__C_shc) | (slot<<CCTLW__M_shc) | F3A0 | CCTLW__P24;  
-       iss     = camadd(&rd_ctlw, &cam_ps->rd_statd_as[0], &bcnt, &emask, &cam_ps->pkg_p[ipkg]);
+    /* 
+     *  READ Command using the R-Lines (SCC)
+     *
+     * Note: A crate controller once addressed remains in this state until another
+     * one on the line is addressed using a CAMAC command. Control bit C selects 16 or 24 bit mode. 
+     * The crate controller remains in the selected mode until re-addressed.
+     */
+    ctlw = (crate << CCTLW__C_shc) | M24;
+    iss  = CV_DatawayPktAdd(dataway_ps, ctlw, &cam_ps->statd_s, bcnt, emask);
 
-       /* 
-	* READ Command Lines using R-Line, followed by a read of the verifier COMMAND register
-        * for lines:  F1,F2,F4,F8,F16,A1,A2 
-        *
-	* Note: Since we are using the R-Lines to check that the function and subaddress codes are 
-	* working properly, be aware that if if lines other than the F-lines and A-lines fail
-	* the problem is a R-Line issue, but since F-lines and A-lines overlap R-Lines, of one
-	* of the overlapping lines (F1,F2,F4,F8,F16,A1,A2), you don't know if the failure is
-	* a R-Line, F-line or a A-line.
-        */
-       for (npkts=2,i=1; (npkts<=nops-2) && SUCCESS(iss); i++,npkts+=2)
-       {
-         ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | cmdLineFunc_a[i];
-         iss  = camadd(&ctlw,    &cam_ps->stat_a[i],      &nobcnt, &emask, &cam_ps->pkg_p[ipkg]);
-         iss  = camadd(&rd_ctlw, &cam_ps->rd_statd_as[i], &bcnt,   &emask, &cam_ps->pkg_p[ipkg]);
-       }/* End of FOR loop */
-    }
+    /* Read the verifier COMMAND register */
+    rd_ctlw = (crate << CCTLW__C_shc) | (slot<<CCTLW__M_shc) | F3A0 | CCTLW__P24;  
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(dataway_ps, rd_ctlw, &cam_ps->rd_statd_as[0], bcnt, emask);
+
+    /* 
+     * READ Command Lines using R-Line, followed by a read of the verifier COMMAND register
+     * for lines:  F1,F2,F4,F8,F16,A1
+     *
+     * Note: Since we are using the R-Lines to check that the function and subaddress codes are 
+     * working properly, be aware that if if lines other than the F-lines and A-lines fail
+     * the problem is a R-Line issue, but since F-lines and A-lines overlap R-Lines, of one
+     * of the overlapping lines (F1,F2,F4,F8,F16,A1,A2), you don't know if the failure is
+     * a R-Line, F-line or a A-line.
+     */
+    for (i=1; (i<7) && SUCCESS(iss); i++)
+    {
+      ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | cmdLineFunc_a[i];
+      iss  = CV_DatawayPktAdd(dataway_ps, ctlw, &cam_ps->stat_a[i], nobcnt, emask);
+      if (SUCCESS(iss))
+         iss = CV_DatawayPktAdd(dataway_ps, rd_ctlw, &cam_ps->rd_statd_as[i], bcnt, emask);
+    }/* End of FOR loop */
    
     if (SUCCESS(iss))
-       iss = CV_CrateCmdInit2( branch,crate,slot,cam_ps );
+       iss = CV_CrateCmdInit2( branch,crate,slot,dataway_ps );
     return(iss);
 }
 
@@ -2369,7 +4101,7 @@ static vmsstat_t   CV_CrateCmdLineInit( short                 branch,
 
 /*====================================================
  
-  Abs:  Initlized Camac package #2 to test Camac Bus Command Lines
+  Abs:  Add Camac packets #2 to test Camac Bus Command Lines
  
   Name: CV_CrateCmdInit2
  
@@ -2391,9 +4123,9 @@ static vmsstat_t   CV_CrateCmdLineInit( short                 branch,
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        dataway_ps                Dataway camac packages
           Type: struct            and status-data.        
-          Use:  campkg_cmd_ts * const
+          Use:  campkg_dataway_ts * const
           Acc:  read-write access
           Mech: By reference
 
@@ -2411,9 +4143,9 @@ static vmsstat_t   CV_CrateCmdLineInit( short                 branch,
            Z: N(28) F26 A8
            I: N(30) F26 A9
    
-       Two Camac packages are setup, each package with seven packets.
-       The first package issues the command lines for:   N,F1,F2,F4,F8,F16,A1
-       The second package issues the command lines for:  A2,A4,A8,C,Z,I
+       The packets are added to the dataway package in two halves.
+       The first half issues the command lines for:   N,F1,F2,F4,F8,F16,A1
+       The second half issues the command lines for:  A2,A4,A8,C,Z,I
 
        Before the camac package is issued, the write data buffers will
        need to be setup and the read data buffers must be cleared.
@@ -2428,7 +4160,7 @@ static vmsstat_t   CV_CrateCmdLineInit( short                 branch,
               camadd()
 
 =======================================================*/
-static vmsstat_t   CV_CrateCmdInit2( short branch, short crate, short slot , campkg_cmd_ts * const cam_ps )
+static vmsstat_t   CV_CrateCmdInit2( short branch, short crate, short slot , campkg_dataway_ts * const dataway_ps )
 {
     CMD_LINE_FUNC;
     vmsstat_t          iss     = CRAT_OKOK;            /* return status                          */
@@ -2436,48 +4168,41 @@ static vmsstat_t   CV_CrateCmdInit2( short branch, short crate, short slot , cam
     unsigned int       rd_ctlw = 0;                    /* Camac control to read command register */                 
     unsigned short     bcnt    = sizeof(long);         /* byte count                             */
     unsigned short     nobcnt  = 0;                    /* zero byte count                        */
-    unsigned short     nops    = CMD_LINE_NUM+1;       /* Number of Camac operations             */
-    unsigned short     npkts   = 0;                    /* Camac packet counter                   */
     unsigned short     emask   = CAMAC_EMASK_NOX_NOQ;  /* Camac error mask                       */
     unsigned short     i       = 0;                    /* Index to write-read stat-data pkts     */
-    unsigned short     ipkg    = 1;                    /* Camac package pointer index            */
+    campkg_cmd_ts     *cam_ps  = &dataway_ps->cmd_s;   /* command line stat-data                 */
 
 
-    if ( cam_ps->pkg_p[ipkg]) 
-       return(iss);
-
-    /* Allocate the Camac package to test the remainder of the bus command lines.*/
-    iss = camalo(&nops,&cam_ps->pkg_p[ipkg]); 
-    if (SUCCESS(iss))
-    {  
-       /* Build  the Camac control word to read the verifier COMMAND register */
-       rd_ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F3A0 | CCTLW__P24;  
+    /* Build  the Camac control word to read the verifier COMMAND register */
+    rd_ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F3A0 | CCTLW__P24;  
 
-       /* 
-	* READ Command Lines using R-Line, followed by a read of the verifier COMMAND register
-        * for lines:  A2,A4,A8,C,I,Z 
-        */
-       for (i=7; (i<CMD_LINE_NUM) && SUCCESS(iss); i++,npkts+=2)
-       {
-         ctlw = (crate << CCTLW__C_shc) | cmdLineFunc_a[i];
+    /* 
+     * READ Command Lines using R-Line, followed by a read of the verifier COMMAND register
+     * for lines:  A2,A4,A8,C,I,Z 
+     */
+    for (i=7; (i<CMD_LINE_NUM) && SUCCESS(iss); i++)
+    {
+      ctlw = (crate << CCTLW__C_shc) | cmdLineFunc_a[i];
 
-        /*
-	 * We we testing the bus linkes C,I or Z? If no, then add the module to the control word 
-	 * so we can specify the READ Line before reading the verifier COMMAND register
-	 */
-         if ((cmdLineFunc_a[i] & CCTLW__M)==0)  
-            ctlw |= (slot << CCTLW__M_shc); 
-         iss = camadd(&ctlw, &cam_ps->stat_a[i], &nobcnt, &emask, &cam_ps->pkg_p[ipkg]);
-         iss = camadd(&rd_ctlw, &cam_ps->rd_statd_as[i], &bcnt,   &emask, &cam_ps->pkg_p[ipkg]);
-       }/* End of FOR loop */
+     /*
+      * We we testing the bus linkes C,I or Z? If no, then add the module to the control word 
+      * so we can specify the READ Line before reading the verifier COMMAND register
+      */
+      if ((cmdLineFunc_a[i] & CCTLW__M)==0)  
+         ctlw |= (slot << CCTLW__M_shc); 
+      iss = CV_DatawayPktAdd(dataway_ps, ctlw, &cam_ps->stat_a[i], nobcnt, emask);
+      if (SUCCESS(iss))
+         iss = CV_DatawayPktAdd(dataway_ps, rd_ctlw, &cam_ps->rd_statd_as[i], bcnt, emask);
+    }/* End of FOR loop */
       
-       /* Clear the inhibit line (ie. I=0). Expect response X=0 and Q=0 */
-       ctlw = (crate << CCTLW__C_shc) | F24A9 | M30;
-       iss  = camadd(&ctlw, &cam_ps->inhibit_stat, &nobcnt, &emask, &cam_ps->pkg_p[ipkg]);
+    /* Clear the inhibit line (ie. I=0). Expect response X=0 and Q=0 */
+    ctlw = (crate << CCTLW__C_shc) | F24A9 | M30;
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(dataway_ps, ctlw, &cam_ps->inhibit_stat, nobcnt, emask);
 
-       /* Read the verifier COMMAND register, to setup for later */
-       iss  = camadd(&rd_ctlw, &cam_ps->rd_statd_as[i], &bcnt, &emask, &cam_ps->pkg_p[ipkg]);
-    }
+    /* Read the verifier COMMAND register, to setup for later */
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(dataway_ps, rd_ctlw, &cam_ps->rd_statd_as[CMD_LINE_NUM], bcnt, emask);
 
     return(iss);
 }
@@ -2507,9 +4232,9 @@ static vmsstat_t   CV_CrateCmdInit2( short branch, short crate, short slot , cam
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        cam_ps                    Dataway camac packages
           Type: struct            and status-data.        
-          Use:  campkg_rw_ts * const
+          Use:  campkg_dataway_ts * const
           Acc:  read-write access
           Mech: By reference
 
@@ -2563,17 +4288,17 @@ static vmsstat_t   CV_CrateCmdInit2( short branch, short crate, short slot , cam
 static vmsstat_t   CV_CrateRWLineInit( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps )
 {
     vmsstat_t                  iss      = CRAT_OKOK;  /* Camac status return                        */
-    vmsstat_t                  iss2     = CRAT_OKOK;  /* Local Camac status return                  */
     unsigned int               clr_ctlw = 0;          /* Camac control word to clear the C-line     */
     unsigned int               wt_ctlw  = 0;          /* Camac control word set the ROTATE register */
     unsigned int               rd_ctlw  = 0;          /* Camac control word read the DATA register  */
     unsigned short             bcnt     = 0;          /* Camac data byte count                      */
     unsigned short             nobcnt   = 0;          /* Camac data byte count of zero              */
-    unsigned short             nops     = 2;          /* Number of Camac operations (pkts)          */
     unsigned short             emask    = CAMAC_EMASK_NOX_NOQ; /* Camac error mask                  */
-    campkg_rlines_walk1_4_ts  *test1_ps  = NULL;
-    campkg_rlines_walk0_4_ts  *test2_ps  = NULL;
-    campkg_wlines_4_ts        *wlines_ps = NULL;
+    unsigned short             type_e   = 0;          /* Walking one or zero                        */
+    unsigned short             i_bit    = 0;          /* Bit under test                             */
+    campkg_rlines_walk1_4_ts  *test1_ps  = &cam_ps->rwlines_s.test1_s;
+    campkg_rlines_walk0_4_ts  *test2_ps  = &cam_ps->rwlines_s.test2_s;
+    campkg_wlines_4_ts        *wlines_ps = &cam_ps->rwlines_s.test3_s;
 
 
     /*
@@ -2586,98 +4311,62 @@ static vmsstat_t   CV_CrateRWLineInit( short branch, short crate, short slot , c
     wt_ctlw  = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F20A3;             /* Set verifier ROTATE register for walking zero */
     rd_ctlw  = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F4A1 | CCTLW__P24; /* Read ROTATE register and rotate pattern left  */
 
-    /* Build the Camac package for test #1, walking one bit with p24. */
-    if ( !cam_ps->rwlines_s.test1_s.pkg_p ) 
-    {
-      /* Allocate Camac packets */
-      test1_ps = &cam_ps->rwlines_s.test1_s;
-      iss = camalo(&nops,&test1_ps->pkg_p); 
-      if (!SUCCESS(iss)) goto egress;
-
-      /* Clear registers on the bus  */
-      iss  = camadd(&clr_ctlw, &test1_ps->stat, &nobcnt, &emask, &test1_ps->pkg_p);
-      if (SUCCESS(iss)) 
-      {
-         /* 
-	  * Read ROTATE register and rotate pattern left.
-	  * The pattern will rotate from R24 to R1 on the 26th read.
-	  * the first read for walking one state will be zero. The next
-	  * read will have a one in R1 and zeros in R24-R2.
-	  * We expected to read 100 bytes of data.
-          */
-         bcnt = sizeof(test1_ps->rd_statd_s.data_a);
-         iss  = camadd(&rd_ctlw, &test1_ps->rd_statd_s, &bcnt, &emask, &test1_ps->pkg_p); 
-         if (!SUCCESS(iss))
-         {
-	    iss2 = camdel( &test1_ps->pkg_p);
-            test1_ps->pkg_p = NULL;
-            return(iss);
-         }
-      }
-    }
-    
-    /* Build the Camac package for a read line test #2, walking zero bit with P24 */
-    if ( !cam_ps->rwlines_s.test2_s.pkg_p ) 
-    {
-       /* Allocate Camac packets*/
-        nops = 3;
-        test2_ps = &cam_ps->rwlines_s.test2_s;
-        iss = camalo(&nops,&test2_ps->pkg_p); 
-        if (!SUCCESS(iss)) goto egress;
+    /* Test #1, walking one bit with p24. Clear registers on the bus  */
+    iss  = CV_DatawayPktAdd(cam_ps, clr_ctlw, &test1_ps->stat, nobcnt, emask);
+
+    /* 
+     * Read ROTATE register and rotate pattern left.
+     * The pattern will rotate from R24 to R1 on the 26th read.
+     * the first read for walking one state will be zero. The next
+     * read will have a one in R1 and zeros in R24-R2.
+     * We expected to read 100 bytes of data.
+     */
+    bcnt = sizeof(test1_ps->rd_statd_s.data_a);
+    if (SUCCESS(iss)) 
+       iss = CV_DatawayPktAdd(cam_ps, rd_ctlw, &test1_ps->rd_statd_s, bcnt, emask);
     
-        /* Clear registers on the bus by pulsing the C-Line. */
-        iss  = camadd(&clr_ctlw, &test2_ps->stat, &nobcnt, &emask, &test2_ps->pkg_p);
+    /* Test #2, walking zero bit with P24. Clear registers on the bus by pulsing the C-Line. */
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps, clr_ctlw, &test2_ps->stat, nobcnt, emask);
 
-        /* Set ROTATE register for walking zero */
-        if (SUCCESS(iss))
-          iss = camadd(&wt_ctlw, &test2_ps->wt_stat, &nobcnt, &emask, &test2_ps->pkg_p); 
+    /* Set ROTATE register for walking zero */
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps, wt_ctlw, &test2_ps->wt_stat, nobcnt, emask);
           
-        /* Read DATA register and rotate pattern left.*/
-        bcnt = sizeof(test2_ps->rd_statd_s.data_a);
-        if (SUCCESS(iss))
-          iss = camadd(&rd_ctlw, &test2_ps->rd_statd_s, &bcnt, &emask, &test2_ps->pkg_p); 
-        if (!SUCCESS(iss))
-	{
-           iss2 = camdel(&test2_ps->pkg_p);
-	   test2_ps->pkg_p = NULL;
-           return(iss);
-        }
-    }
+    /* Read DATA register and rotate pattern left.*/
+    bcnt = sizeof(test2_ps->rd_statd_s.data_a);
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps, rd_ctlw, &test2_ps->rd_statd_s, bcnt, emask);
+
+    /* End of read line test step */
+    if (SUCCESS(iss))
+       iss = CV_DatawayStepEnd(crate,slot,cam_ps);
 
     /*
-     * Build Camac package for test #3, write line 
-     * test with simulated walking one/zero bit and p24
+     * Tests #3 and #4, write line test with simulated walking one/zero bit and p24.
+     * Set and read back the DATA register (P24) once for each bit, the write
+     * data is set by CV_DatawayInitData() before the test is issued.
      */
-    if ( !cam_ps->rwlines_s.test3_s.pkg_p )
+    wt_ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F20A0 | CCTLW__P24;
+    rd_ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F4A0 | CCTLW__P24;
+    for (type_e=0; (type_e<RW_LINE_NUM_TYPE) && SUCCESS(iss); type_e++)
     {
-       /* Allocate Camac packets for write test */
-        nops      = 2;
-        wlines_ps = &cam_ps->rwlines_s.test3_s;
-        iss       = camalo(&nops,&wlines_ps->pkg_p); 
-        if (!SUCCESS(iss)) goto egress;
-
-        /* Set the DATA register (P24) */
-        bcnt = sizeof(wlines_ps->wt_statd_s.data);
-        wt_ctlw = (crate << CCTLW__C_shc) |(slot << CCTLW__M_shc) | F20A0 | CCTLW__P24;
-        iss  = camadd(&wt_ctlw, &wlines_ps->wt_statd_s, &bcnt, &emask, &wlines_ps->pkg_p); 
-
-        /* Read the DATA register (P24) */
-        bcnt = sizeof(wlines_ps->rd_statd_s.data);
-        rd_ctlw  = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F4A0 | CCTLW__P24;
-        if (SUCCESS(iss))
-           iss  = camadd(&rd_ctlw, &wlines_ps->rd_statd_s, &bcnt, &emask, &wlines_ps->pkg_p);
-        if (!SUCCESS(iss))
-        {
-	   iss2 = camdel(&wlines_ps->pkg_p);
-           wlines_ps->pkg_p = NULL;
-           return(iss);
-	}
+       for (i_bit=0; (i_bit<RW_LINE_NUM) && SUCCESS(iss); i_bit++)
+       {
+          bcnt = sizeof(wlines_ps->wt_statd_as[type_e][i_bit].data);
+          iss  = CV_DatawayPktAdd(cam_ps, wt_ctlw, &wlines_ps->wt_statd_as[type_e][i_bit], bcnt, emask);
+          if (SUCCESS(iss))
+             iss = CV_DatawayPktAdd(cam_ps, rd_ctlw, &wlines_ps->rd_statd_as[type_e][i_bit], bcnt, emask);
+       }
     }
 
+    /* End of write line test step */
+    if (SUCCESS(iss))
+       iss = CV_DatawayStepEnd(crate,slot,cam_ps);
+
     if (SUCCESS(iss))
        iss = CV_CrateRWLineInit2(branch,crate,slot,cam_ps);
 
-egress:
     return(iss);
 }
 
@@ -2707,9 +4396,9 @@ egress:
           Acc:  read-only
           Mech: By value
 
-        cam_ps                    Camac block with package pointer 
+        cam_ps                    Dataway camac packages
           Type: struct            and status-data.        
-          Use:  campkg_rw_ts * const
+          Use:  campkg_dataway_ts * const
           Acc:  read-write access
           Mech: By reference
 
@@ -2739,17 +4428,18 @@ egress:
 static vmsstat_t   CV_CrateRWLineInit2( short branch, short crate, short slot , campkg_dataway_ts * const cam_ps )
 {
     vmsstat_t                iss      = CRAT_OKOK;  /* Camac return status                        */
-    vmsstat_t                iss2     = CRAT_OKOK;  /* Local Camac return status                  */
     unsigned int             clr_ctlw = 0;          /* Camac control word to clear the C-line     */
     unsigned int             wt_ctlw  = 0;          /* Camac control word set the ROTATE register */
     unsigned int             rd_ctlw  = 0;          /* Camac control word read the DATA register  */
     unsigned short           bcnt     = 0;          /* Camac data byte count                      */
     unsigned short           nobcnt   = 0;          /* Camac data byte count of zero              */
-    unsigned short           nops     = 2;          /* Number of Camac operations (pkts)          */
     unsigned short           emask    = CAMAC_EMASK_NOX_NOQ;
-    campkg_rlines_walk1_ts  *test5_ps = NULL;
-    campkg_rlines_walk0_ts  *test6_ps = NULL;
-    campkg_wlines_ts        *wlines_ps= NULL;
+    unsigned short           type_e   = 0;          /* Walking one or zero                        */
+    unsigned short           i_bit    = 0;          /* Bit under test                             */
+    unsigned int             clr24_ctlw = 0;        /* Camac control word to clear DATA register  */
+    campkg_rlines_walk1_ts  *test5_ps = &cam_ps->rwlines_s.test5_s;
+    campkg_rlines_walk0_ts  *test6_ps = &cam_ps->rwlines_s.test6_s;
+    campkg_wlines_ts        *wlines_ps= &cam_ps->rwlines_s.test7_s;
 
  
     /*
@@ -2762,97 +4452,64 @@ static vmsstat_t   CV_CrateRWLineInit2( short branch, short crate, short slot ,
     wt_ctlw  = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F20A3;
     rd_ctlw  = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F4A1;
    
-    /* Build the Camac package for test #5, walking one bit without p24. */
-    if ( !cam_ps->rwlines_s.test5_s.pkg_p ) 
-    {
-      /* Allocate Camac packets */
-      test5_ps = &cam_ps->rwlines_s.test5_s;
-      iss = camalo(&nops,&test5_ps->pkg_p); 
-      if (!SUCCESS(iss)) goto egress;
+    /* Test #5, walking one bit without p24. Clear register on the bus  */
+    iss  = CV_DatawayPktAdd(cam_ps, clr_ctlw, &test5_ps->stat, nobcnt, emask);
 
-      /* Clear register on the bus  */
-      iss  = camadd(&clr_ctlw, &test5_ps->stat, &nobcnt, &emask, &test5_ps->pkg_p);
-
-     /* 
-      * Read ROTATE register and rotate pattern left.
-      * Read 34 bytes of data.
-      */
-      bcnt = sizeof(test5_ps->rd_statd_s.data_a);
-      if (SUCCESS(iss))
-         iss  = camadd(&rd_ctlw, &test5_ps->rd_statd_s, &bcnt, &emask, &test5_ps->pkg_p); 
-      if (!SUCCESS(iss))
-      {
- 	  iss2 = camdel( &test5_ps->pkg_p);
-          test5_ps->pkg_p = NULL;
-          return(iss);
-      }
-    }
+   /* 
+    * Read ROTATE register and rotate pattern left.
+    * Read 34 bytes of data.
+    */
+    bcnt = sizeof(test5_ps->rd_statd_s.data_a);
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps, rd_ctlw, &test5_ps->rd_statd_s, bcnt, emask);
     
-    /* Build the Camac package for test #6, walking zero bit without p24. */
-    if ( !cam_ps->rwlines_s.test6_s.pkg_p ) 
-    {
-       /* Allocate Camac packets for setting the ROTATE register */
-        nops = 3;
-        test6_ps = &cam_ps->rwlines_s.test6_s;
-        iss = camalo(&nops,&test6_ps->pkg_p); 
-        if (!SUCCESS(iss)) goto egress;
-
-        /* Clear register on the bus  */
-        iss  = camadd(&clr_ctlw, &test6_ps->stat, &nobcnt, &emask, &test6_ps->pkg_p);
-
-        /* Set the ROTATE register */
-        if (SUCCESS(iss))
-          iss  = camadd(&wt_ctlw, &test6_ps->wt_stat, &nobcnt, &emask, &test6_ps->pkg_p); 
-
-        /* Read the DATA register. Read 18 words, 36 bytes of data */
-        bcnt = sizeof(test6_ps->rd_statd_s.data_a);
-        if (SUCCESS(iss))
-          iss  = camadd(&rd_ctlw, &test6_ps->rd_statd_s, &bcnt, &emask,&test6_ps->pkg_p); 
-        if (!SUCCESS(iss))
-        {
-	   iss2 = camdel( &test6_ps->pkg_p);
-           test6_ps->pkg_p = NULL;
-           return(iss);;
-        }
-    }
+    /* Test #6, walking zero bit without p24. Clear register on the bus  */
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps, clr_ctlw, &test6_ps->stat, nobcnt, emask);
+
+    /* Set the ROTATE register */
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps, wt_ctlw, &test6_ps->wt_stat, nobcnt, emask);
+
+    /* Read the DATA register. Read 18 words, 36 bytes of data */
+    bcnt = sizeof(test6_ps->rd_statd_s.data_a);
+    if (SUCCESS(iss))
+       iss = CV_DatawayPktAdd(cam_ps, rd_ctlw, &test6_ps->rd_statd_s, bcnt, emask);
+
+    /* End of read line test step */
+    if (SUCCESS(iss))
+       iss = CV_DatawayStepEnd(crate,slot,cam_ps);
 
     /*
-     * Build Camac package to issue a write and read of the DATA register.
-     * This package will be used to test write lines.
+     * Tests #7 and #8, write line test with simulated walking one/zero bit
+     * without p24 on the write and with p24 on the read, once for each bit.
+     * Set the DATA register (P24) clearing out the old data from the high 
+     * order bytes, set the DATA register and read it back (P24).
      */
-    if ( !cam_ps->rwlines_s.test7_s.pkg_p )
+    clr24_ctlw = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F20A0 | CCTLW__P24;
+    wt_ctlw    = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F20A0;
+    rd_ctlw    = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F4A0 | CCTLW__P24;
+    for (type_e=0; (type_e<RW_LINE_NUM_TYPE) && SUCCESS(iss); type_e++)
     {
-       /* Allocate Camac packets for write test */
-        nops      = 3;
-        wlines_ps = &cam_ps->rwlines_s.test7_s;
-        iss       = camalo(&nops,&wlines_ps->pkg_p); 
-        if (!SUCCESS(iss)) goto egress;
+       for (i_bit=0; (i_bit<RW_LINE_NUM2) && SUCCESS(iss); i_bit++)
+       {
+          bcnt = sizeof(wlines_ps->clr_statd_as[type_e][i_bit].data);
+          iss  = CV_DatawayPktAdd(cam_ps, clr24_ctlw, &wlines_ps->clr_statd_as[type_e][i_bit], bcnt, emask);
 
-        /* 
-	 * Set the DATA register (P24) clearing out the old data from the high order bytes.
-	 */
-        bcnt    = sizeof(wlines_ps->clr_statd_s.data);
-        wt_ctlw = (crate << CCTLW__C_shc) |(slot << CCTLW__M_shc) | F20A0 | CCTLW__P24;
-        iss     = camadd(&wt_ctlw, &wlines_ps->clr_statd_s, &bcnt, &emask, &wlines_ps->pkg_p); 
-
-        /* Set the DATA register */
-        bcnt    = sizeof(wlines_ps->wt_statd_s.data);
-        wt_ctlw = (crate << CCTLW__C_shc) |(slot << CCTLW__M_shc) | F20A0;
-        iss     = camadd(&wt_ctlw, &wlines_ps->wt_statd_s, &bcnt, &emask, &wlines_ps->pkg_p); 
-
-        /* Read the DATA register (P24) */
-        bcnt = sizeof(wlines_ps->rd_statd_s.data);
-        rd_ctlw  = (crate << CCTLW__C_shc) | (slot << CCTLW__M_shc) | F4A0 | CCTLW__P24;
-        if (SUCCESS(iss)) 
-           iss  = camadd(&rd_ctlw, &wlines_ps->rd_statd_s, &bcnt, &emask, &wlines_ps->pkg_p); 
-        if (!SUCCESS(iss))
-        {
-	   iss2 = camdel( &wlines_ps->pkg_p);
-           wlines_ps->pkg_p = NULL;
-        }
+          bcnt = sizeof(wlines_ps->wt_statd_as[type_e][i_bit].data);
+          if (SUCCESS(iss))
+             iss = CV_DatawayPktAdd(cam_ps, wt_ctlw, &wlines_ps->wt_statd_as[type_e][i_bit], bcnt, emask);
+
+          bcnt = sizeof(wlines_ps->rd_statd_as[type_e][i_bit].data);
+          if (SUCCESS(iss))
+             iss = CV_DatawayPktAdd(cam_ps, rd_ctlw, &wlines_ps->rd_statd_as[type_e][i_bit], bcnt, emask);
+       }
     }
 
- egress:
+    /* End of write line test step */
+    if (SUCCESS(iss))
+       iss = CV_DatawayStepEnd(crate,slot,cam_ps);
+
     return(iss);
 }
 
@@ -2895,12 +4552,7 @@ static vmsstat_t   CV_CrateRWLineInit2( short branch, short crate, short slot ,
 =======================================================*/ 
 static long  CV_ReadVoltage(CV_MODULE  * const module_ps )
 {
-    CV_VOLT_MULT;
     vmsstat_t           iss     = CRAT_NOTVALID;
-    unsigned short      i       = 0;
-    short               rval    = 0;
-    float               slope   = CV_ANLG_SLOPE;
-    float               zero    = CV_ANLG_ZERO;  
     campkg_volts_ts    *cam_ps  = NULL;
 
   
@@ -2910,7 +4562,6 @@ static long  CV_ReadVoltage(CV_MODULE  * const module_ps )
     /* Initalize Camac package status and data. */
     cam_ps = &module_ps->cam_s.rd_volts_s;
     memset(cam_ps->statd_as,0,sizeof(cam_ps->statd_as));
-    memset(module_ps->crate_s.volts_a,0,sizeof(module_ps->crate_s.volts_a));
 
     /* Initialize the Camac package it it has not already been done */
     iss = CRAT_OKOK;
@@ -2925,16 +4576,9 @@ static long  CV_ReadVoltage(CV_MODULE  * const module_ps )
        epicsMutexUnlock(module_ps->crate_s.mlock); 
 
        /* Read crate voltages, ground voltage and temperature */
-       iss = camgo(&cam_ps->pkg_p); 
+       iss = CV_TraceCamgo(module_ps,CAMAC_RD_VOLTS,CV_PKG_RD_VOLTS,&cam_ps->pkg_p,&cam_ps->statd_as[0].stat); 
        if ( SUCCESS(iss))
-       {
-          for (i=0;(i<CV_NUM_ANLG_CHANNELS) && SUCCESS(iss);i++)
-          {
-             rval = cam_ps->statd_as[i].data & CV_ANLG_MASK;
-             module_ps->crate_s.volts_a[i] = (slope * rval - zero)  * vmult_as[i].m1;
-          }
-          module_ps->crate_s.volts_a[A7] *= vmult_as[A7].m2;
-       }
+          CV_VoltsConvert( module_ps, cam_ps->statd_as );
        else
        {
           epicsMutexMustLock(module_ps->crate_s.mlock);  
@@ -2951,6 +4595,63 @@ egress:
 
 
 
+
+/*====================================================
+ 
+  Abs:  Convert Analog Voltage Register Data
+ 
+  Name: CV_VoltsConvert
+ 
+  Args: module_ps               Module information
+          Type: pointer            
+          Use:  CV_MODULE * const
+          Acc:  read-write access
+          Mech: By reference
+
+        statd_as                Analog register status-data
+          Type: array           Note: CV_NUM_ANLG_CHANNELS elements
+          Use:  statd_2_ts const * const
+          Acc:  read-only
+          Mech: By reference
+
+  Rem:  The purpose of this function is to convert the
+        analog voltage registers read by the voltage package
+        or the dataway test package to volts, by lookup in
+        the module's conversion table (see CVVolts.c), and 
+        to publish them as the crate's current sample.
+
+  Side: The sample is filled before its index is made current,
+        under the crate lock, which orders the stores of the
+        sample before the store of the index. Readers take
+        no lock.
+  
+  Ret:  None
+
+=======================================================*/ 
+static void  CV_VoltsConvert( CV_MODULE * const module_ps, statd_2_ts const * const statd_as )
+{
+    cv_volt_lut_ts const *lut_ps    = module_ps->vlut_ps;
+    cv_volt_sample_ts    *sample_ps = NULL;
+    unsigned short        next      = 0;
+    unsigned short        i         = 0;
+
+    next      = (module_ps->crate_s.vcur + 1) % CV_VOLT_NUM_SAMPLE;
+    sample_ps = &module_ps->crate_s.vsample_as[next];
+    epicsTimeGetCurrent(&sample_ps->time);
+    for (i=0; i<CV_NUM_ANLG_CHANNELS; i++)
+    {
+       sample_ps->raw_a[i]   = statd_as[i].data & CV_ANLG_MASK;
+       sample_ps->stat_a[i]  = statd_as[i].stat;
+       sample_ps->volts_a[i] = lut_ps->volts_a[i][sample_ps->raw_a[i]];
+    }
+
+    /* Make the new sample current */
+    epicsMutexMustLock(module_ps->crate_s.mlock);
+    module_ps->crate_s.vcur = next;
+    epicsMutexUnlock(module_ps->crate_s.mlock);
+    return;
+}
+
 /*====================================================
  
   Abs:  Read Identification Register
@@ -3012,14 +4713,14 @@ static long  CV_ReadId(CV_MODULE * const module_ps )
     {
        cam_ps->statd_s.stat = 0;
        cam_ps->statd_s.data = 0;
-       iss = camgo(&cam_ps->pkg_p);
+       iss = CV_TraceCamgo(module_ps,CAMAC_RD_ID,CV_PKG_RD_ID,&cam_ps->pkg_p,&cam_ps->statd_s.stat);
        if (SUCCESS(iss))
        {
           epicsMutexMustLock(module_ps->crate_s.mlock);
           module_ps->crate_s.flag_e = CV_CRATEON;
+          module_ps->id = cam_ps->statd_s.data & CV_ID_MASK;
           epicsMutexUnlock(module_ps->crate_s.mlock);
 
-          module_ps->id = cam_ps->statd_s.data & CV_ID_MASK;
           if (module_ps->c == module_ps->id)
 	     module_ps->crate_s.idErr = epicsTrue;
        }
@@ -3090,7 +4791,7 @@ static long  CV_ReadData(CV_MODULE * const module_ps)
 	* issuing the double-read of the DATA register
         */
        memset(cam_ps->statd_as,0,sizeof(cam_ps->statd_as));
-       iss = camgo(&cam_ps->pkg_p);
+       iss = CV_TraceCamgo(module_ps,CAMAC_RD_DATA,CV_PKG_RD_DATA,&cam_ps->pkg_p,&cam_ps->statd_as[1].stat);
 
        /* 
 	* Check if the data register contains the expected
@@ -3185,6 +4886,7 @@ static long CV_IsCrateOnline( CV_MODULE * const module_ps )
     vmsstat_t                   rd_iss  = CRAT_OKOK;
     vmsstat_t                   wt_iss  = CRAT_OKOK;
     unsigned short              bothReadsFailed = 0;
+    epicsBoolean                patternOk = epicsFalse;
     static const unsigned short mask  = CRATE_STATUS_RDATA_ERR;
     static const unsigned short i_wt    = 0;
     static const unsigned short i_rbk   = 1;
@@ -3197,10 +4899,11 @@ static long CV_IsCrateOnline( CV_MODULE * const module_ps )
 
    /*
     * Save the previous crate status and clear current status 
-    * saving only the last crate online and init status.
+    * saving only the last crate init status, so that a crate
+    * that is still initialized is not initialized again.
     */
     module_ps->crate_s.prev_stat_u._i = module_ps->crate_s.stat_u._i; 
-    module_ps->crate_s.stat_u._i      = 0;
+    module_ps->crate_s.stat_u._i     &= CRATE_STATUS_ONINIT;
 
     /*
      * Build the camack package to read the data register 
@@ -3222,25 +4925,26 @@ static long CV_IsCrateOnline( CV_MODULE * const module_ps )
        rd_iss = module_ps->mstat_as[CAMAC_RD_DATA].errCode;
 
       /*
-       * At least we don't have crate timeout on both reads. Write
-       * and read back the verifier module's data register, but
-       * also retain what we just read.  See whether 
-       * we can succeed once of at most 6 tries. 
+       * At least we don't have crate timeout on both reads. If both
+       * reads returned the pattern, the DATA register has kept it since
+       * the last watch, so there is nothing to rewrite and the double-read
+       * package is the only Camac access for this watch.
        *
-       * Please note, that even if the DATA register contains
-       * the pattern we expect, on both reads, we still will
-       * be writting the PATTERN to the DATA register and
-       * verifying the readback.
+       * Otherwise, write and read back the verifier module's data
+       * register, but also retain what we just read. See whether 
+       * we can succeed once of at most 6 tries. 
        *
        * So don't mark the crate online yet...let's
        * see what happens later after we try to write
        * to the data register.  
-       * 
-       * Write a pattern to the data register 
        */
-       CV_ClrMsgStatus(&module_ps->mstat_as[CAMAC_WT_DATA]);
-       status = CV_WriteData( module_ps, module_ps->pattern ); 
-       wt_iss = module_ps->mstat_as[CAMAC_WT_DATA].errCode;  
+       patternOk = SUCCESS(rd_iss) && !(module_ps->crate_s.stat_u._i & mask);
+       if ( !patternOk || module_ps->crate_s.first_watch )
+       {
+          CV_ClrMsgStatus(&module_ps->mstat_as[CAMAC_WT_DATA]);
+          status = CV_WriteData( module_ps, module_ps->pattern ); 
+          wt_iss = module_ps->mstat_as[CAMAC_WT_DATA].errCode;  
+       }
        if ( SUCCESS(wt_iss) && (module_ps->crate_s.flag_e==CV_CRATEON) )
        {
          /*
@@ -3252,7 +4956,13 @@ static long CV_IsCrateOnline( CV_MODULE * const module_ps )
 	  */
          bothReadsFailed = module_ps->crate_s.stat_u._i & mask;
          if ( module_ps->crate_s.first_watch )
-            iss = CV_CrateInit(module_ps,epicsTrue);
+         {
+            /* Don't pulse Z on a crate kept running since the last snapshot */
+            if ( module_ps->crate_s.warm )
+               CV_LogPost(CV_LOG_WARMSTART,module_ps->c,module_ps->n,0,0,0,0);
+            iss = CV_CrateInit(module_ps,(module_ps->crate_s.warm)?epicsFalse:epicsTrue);
+            module_ps->crate_s.warm = epicsFalse;
+         }
 	 else if ( bothReadsFailed || !module_ps->crate_s.stat_u._s.init )
 	    iss = CV_CrateInit(module_ps,epicsFalse); 
        }
@@ -3266,7 +4976,7 @@ static long CV_IsCrateOnline( CV_MODULE * const module_ps )
        {
           iss = CRAT_CANTINIT;
           if (module_ps->crate_s.first_watch || module_ps->crate_s.prev_stat_u._s.online)
-             errlogSevPrintf(errlogMajor,CRAT_CANTINIT_MSG,module_ps->c); 
+             CV_LogPost(CV_LOG_CANTINIT,module_ps->c,module_ps->n,0,0,0,0); 
        }
       /*
        * Crate doesn't respond or verifier module is bad, and  
@@ -3287,12 +4997,11 @@ static long CV_IsCrateOnline( CV_MODULE * const module_ps )
 	     * crate wasn't off on the last check.
 	     */
             if (!module_ps->crate_s.prev_stat_u._s.dataWtErr)
-	      errlogSevPrintf(errlogMajor,
-                              CRAT_OFFVER_MSG,
-                              module_ps->c,
-                              cam_ps->statd_as[i_wt].data,
-                              cam_ps->statd_as[i_rbk].data & CV_DATA_MASK,
-                              cam_ps->statd_as[i_rbk].stat); 
+	      CV_LogPost(CV_LOG_OFFVER,
+                         module_ps->c,module_ps->n,
+                         cam_ps->statd_as[i_wt].data,
+                         cam_ps->statd_as[i_rbk].data & CV_DATA_MASK,
+                         cam_ps->statd_as[i_rbk].stat,0); 
 	 }
          else
 	 {
@@ -3300,11 +5009,9 @@ static long CV_IsCrateOnline( CV_MODULE * const module_ps )
             iss = CRAT_CHNGSTAT;
             cam_ps = &module_ps->cam_s.wt_data_s;
             if (!module_ps->crate_s.prev_stat_u._s.online)
-	      errlogSevPrintf(errlogInfo,
-                              CRAT_CHNGSTAT_MSG,
-                              module_ps->c,
-                              "ON",
-                              cam_ps->statd_as[0].stat );
+	      CV_LogPost(CV_LOG_CHNGSTAT,
+                         module_ps->c,module_ps->n,
+                         cam_ps->statd_as[0].stat,0,0,0 );
 	 }
        }
     }
@@ -3418,8 +5125,8 @@ static vmsstat_t CV_CheckReadData( CV_MODULE * const module_ps, vmsstat_t status
 	  */
           if ((data1==module_ps->pattern) && (data2==module_ps->pattern))
 	  {
-               module_ps->data = data1;
                epicsMutexMustLock(module_ps->crate_s.mlock );
+               module_ps->data = data1;
                module_ps->crate_s.stat_u._s.offOnTransition = 0;
                epicsMutexUnlock(module_ps->crate_s.mlock );
 	  }
@@ -3428,8 +5135,8 @@ static vmsstat_t CV_CheckReadData( CV_MODULE * const module_ps, vmsstat_t status
                module_ps->crate_s.stat_u._s.init = 0;
                if ((data1!=module_ps->pattern) && (data2!=module_ps->pattern))
 	       {
-		    module_ps->data = data1; /* save the date read from register */
                     epicsMutexMustLock(module_ps->crate_s.mlock );
+		    module_ps->data = data1; /* save the date read from register */
                     module_ps->crate_s.stat_u._s.offOnTransition = 1;
                     module_ps->crate_s.stat_u._i |= CRATE_STATUS_RDATA_ERR;
                     epicsMutexUnlock(module_ps->crate_s.mlock );
@@ -3441,14 +5148,13 @@ static vmsstat_t CV_CheckReadData( CV_MODULE * const module_ps, vmsstat_t status
                     if ( !module_ps->crate_s.first_watch           && 
                           module_ps->crate_s.prev_stat_u._s.online &&
 		        ( module_ps->crate_s.prev_stat_u._s.dataRdErr != module_ps->crate_s.stat_u._s.dataRdErr ))
-	            	errlogSevPrintf( errlogMajor,
-                                         CRAT_VERDAT_MSG,
-                                         module_ps->c,
-                                         module_ps->n,
-                                         data1,
-                                         camstat1_u._i,
-                                         data2,
-                                         camstat2_u._i );
+	            	CV_LogPost( CV_LOG_VERDAT,
+                                    module_ps->c,
+                                    module_ps->n,
+                                    data1,
+                                    camstat1_u._i,
+                                    data2,
+                                    camstat2_u._i );
 	       }
 
                /* Ok, so did the first read have an unexpected pattern? */
@@ -3459,12 +5165,12 @@ static vmsstat_t CV_CheckReadData( CV_MODULE * const module_ps, vmsstat_t status
 	             * which will'll updated in the database. Log a message if we didn't
 	             * see this error on our last check, unless we are booting.
 	             */
-	            module_ps->data = data1;
                     epicsMutexMustLock(module_ps->crate_s.mlock );
+	            module_ps->data = data1;
                     module_ps->crate_s.stat_u._i |= CRATE_STATUS_R1DATA_ERR;;
                     epicsMutexUnlock(module_ps->crate_s.mlock );
                     if ( !(module_ps->crate_s.prev_stat_u._s.dataRdErr & CRATE_STATUS_R1DATA_ERR) )
-                          errlogSevPrintf( errlogMajor,CRAT_VERDAT1_MSG,i,module_ps->c,module_ps->n,data1,camstat1_u._i );
+                          CV_LogPost( CV_LOG_VERDAT1,module_ps->c,module_ps->n,i,data1,camstat1_u._i,0 );
 	       }
               /* 
 	       * The first read was good...how about the second read
@@ -3478,12 +5184,12 @@ static vmsstat_t CV_CheckReadData( CV_MODULE * const module_ps, vmsstat_t status
 	             * see this error on our last check, unless we are booting.
 	             */
                     i=2;
-	            module_ps->data = data2;
                     epicsMutexMustLock(module_ps->crate_s.mlock );
+	            module_ps->data = data2;
                     module_ps->crate_s.stat_u._i |= CRATE_STATUS_R2DATA_ERR;;
                     epicsMutexUnlock(module_ps->crate_s.mlock );
                     if ( !(module_ps->crate_s.prev_stat_u._s.dataRdErr & CRATE_STATUS_R2DATA_ERR) )
-                         errlogSevPrintf( errlogMajor,CRAT_VERDAT1_MSG,i,module_ps->c,module_ps->n,data1,camstat2_u._i );
+                         CV_LogPost( CV_LOG_VERDAT1,module_ps->c,module_ps->n,i,data1,camstat2_u._i,0 );
 	       }
             
               /*
@@ -3493,7 +5199,7 @@ static vmsstat_t CV_CheckReadData( CV_MODULE * const module_ps, vmsstat_t status
 	       * Please note, that we haven't initalized the crate yet. 
 	       */
                if ( module_ps->crate_s.stat_u._s.offOnTransition && !module_ps->crate_s.first_watch )
-                  errlogSevPrintf(errlogInfo,CRAT_OFFON_MSG,module_ps->c,data1,camstat1_u._i );
+                  CV_LogPost(CV_LOG_OFFON,module_ps->c,module_ps->n,data1,camstat1_u._i,0,0 );
 	  }
      }
      else
@@ -3514,7 +5220,7 @@ static vmsstat_t CV_CheckReadData( CV_MODULE * const module_ps, vmsstat_t status
          /* Issue a message to the log if we're booting or the crate was previously online */
          iss = CRAT_CANTINIT;
          if (module_ps->crate_s.first_watch || module_ps->crate_s.prev_stat_u._s.online)
-           errlogSevPrintf(errlogMajor,CRAT_CANTINIT_MSG,module_ps->c);    
+           CV_LogPost(CV_LOG_CANTINIT,module_ps->c,module_ps->n,0,0,0,0);    
      }
 
      return(iss);
@@ -3592,7 +5298,7 @@ static long  CV_WriteData(CV_MODULE * const module_ps, unsigned long data )
 	  cam_ps->statd_as[i_wt].stat  = 0;  /* clear write operartion camac status    */    
 	  cam_ps->statd_as[i_rbk].stat = 0;  /* clear read back operartion camac status */
 	  cam_ps->statd_as[i_rbk].data = 0;  /* clear write operartion data             */
-          iss = camgo(&cam_ps->pkg_p);
+          iss = CV_TraceCamgo(module_ps,CAMAC_WT_DATA,CV_PKG_WT_DATA,&cam_ps->pkg_p,&cam_ps->statd_as[i_rbk].stat);
           if (SUCCESS(iss))
 	  {
 	     rbk_data = cam_ps->statd_as[i_rbk].data & CV_DATA_MASK;
@@ -3641,24 +5347,42 @@ egress:
           Acc:  read-write access
           Mech: By reference
 
+        slice_e                  Issue one step only
+          Type: enum             Note: epicsFalse = whole test
+          Use:  epicsBoolean
+          Acc:  read-only
+          Mech: By value
+
 
   Rem:  The purpose of this function is to perform
-        the Camac crate verification test.
+        the Camac crate verification test. The test is
+        issued as the dataway packages, one step at a time, 
+        after which the X and Q responses and the data of each 
+        part of the test are checked from the status-data.
 
-  Side: None
+        When slice_e is set, only the next step is issued and
+        the function returns, leaving the test in progress until
+        the last step is issued by a later call. This lets the
+        periodic test be spread over the minute so that no 
+        10 second poll waits for the whole test.
+
+  Side: The message status is only marked complete when the
+        last step has been issued or the test failed.
 
   Ret:  long
             OK    - Successfully completed
             ERROR - Opereation failed
            
 =======================================================*/ 
-static long  CV_TestDataway(CV_MODULE * const module_ps)
+static long  CV_TestDataway(CV_MODULE * const module_ps, epicsBoolean slice_e)
 { 
     vmsstat_t           iss     = CRAT_NOTVALID;      /* return status             */
     vmsstat_t           iss_wt  = CRAT_OKOK;          /* return status             */
     unsigned short      i_wt    = 0;                  /* index into wt stat-data   */
-    long                status  = OK;                 /* local status              */
+    unsigned short      ipkg    = 0;                  /* dataway package index     */
+    unsigned short      npkg    = 0;                  /* end of step package index */
     unsigned int        stat    = 0;                  /* Camac status              */
+    epicsBoolean        done    = epicsFalse;         /* all packages completed    */
     campkg_dataway_ts  *cam_ps = NULL;                /* pointer to camac info     */
     campkg_data_ts     *cam_data_ps = NULL;           /* write data register       */
  
@@ -3682,72 +5406,97 @@ static long  CV_TestDataway(CV_MODULE * const module_ps)
        /*
 	* First, clear the data buffers for 
 	* the tests that are to follow, which include the
-	* Command Line, Read Line and Write Line tests
+	* Command Line, Read Line and Write Line tests.
+        * Only done at the start of the test.
 	*/
-       CV_DatawayInitData(module_ps);
+       if (!cam_ps->step)
+         CV_DatawayInitData(module_ps);
        
-       /* Pulse the C-Line to clear the registers on the bus */
-       iss = camgo(&cam_ps->pulseC_s.pkg_p);
-
-       /* Clear the Inhibit Line on the bus */
-       iss = camgo(&cam_ps->inhibit_s.pkg_p);
+       /* 
+        * Issue the next step of the test, or all of the remaining steps:
+        *   C-line, inhibit, SCC, command lines and id register,
+        *   read lines, write lines (with and without P24) and voltages.
+        * Each step ends by leaving the test pattern in the DATA register.
+        */
+       do
+       {
+          ipkg = (cam_ps->step)?cam_ps->stepEnd_a[cam_ps->step-1]:0;
+          npkg = cam_ps->stepEnd_a[cam_ps->step];
+          for (; (ipkg<npkg) && SUCCESS(iss); ipkg++)
+             iss = CV_TraceCamgo(module_ps,CAMAC_TST_DATAWAY,CV_PKG_DATAWAY,&cam_ps->pkg_p[ipkg],cam_ps->stat_p[ipkg]);
+          if (SUCCESS(iss)) cam_ps->step++;
+       } while (!slice_e && SUCCESS(iss) && (cam_ps->step<CV_DATAWAY_NUM_STEP));
 
        /* Check for a bad crate address (id) or a crate offline. */
-       iss = camgo(&cam_ps->scc_s.pkg_p);
        if ((iss==CAM_MBCD_NFG) || (iss==CAM_SOFT_TO) || (iss==CAM_CRATE_TO)) 
        {
 	  cam_ps->timeout = epicsTrue;
           goto egress;
        }
+       if (!SUCCESS(iss))
+          goto egress;
 
-       /* Check for the correct X-response, X=0.*/
-       stat = cam_ps->scc_s.statd_s.stat;
+       /* The test is still in progress, the pattern has been left in the DATA register */
+       if (cam_ps->step<CV_DATAWAY_NUM_STEP)
+          return(OK);
+       done = epicsTrue;
+
+       /* Check for the correct X-response from the SCC, X=0.*/
+       stat = cam_ps->scc_statd_s.stat;
        if ((stat & MBCD_STAT__X)==MBCD_STAT__X)
        {
 	  cam_ps->Xstat_s.was_one = 1;  /* X-response returned "1" incorrectly */
           cam_ps->Xstat_s.err     = epicsTrue;
        }
        
-       /* Perform Camac Bus Command Line Test */
+       /* Check the Camac Bus Command Line Test */
        iss = CV_CrateCmdLine(module_ps);
-       if (!SUCCESS(iss)) 
-           goto egress;
 
-       /* Read the module Id register. Here we are checking for Q=1 */
+       /* Check the module Id register. Here we are checking for Q=1 */
        CV_ClrMsgStatus( &module_ps->mstat_as[CAMAC_RD_ID] );
-       status = CV_ReadId(module_ps);
-       stat   = module_ps->cam_s.rd_id_s.statd_s.stat;
+       stat = cam_ps->id_statd_s.stat;
        if ((stat & MBCD_STAT__Q)==0)
        {
          cam_ps->Qstat_s.was_zero = 1;
          cam_ps->Qstat_s.err      = epicsTrue;
        }
+       epicsMutexMustLock(module_ps->crate_s.mlock);
+       module_ps->crate_s.flag_e = CV_CRATEON;
+       module_ps->id = cam_ps->id_statd_s.data & CV_ID_MASK;
+       epicsMutexUnlock(module_ps->crate_s.mlock);
+       module_ps->crate_s.idErr = (module_ps->c == module_ps->id)?epicsTrue:epicsFalse;
+       CV_SetMsgStatus( CRAT_OKOK,&module_ps->mstat_as[CAMAC_RD_ID] );
       
-       /* Perform Camac Bus Read-Write Line Test */
+       /* Check the Camac Bus Read-Write Line Test */
        iss = CV_CrateRWLine(module_ps);
 
-       /* Read crate voltages */
+       /* Crate voltages */
        CV_ClrMsgStatus( &module_ps->mstat_as[CAMAC_RD_VOLTS] );
-       status = CV_ReadVoltage(module_ps);    
+       CV_VoltsConvert( module_ps, cam_ps->volts_as );
+       CV_SetMsgStatus( CRAT_OKOK,&module_ps->mstat_as[CAMAC_RD_VOLTS] );
     }
 
 egress:
+    /* The next test starts over with the first step */
+    if (cam_ps) cam_ps->step = 0;
+
     /* 
      * Leave test pattern in data register for periodic crate online status checking 
-     * Don't bother checking the readback.
+     * Don't bother checking the readback. This is the last packet of each dataway 
+     * step, so only needs to be done here if they did not all complete.
      */
     CV_ClrMsgStatus(&module_ps->mstat_as[CAMAC_WT_DATA]);
     cam_data_ps = &module_ps->cam_s.wt_data_s;
-    if (!cam_data_ps->pkg_p) 
+    if (!done && !cam_data_ps->pkg_p) 
       iss_wt = CV_WriteDataInit( module_ps->b, module_ps->c, module_ps->n,cam_data_ps );
-    if (SUCCESS(iss_wt)) 
+    if (!done && SUCCESS(iss_wt)) 
     {
       /*  
        * Write and read back the  verifier module's data register,
        * Make up to 6 attempts to write the data successfully.
        */   
        cam_data_ps->statd_as[i_wt].data = module_ps->pattern & CV_DATA_MASK;       
-       iss_wt = camgo(&cam_data_ps->pkg_p);
+       iss_wt = CV_TraceCamgo(module_ps,CAMAC_WT_DATA,CV_PKG_WT_DATA,&cam_data_ps->pkg_p,&cam_data_ps->statd_as[1].stat);
     }
 
     /* Set camac bus status summary bitmask (pv) */
@@ -3813,7 +5562,7 @@ static vmsstat_t  CV_SetBusStatus( CV_MODULE * const module_ps )
 
 /*====================================================
  
-  Abs:  Perform the Camac bus Command Line Test 
+  Abs:  Check the Camac bus Command Line Test 
  
   Name: CV_CrateCmdLine
  
@@ -3823,16 +5572,16 @@ static vmsstat_t  CV_SetBusStatus( CV_MODULE * const module_ps )
           Acc:  read-write access
           Mech: By reference
 
-  Rem:  The purpose of this function is to peform
-        the Camac bus Comand Line test and verifiy that
-        the lines were correct, and set and error flag
-        in the module structure if a failure occurred.
+  Rem:  The purpose of this function is to check
+        the results of the Camac bus Comand Line test, issued 
+        by the dataway package, verifiy that the lines were 
+        correct, and set and error flag in the module structure 
+        if a failure occurred.
 
   Side: None
 
   Ret:  vmsstat_t
-           see return codes from
-                camgo()
+           CRAT_OKOK - Successful operation
             
 =======================================================*/ 
 static vmsstat_t CV_CrateCmdLine( CV_MODULE * const module_ps )
@@ -3847,11 +5596,8 @@ static vmsstat_t CV_CrateCmdLine( CV_MODULE * const module_ps )
     campkg_dataway_ts          *cam_ps = NULL;       /* pointer to camac package info */
 
 
-    /* Perform command line test */
+    /* The command line test has been issued as part of the dataway package */
     cam_ps = &module_ps->cam_s.dataway_s;
-    iss = camgo(&cam_ps->cmd_s.pkg_p[0]);                     /* command line test pkg #1 */
-    if (SUCCESS(iss))  iss = camgo(&cam_ps->cmd_s.pkg_p[1]);  /* command line test pkg #2 */
-    if (!SUCCESS(iss)) goto egress;
 
     /* Get read data from command line test */
     for (i=0,lineNo=1; i<CMD_LINE_NUM; i++,lineNo<<=1)
@@ -3866,7 +5612,7 @@ static vmsstat_t CV_CrateCmdLine( CV_MODULE * const module_ps )
 	 cam_ps->cmdLineErr = epicsTrue;
 
        /* save the data */
-       module_ps->cmdLine_s.data_a[i] = data;
+       module_ps->diag_ps->cmdLine_s.data_a[i] = data;
     }/* End of FOR loop */
 
     /*
@@ -3890,15 +5636,13 @@ static vmsstat_t CV_CrateCmdLine( CV_MODULE * const module_ps )
        cam_ps->Qstat_s.err = epicsTrue;
     }
 
-egress:
-
     return(iss);
 }
 
 
 /*====================================================
  
-  Abs:  Perform the Camac bus Read Write Line Test 
+  Abs:  Check the Camac bus Read Write Line Test 
  
   Name: CV_CrateRWLine
  
@@ -3908,10 +5652,11 @@ egress:
           Acc:  read-write access
           Mech: By reference
 
-  Rem:  The purpose of this function is to peform
-        the Camac bus Comand Line test and verifiy that
-        the lines were correct, and set and error flag
-        in the module structure if a failure occurred.
+  Rem:  The purpose of this function is to check the
+        results of the Camac bus Read Write Line tests, issued
+        by the dataway package, in test order and verifiy that 
+        the lines were correct, and set and error flag in the 
+        module structure if a failure occurred.
 
   Side: None
 
@@ -3922,23 +5667,18 @@ egress:
 =======================================================*/ 
 static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
 {   
-    RW_LINE_OK;
     vmsstat_t           iss        = CRAT_OKOK;      /* Return status                        */
-    vmsstat_t           iss2       = CRAT_OKOK;      /* local return status                  */
     unsigned long       status     = OK;             /* local return status                  */
     unsigned short      i_bit      = 0;              /* index counter                        */
-   
-    unsigned short     *wt_sdata_p = NULL;           /* ptr to write data in write line test */ 
-    unsigned long      *wt_data_p  = NULL;           /* ptr to write data in write line test */
-    unsigned long      *rd_data_p  = NULL;           /* ptr to read data in write line test  */
 
     campkg_rwlines_ts  *cam_ps    = NULL;            /* pointer to camac package info        */
     campkg_dataway_ts *dataway_ps = NULL;            /* Dataway test camac packages          */
     unsigned short    *sdata_a    = NULL;            /* Pointer to 16-bit word array         */
     unsigned long     *data_a     = NULL;            /* Pointer to 32-bit word array         */
-    unsigned long      stat       = 0;               /* Camac package status                 */    
+    campkg_nodata_ts  *pulse_ps   = NULL;            /* package to pulse the C-line          */
     unsigned int       ctlw       = 0;               /* Camac control word                   */
     unsigned short     nobcnt     = 0;               /* Camac data byte count of zero        */
+    unsigned short     nops       = 1;               /* Camac packets in package             */
     unsigned short     emask  = CAMAC_EMASK_NOX_NOQ; /* Camac error mask, NOX and NOQ        */
 
 
@@ -3951,25 +5691,24 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
    /* 
     * Perform the Read Write  Line test #1 using walking one bit and P24
     */
-    memset(module_ps->rwLine_s.data_a,0,sizeof(module_ps->rwLine_s.data_a));
-    memset(module_ps->rwLine_s.err_a,0,sizeof(module_ps->rwLine_s.err_a));
-    memset(module_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->rwLine_s.expected_data_a));
-    module_ps->rwLine_s.type_e = type_e;
-    module_ps->rwLine_s.test   = test;
+    memset(module_ps->diag_ps->rwLine_s.data_a,0,sizeof(module_ps->diag_ps->rwLine_s.data_a));
+    memset(module_ps->diag_ps->rwLine_s.err_a,0,sizeof(module_ps->diag_ps->rwLine_s.err_a));
+    memset(module_ps->diag_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->diag_ps->rwLine_s.expected_data_a));
+    module_ps->diag_ps->rwLine_s.type_e = type_e;
+    module_ps->diag_ps->rwLine_s.test   = test;
 
     dataway_ps = &module_ps->cam_s.dataway_s;
     cam_ps     = &dataway_ps->rwlines_s;
-    iss        = camgo(&cam_ps->test1_s.pkg_p);
 
     data_a  = cam_ps->test1_s.rd_statd_s.data_a;
     for (i_bit=0; i_bit<nbits; i_bit++)
-      module_ps->rwLine_s.data_a[i_bit] = data_a[i_bit];
+      module_ps->diag_ps->rwLine_s.data_a[i_bit] = data_a[i_bit];
     status = CV_RWDataGet(type_e, 
                           nbits, 
                           NULL, 
-                          module_ps->rwLine_s.data_a,
-                          module_ps->rwLine_s.err_a,
-                          module_ps->rwLine_s.expected_data_a);
+                          module_ps->diag_ps->rwLine_s.data_a,
+                          module_ps->diag_ps->rwLine_s.err_a,
+                          module_ps->diag_ps->rwLine_s.expected_data_a);
     if (CV_DRV_DEBUG && status)
     {
        printf("CV[%hd %hd %hd]\n",module_ps->b,module_ps->c,module_ps->n);
@@ -3981,9 +5720,9 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
        for (i_bit=0; i_bit<nbits; i_bit++)
          printf("\t(%.2d):  data=0x%8.8lx  expected=0x%8.8lx\t%s\n",
                i_bit,
-               module_ps->rwLine_s.data_a[i_bit],
-               module_ps->rwLine_s.expected_data_a[i_bit],
-              (module_ps->rwLine_s.err_a[i_bit])?"Error":"");
+               module_ps->diag_ps->rwLine_s.data_a[i_bit],
+               module_ps->diag_ps->rwLine_s.expected_data_a[i_bit],
+              (module_ps->diag_ps->rwLine_s.err_a[i_bit])?"Error":"");
        printf("\n");
     }
     if (status) goto egress;
@@ -3993,23 +5732,21 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
      */
     test++;
     type_e = WALKING_ZERO;
-    memset(module_ps->rwLine_s.data_a,0,sizeof(module_ps->rwLine_s.data_a));
-    memset(module_ps->rwLine_s.err_a,0,sizeof(module_ps->rwLine_s.err_a));
-    memset(module_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->rwLine_s.expected_data_a));
-    module_ps->rwLine_s.type_e = type_e;
-    module_ps->rwLine_s.test   = test;
+    memset(module_ps->diag_ps->rwLine_s.data_a,0,sizeof(module_ps->diag_ps->rwLine_s.data_a));
+    memset(module_ps->diag_ps->rwLine_s.err_a,0,sizeof(module_ps->diag_ps->rwLine_s.err_a));
+    memset(module_ps->diag_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->diag_ps->rwLine_s.expected_data_a));
+    module_ps->diag_ps->rwLine_s.type_e = type_e;
+    module_ps->diag_ps->rwLine_s.test   = test;
 
-    iss    = camgo(&cam_ps->test2_s.pkg_p);
- 
     data_a = cam_ps->test2_s.rd_statd_s.data_a;
     for (i_bit=0; i_bit<nbits; i_bit++)
-      module_ps->rwLine_s.data_a[i_bit] = data_a[i_bit];
+      module_ps->diag_ps->rwLine_s.data_a[i_bit] = data_a[i_bit];
     status = CV_RWDataGet(type_e, 
                           nbits, 
                           NULL, 
-                          module_ps->rwLine_s.data_a,
-                          module_ps->rwLine_s.err_a,
-                          module_ps->rwLine_s.expected_data_a);
+                          module_ps->diag_ps->rwLine_s.data_a,
+                          module_ps->diag_ps->rwLine_s.err_a,
+                          module_ps->diag_ps->rwLine_s.expected_data_a);
     if (CV_DRV_DEBUG && status)
     {
        printf("CV[%hd %hd %hd]\n",module_ps->b,module_ps->c,module_ps->n);
@@ -4021,9 +5758,9 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
        for (i_bit=0; i_bit<nbits; i_bit++)
          printf("\t(%.2d):  data=0x%8.8lx  expected=0x%8.8lx\t%s\n",
                i_bit,
-               module_ps->rwLine_s.data_a[i_bit],
-               module_ps->rwLine_s.expected_data_a[i_bit],
-              (module_ps->rwLine_s.err_a[i_bit])?"Error":"");
+               module_ps->diag_ps->rwLine_s.data_a[i_bit],
+               module_ps->diag_ps->rwLine_s.expected_data_a[i_bit],
+              (module_ps->diag_ps->rwLine_s.err_a[i_bit])?"Error":"");
        printf("\n");
     }
     if (status)
@@ -4032,53 +5769,41 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
     /*
      * Perform Read Write Line test #3 simulated walking one bit and p24
      * Next perform the Read Write Line test #4 with simulated walking zero bit and p24.
-     * Here we are setting the DATA register to simulate the bit test.
+     * Here we set the DATA register to simulate the bit test.
      */
-    wt_data_p = &cam_ps->test3_s.wt_statd_s.data;
-    rd_data_p = &cam_ps->test3_s.rd_statd_s.data;
     for (type_e=0; (type_e<RW_LINE_NUM_TYPE) && !status; type_e++)
     {
       test++;
-      memset(module_ps->rwLine_s.data_a,0,sizeof(module_ps->rwLine_s.data_a));
-      memset(module_ps->rwLine_s.err_a,0,sizeof(module_ps->rwLine_s.err_a));
-      memset(module_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->rwLine_s.expected_data_a));
-      module_ps->rwLine_s.type_e = type_e;
-      module_ps->rwLine_s.test   = test;
+      memset(module_ps->diag_ps->rwLine_s.data_a,0,sizeof(module_ps->diag_ps->rwLine_s.data_a));
+      memset(module_ps->diag_ps->rwLine_s.err_a,0,sizeof(module_ps->diag_ps->rwLine_s.err_a));
+      memset(module_ps->diag_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->diag_ps->rwLine_s.expected_data_a));
+      module_ps->diag_ps->rwLine_s.type_e = type_e;
+      module_ps->diag_ps->rwLine_s.test   = test;
 
       for (i_bit=0; i_bit<nbits; i_bit++)
-      {
-        /* 
-	 * Set the pattern to write to the DATA register
-	 * for our bit test
-         */
-	 *wt_data_p = rwLineOk_a[type_e][i_bit];
-         iss = camgo(&cam_ps->test3_s.pkg_p);  
-         if (SUCCESS(iss))
-            module_ps->rwLine_s.data_a[i_bit] = *rd_data_p;
-         iss2 = max(iss,iss2);   
-      } /* End of FOR loop (i_bit) */
+         module_ps->diag_ps->rwLine_s.data_a[i_bit] = cam_ps->test3_s.rd_statd_as[type_e][i_bit].data;
 
       /* Check the data is valid */
       status = CV_RWDataGet(type_e,
                             nbits, 
                             NULL, 
-                            module_ps->rwLine_s.data_a,
-                            module_ps->rwLine_s.err_a,
-                            module_ps->rwLine_s.expected_data_a);
+                            module_ps->diag_ps->rwLine_s.data_a,
+                            module_ps->diag_ps->rwLine_s.err_a,
+                            module_ps->diag_ps->rwLine_s.expected_data_a);
       if (CV_DRV_DEBUG && status)
       {
          printf("CV[%hd %hd %hd]\n",module_ps->b,module_ps->c,module_ps->n);
          printf("RW Line Test #%.2hd: %s\tstat=0x%8.8X  iss=0x%8.8lx\n",
                  test,
                 (status)?"Failed   ":"Successful",
-                 cam_ps->test3_s.rd_statd_s.stat,
-                 iss2);  
+                 cam_ps->test3_s.rd_statd_as[type_e][nbits-1].stat,
+                 iss);  
          for (i_bit=0; i_bit<nbits; i_bit++)
            printf("\t(%.2d):  data=0x%8.8lx  expected=0x%8.8lx\t%s\n",
 		  i_bit,
-                  module_ps->rwLine_s.data_a[i_bit],
-                  module_ps->rwLine_s.expected_data_a[i_bit],
-                 (module_ps->rwLine_s.err_a[i_bit])?"Error":"" );
+                  module_ps->diag_ps->rwLine_s.data_a[i_bit],
+                  module_ps->diag_ps->rwLine_s.expected_data_a[i_bit],
+                 (module_ps->diag_ps->rwLine_s.err_a[i_bit])?"Error":"" );
          printf("\n");
       }
     }
@@ -4092,14 +5817,12 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
     type_e = WALKING_ONE;
     nbits  = RW_LINE_NUM2;
     nelem  = RW_LINE_NUM2+1;
-    memset(module_ps->rwLine_s.data_a,0,sizeof(module_ps->rwLine_s.data_a));
-    memset(module_ps->rwLine_s.err_a,0,sizeof(module_ps->rwLine_s.err_a));
-    memset(module_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->rwLine_s.expected_data_a));
-    module_ps->rwLine_s.type_e = type_e;
-    module_ps->rwLine_s.test   = test;
+    memset(module_ps->diag_ps->rwLine_s.data_a,0,sizeof(module_ps->diag_ps->rwLine_s.data_a));
+    memset(module_ps->diag_ps->rwLine_s.err_a,0,sizeof(module_ps->diag_ps->rwLine_s.err_a));
+    memset(module_ps->diag_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->diag_ps->rwLine_s.expected_data_a));
+    module_ps->diag_ps->rwLine_s.type_e = type_e;
+    module_ps->diag_ps->rwLine_s.test   = test;
 
-    iss = camgo(&cam_ps->test5_s.pkg_p);
- 
     /* Word swap data from block transfer */
     sdata_a = cam_ps->test5_s.rd_statd_s.data_a;
     blockWordSwap(sdata_a,nelem);
@@ -4108,9 +5831,9 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
     status = CV_RWDataGet(type_e,
                           nbits, 
                           sdata_a, 
-                          module_ps->rwLine_s.data_a, 
-                          module_ps->rwLine_s.err_a,
-                          module_ps->rwLine_s.expected_data_a);
+                          module_ps->diag_ps->rwLine_s.data_a, 
+                          module_ps->diag_ps->rwLine_s.err_a,
+                          module_ps->diag_ps->rwLine_s.expected_data_a);
     if (CV_DRV_DEBUG && status)
     {
        printf("RW Line Test #%.2hd: %s\tstat=0x%8.8X  iss=0x%8.8lx\n",
@@ -4121,9 +5844,9 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
        for (i_bit=0; i_bit<nbits; i_bit++)
          printf("\t(%.2d): data=0x%8.8lx  expected=0x%8.8lx\t%s\n",
                  i_bit,
-                module_ps->rwLine_s.data_a[i_bit],
-                module_ps->rwLine_s.expected_data_a[i_bit],
-               (module_ps->rwLine_s.err_a[i_bit])?"Error":"");
+                module_ps->diag_ps->rwLine_s.data_a[i_bit],
+                module_ps->diag_ps->rwLine_s.expected_data_a[i_bit],
+               (module_ps->diag_ps->rwLine_s.err_a[i_bit])?"Error":"");
       printf("\n");
     }
     if (status)  goto egress;
@@ -4136,14 +5859,12 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
     type_e = WALKING_ZERO;
     nbits  = RW_LINE_NUM2;
     nelem  = RW_LINE_NUM2+1;
-    memset(module_ps->rwLine_s.data_a,0,sizeof(module_ps->rwLine_s.data_a));
-    memset(module_ps->rwLine_s.err_a,0,sizeof(module_ps->rwLine_s.err_a));
-    memset(module_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->rwLine_s.expected_data_a));
-    module_ps->rwLine_s.type_e = type_e;
-    module_ps->rwLine_s.test   = test;
+    memset(module_ps->diag_ps->rwLine_s.data_a,0,sizeof(module_ps->diag_ps->rwLine_s.data_a));
+    memset(module_ps->diag_ps->rwLine_s.err_a,0,sizeof(module_ps->diag_ps->rwLine_s.err_a));
+    memset(module_ps->diag_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->diag_ps->rwLine_s.expected_data_a));
+    module_ps->diag_ps->rwLine_s.type_e = type_e;
+    module_ps->diag_ps->rwLine_s.test   = test;
   
-    iss = camgo(&cam_ps->test6_s.pkg_p);
-
     /* Word swap the camac word block transfer data */
     sdata_a = cam_ps->test6_s.rd_statd_s.data_a;
     blockWordSwap(sdata_a,nelem);
@@ -4152,9 +5873,9 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
     status = CV_RWDataGet(type_e,
                           nbits,
                           sdata_a,
-                          module_ps->rwLine_s.data_a,
-                          module_ps->rwLine_s.err_a,
-                          module_ps->rwLine_s.expected_data_a);
+                          module_ps->diag_ps->rwLine_s.data_a,
+                          module_ps->diag_ps->rwLine_s.err_a,
+                          module_ps->diag_ps->rwLine_s.expected_data_a);
     if (CV_DRV_DEBUG && status)
     {
        printf("CV[%hd %hd %hd]\n",module_ps->b,module_ps->c,module_ps->n);
@@ -4166,9 +5887,9 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
        for (i_bit=0; i_bit<nbits; i_bit++)
          printf("\t(%.2d): data=0x%8.8lx  expected=0x%8.8lx\t%s\n",
                  i_bit,
-                module_ps->rwLine_s.data_a[i_bit],
-                module_ps->rwLine_s.expected_data_a[i_bit],
-               (module_ps->rwLine_s.err_a[i_bit])?"Error":"");
+                module_ps->diag_ps->rwLine_s.data_a[i_bit],
+                module_ps->diag_ps->rwLine_s.expected_data_a[i_bit],
+               (module_ps->diag_ps->rwLine_s.err_a[i_bit])?"Error":"");
       printf("\n");
     }
     if (status) goto egress;
@@ -4183,25 +5904,17 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
      * two tests, the data will not need to be word swapped as in test
      * 5 and 6 above, which performed word block transfers.
      */
-    wt_sdata_p = &cam_ps->test7_s.wt_statd_s.data;  /* write data without p24 */
-    rd_data_p  = &cam_ps->test7_s.rd_statd_s.data;  /* read data with p24     */
     for (type_e=0; (type_e<RW_LINE_NUM_TYPE) && !status; type_e++)
     {
       test++;
-      memset(module_ps->rwLine_s.data_a,0,sizeof(module_ps->rwLine_s.data_a));
-      memset(module_ps->rwLine_s.err_a,0,sizeof(module_ps->rwLine_s.err_a));
-      memset(module_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->rwLine_s.expected_data_a));
-      module_ps->rwLine_s.type_e = type_e;
-      module_ps->rwLine_s.test   = test;
+      memset(module_ps->diag_ps->rwLine_s.data_a,0,sizeof(module_ps->diag_ps->rwLine_s.data_a));
+      memset(module_ps->diag_ps->rwLine_s.err_a,0,sizeof(module_ps->diag_ps->rwLine_s.err_a));
+      memset(module_ps->diag_ps->rwLine_s.expected_data_a,0,sizeof(module_ps->diag_ps->rwLine_s.expected_data_a));
+      module_ps->diag_ps->rwLine_s.type_e = type_e;
+      module_ps->diag_ps->rwLine_s.test   = test;
 
       for (i_bit=0; i_bit<nbits; i_bit++)
-      {
-	 wt_sdata_p[0] = (unsigned short)rwLineOk_a[type_e][i_bit];
-         iss = camgo(&cam_ps->test7_s.pkg_p); 
-         if (SUCCESS(iss))
-            module_ps->rwLine_s.data_a[i_bit] = rd_data_p[0];
-         iss2 = max(iss,iss2);
-      }
+         module_ps->diag_ps->rwLine_s.data_a[i_bit] = cam_ps->test7_s.rd_statd_as[type_e][i_bit].data;
      /* 
       * Check for errors. We want to read all of the data before
       * we check for errors so that we can print a summary of the
@@ -4210,23 +5923,23 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
       status = CV_RWDataGet(type_e,
                             nbits,
                             NULL,
-                            module_ps->rwLine_s.data_a,
-                            module_ps->rwLine_s.err_a,
-                            module_ps->rwLine_s.expected_data_a);
+                            module_ps->diag_ps->rwLine_s.data_a,
+                            module_ps->diag_ps->rwLine_s.err_a,
+                            module_ps->diag_ps->rwLine_s.expected_data_a);
       if (CV_DRV_DEBUG && status)
       {
         printf("CV[%hd %hd %hd]\n",module_ps->b,module_ps->c,module_ps->n);
         printf("RW Line Test #%.2hd: %s\tstat=0x%8.8X  iss=0x%8.8lx\n",
 	        test,
 	       (status)?"Failed   ":"Successful",
-	        cam_ps->test7_s.rd_statd_s.stat,
-	        iss2);
+	        cam_ps->test7_s.rd_statd_as[type_e][nbits-1].stat,
+	        iss);
         for (i_bit=0; i_bit<nbits; i_bit++)
            printf("\t(%.2d):  data=0x%8.8lx  expected=0x%8.8lx\t%s\n",
 		  i_bit,
-                  module_ps->rwLine_s.data_a[i_bit],
-                  module_ps->rwLine_s.expected_data_a[i_bit],
-                 (module_ps->rwLine_s.err_a[i_bit])?"Error":"" );
+                  module_ps->diag_ps->rwLine_s.data_a[i_bit],
+                  module_ps->diag_ps->rwLine_s.expected_data_a[i_bit],
+                 (module_ps->diag_ps->rwLine_s.err_a[i_bit])?"Error":"" );
         printf("\n");
 
       }
@@ -4234,11 +5947,11 @@ static vmsstat_t CV_CrateRWLine( CV_MODULE * const module_ps )
 
     /* If test completed successfully set the rwLine test to zero. */
     if (!status) 
-      module_ps->rwLine_s.test = 0;
+      module_ps->diag_ps->rwLine_s.test = 0;
 
 egress:
    /* 0=success, 1-8 is failed test */
-   dataway_ps->rwLineErr = module_ps->rwLine_s.test;
+   dataway_ps->rwLineErr = module_ps->diag_ps->rwLine_s.test;
 
   /*
    *  Clear the registers on the bus before 
@@ -4250,10 +5963,22 @@ egress:
        * Build Camac control word to pulse the C-line.
        * this fuction clears the registers on the bus
        * This is our way of cleaning up before we exit
-       * if an error has occurred.
+       * if an error has occurred. The package is issued 
+       * through the bus arbiter like all others, rather
+       * than with camio(), and is kept for the next failure.
        */
-       ctlw = (module_ps->c << CCTLW__C_shc) | M28 | F26A9;
-       camio(&ctlw, 0 , &nobcnt, &stat, &emask );
+       pulse_ps = &module_ps->cam_s.pulseC_s;
+       if (!pulse_ps->pkg_p && SUCCESS(camalo(&nops,&pulse_ps->pkg_p)))
+       {
+          ctlw = (module_ps->c << CCTLW__C_shc) | M28 | F26A9;
+          if (!SUCCESS(camadd(&ctlw, &pulse_ps->stat, &nobcnt, &emask, &pulse_ps->pkg_p)))
+          {
+             camdel(&pulse_ps->pkg_p);
+             pulse_ps->pkg_p = NULL;
+          }
+       }
+       if (pulse_ps->pkg_p)
+          CV_TraceCamgo(module_ps,CAMAC_TST_DATAWAY,CV_PKG_PULSE_C,&pulse_ps->pkg_p,&pulse_ps->stat);
        iss = CRAT_VERIFY_FAIL;
     }
     else
@@ -4286,7 +6011,10 @@ egress:
 =======================================================*/ 
 static void CV_DatawayInitData( CV_MODULE * const module_ps)
 {
+   RW_LINE_OK;
    unsigned long      bcnt       = 0;
+   unsigned short     type_e     = 0;
+   unsigned short     i_bit      = 0;
    campkg_dataway_ts *cam_ps     = NULL;
    campkg_rwlines_ts *rwlines_ps = NULL;
 
@@ -4295,12 +6023,12 @@ static void CV_DatawayInitData( CV_MODULE * const module_ps)
    module_ps->crate_s.bus_stat_u._i = 0;
 
    /* Clear Command Line test results */
-   bcnt = sizeof(module_ps->cmdLine_s.data_a);
-   memset(module_ps->cmdLine_s.data_a,0,bcnt);
+   bcnt = sizeof(module_ps->diag_ps->cmdLine_s.data_a);
+   memset(module_ps->diag_ps->cmdLine_s.data_a,0,bcnt);
 
    /* Clear Read Write Line test results */
-   bcnt = sizeof(module_ps->rwLine_s.data_a);
-   memset(module_ps->rwLine_s.data_a,0,bcnt);
+   bcnt = sizeof(module_ps->diag_ps->rwLine_s.data_a);
+   memset(module_ps->diag_ps->rwLine_s.data_a,0,bcnt);
   
   /*
    * Clear the Camac package stat-data for 
@@ -4308,9 +6036,11 @@ static void CV_DatawayInitData( CV_MODULE * const module_ps)
    * Command Line, Read Line and Write Line tests
    */
    cam_ps = &module_ps->cam_s.dataway_s;  
-   cam_ps->pulseC_s.stat  = 0;
-   cam_ps->inhibit_s.stat = 0;
-   memset(&cam_ps->scc_s.statd_s,0,sizeof(cam_ps->scc_s.statd_s));
+   cam_ps->pulseC_stat  = 0;
+   cam_ps->inhibit_stat = 0;
+   memset(&cam_ps->scc_statd_s,0,sizeof(cam_ps->scc_statd_s));
+   memset(&cam_ps->id_statd_s,0,sizeof(cam_ps->id_statd_s));
+   memset(cam_ps->volts_as,0,sizeof(cam_ps->volts_as));
 
    /* Clear Command Line test stat-data */
    memset(cam_ps->cmd_s.rd_statd_as,0,sizeof(cam_ps->cmd_s.rd_statd_as));
@@ -4329,8 +6059,7 @@ static void CV_DatawayInitData( CV_MODULE * const module_ps)
    rwlines_ps->test2_s.wt_stat  = 0;
    memset(&rwlines_ps->test2_s.rd_statd_s,0,sizeof(rwlines_ps->test2_s.rd_statd_s));
 
-   memset(&rwlines_ps->test3_s.wt_statd_s,0,sizeof(rwlines_ps->test3_s.wt_statd_s));   
-   memset(&rwlines_ps->test3_s.rd_statd_s,0,sizeof(rwlines_ps->test3_s.rd_statd_s));
+   memset(&rwlines_ps->test3_s,0,sizeof(rwlines_ps->test3_s));   
 
    rwlines_ps->test5_s.stat = 0;
    memset(&rwlines_ps->test5_s.rd_statd_s,0,sizeof(rwlines_ps->test5_s.rd_statd_s));
@@ -4339,8 +6068,24 @@ static void CV_DatawayInitData( CV_MODULE * const module_ps)
    rwlines_ps->test6_s.wt_stat = 0;
    memset(&rwlines_ps->test6_s.rd_statd_s,0,sizeof(rwlines_ps->test6_s.rd_statd_s));
 
-   memset(&rwlines_ps->test7_s.wt_statd_s,0,sizeof(rwlines_ps->test7_s.wt_statd_s));   
-   memset(&rwlines_ps->test7_s.rd_statd_s,0,sizeof(rwlines_ps->test7_s.rd_statd_s));
+   memset(&rwlines_ps->test7_s,0,sizeof(rwlines_ps->test7_s));   
+
+   /*
+    * Set the patterns written to the DATA register for the 
+    * simulated walking one and zero write line tests, #3,4 with p24
+    * and #7,8 without. Test #7,8 clear the DATA register with zero first.
+    */
+   for (type_e=0; type_e<RW_LINE_NUM_TYPE; type_e++)
+   {
+      for (i_bit=0; i_bit<RW_LINE_NUM; i_bit++)
+         rwlines_ps->test3_s.wt_statd_as[type_e][i_bit].data = rwLineOk_a[type_e][i_bit];
+      for (i_bit=0; i_bit<RW_LINE_NUM2; i_bit++)
+         rwlines_ps->test7_s.wt_statd_as[type_e][i_bit].data = (unsigned short)rwLineOk_a[type_e][i_bit];
+   }
+
+   /* Leave test pattern in data register at the end of the test */
+   cam_ps->wt_statd_s.stat = 0;
+   cam_ps->wt_statd_s.data = module_ps->pattern & CV_DATA_MASK;
 
    /* 
     * Clear the verifier X and Q response from the previous test.
@@ -4383,7 +6128,6 @@ void CV_ClrMsgStatus( cv_message_status_ts * const msgstat_ps )
     static const size_t  bcnt = sizeof(epicsTimeStamp);
 
     if (!msgstat_ps) return;
-    /* epicsMutexMustLock( msgstat_ps->mlock ); */
 
     /* Save time of last request */
     memmove( (void *)&msgstat_ps->lastReqTime,(void *)&msgstat_ps->reqTime,bcnt );
@@ -4397,7 +6141,6 @@ void CV_ClrMsgStatus( cv_message_status_ts * const msgstat_ps )
     msgstat_ps->errCode = CRAT_OKOK;               /* Set successful   */
     msgstat_ps->opDone  = 0;                       /* Set operations in progress */
 
-    /* epicsMutexUnlock( msgstat_ps->mlock ); */
     return;
 }
 
@@ -4434,8 +6177,6 @@ static void CV_SetMsgStatus( vmsstat_t status, cv_message_status_ts * const msgs
 {
   if ( !msgstat_ps ) return;
 
-    /* epicsMutexMustLock( msgstat_ps->mlock ); */
-
     msgstat_ps->errCode = status;          /* Save Camac operation status */  
 
     /* Get time operation complete and calculate time to prpcess request. */
@@ -4444,7 +6185,6 @@ static void CV_SetMsgStatus( vmsstat_t status, cv_message_status_ts * const msgs
  
     msgstat_ps->opDone  = 1;               /* Mark operation complete    */
 
-    /* epicsMutexUnlock( msgstat_ps->mlock ); */
     return;
 }
 
@@ -4496,8 +6236,13 @@ static void  CV_SetCrateStatus( CV_MODULE * const module_ps, unsigned short stat
 epicsExportAddress(drvet,drvCV);
 epicsRegisterFunction(isCrateOnline);
 epicsRegisterFunction(CV_Start);
+epicsRegisterFunction(CV_StartLoc);
 epicsRegisterFunction(CV_AsynThreadStop);
 epicsRegisterFunction(CV_DeviceInit);
+epicsRegisterFunction(CV_PollSet);
+epicsRegisterFunction(CV_PollShow);
+epicsRegisterFunction(CV_FastWatchSet);
+epicsRegisterFunction(CV_VoltLimitSet);
 #endif
 
 /* End of file */
@@ -23,9 +23,16 @@
 
 long         IsCrateOnline( short c);;
 CV_MODULE  * CV_FindModuleByBCN(short b, short c, short n );
+unsigned long CV_CrateBlockGet( epicsUInt32 * const val_a, unsigned long nelm );
+IOSCANPVT    CV_CrateBlockEvent( void );
 void         CV_ClrMsgStatus( cv_message_status_ts * const msgstat_ps );
+CV_REQUEST * CV_RequestAlloc( void );
+long         CV_PollPeriodSet( CV_REQUEST * const msg_ps, long period );
+long         CV_SendRequest( CV_REQUEST * const req_ps );
+void         CV_VoltLimitUpdate( CV_MODULE * const module_ps, unsigned short ch, 
+                                 double lolo, double low, double high, double hihi );
 long         CV_DeviceInit( cv_camac_func_te   func_e,
-                            char const * const source_c,
+                            cv_msg_source_te   source_e,
                             dbCommon   * const rec_ps,
                             CV_MODULE  * const module_ps, 
                             CV_REQUEST * const dpvt_ps );